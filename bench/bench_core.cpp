@@ -0,0 +1,210 @@
+// bench/bench_core.cpp
+//
+// C++ 核心的 Google Benchmark 基准。数据由 bench/gen_corpus.py 生成，
+// 目录通过环境变量 PMCAD_BENCH_CORPUS 指定（默认 ./bench_corpus）：
+//
+//   python bench/gen_corpus.py bench_corpus
+//   PMCAD_BENCH_CORPUS=bench_corpus ./pmcad_bench --benchmark_filter=Parse
+//
+// 缺少某个文件时对应基准报错跳过，其余照常运行。
+#include <benchmark/benchmark.h>
+
+#include "gene_match.h"
+#include "reader.h"
+#include "uniprot_reader.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <string>
+#include <sys/stat.h>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+std::string corpus_path(const std::string& name) {
+    const char* dir = std::getenv("PMCAD_BENCH_CORPUS");
+    return std::string(dir && *dir ? dir : "bench_corpus") + "/" + name;
+}
+
+bool exists(const std::string& path) {
+    struct stat st;
+    return ::stat(path.c_str(), &st) == 0;
+}
+
+std::size_t file_size(const std::string& path) {
+    struct stat st;
+    return ::stat(path.c_str(), &st) == 0 ? static_cast<std::size_t>(st.st_size) : 0;
+}
+
+/// 只计数的 sink：代替 COPY，测量纯解压 + 解析吞吐
+class CountingSink : public pmcad::RecordSink {
+public:
+    void write(const pmcad::FtRecord& r) override { rows++; bytes += r.note.size(); }
+    void write(const pmcad::DrRecord& r) override { rows++; bytes += r.db_id.size(); }
+    void write(const pmcad::SqRecord& r) override { rows++; bytes += r.sequence.size(); }
+    void end_entry() override { entries++; }
+
+    std::size_t rows = 0, bytes = 0, entries = 0;
+};
+
+// ---------------- UniProt 解析（COPY 替换为计数 sink） ----------------
+
+void parse_uniprot(benchmark::State& state, const char* file) {
+    std::string path = corpus_path(file);
+    if (!exists(path)) {
+        state.SkipWithError(("missing " + path).c_str());
+        return;
+    }
+    unsigned threads = static_cast<unsigned>(state.range(0));
+    std::size_t inflated = 0, rows = 0;
+    for (auto _ : state) {
+        CountingSink sink;
+        pmcad::parse_uniprot_gz(
+            path, &sink, &sink, &sink, threads,
+            [&](const pmcad::ReadProgress& p) { inflated = p.parsed_bytes; });
+        rows = sink.rows;
+        benchmark::DoNotOptimize(sink.bytes);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * inflated));
+    state.counters["rows"] = static_cast<double>(rows);
+}
+
+void BM_ParseUniprotPlain(benchmark::State& state) { parse_uniprot(state, "uniprot.dat.gz"); }
+void BM_ParseUniprotBgzf(benchmark::State& state) { parse_uniprot(state, "uniprot.bgzf.dat.gz"); }
+
+BENCHMARK(BM_ParseUniprotPlain)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ParseUniprotBgzf)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// ---------------- TSV 读取 ----------------
+
+std::vector<std::string> ner_files() {
+    std::vector<std::string> files;
+    for (int i = 0;; ++i) {
+        std::string path = corpus_path("ner_" + std::to_string(i) + ".tsv");
+        if (!exists(path)) break;
+        files.push_back(path);
+    }
+    return files;
+}
+
+void BM_ReadTsvFile(benchmark::State& state) {
+    std::string path = corpus_path("ner_0.tsv");
+    if (!exists(path)) {
+        state.SkipWithError(("missing " + path).c_str());
+        return;
+    }
+    for (auto _ : state) {
+        auto rows = pmcad::Reader::read_tsv_file(path);
+        benchmark::DoNotOptimize(rows.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * file_size(path)));
+}
+BENCHMARK(BM_ReadTsvFile)->Unit(benchmark::kMillisecond);
+
+void BM_ReadMultiTsv(benchmark::State& state) {
+    std::vector<std::string> files = ner_files();
+    if (files.empty()) {
+        state.SkipWithError("missing ner_*.tsv");
+        return;
+    }
+    std::size_t bytes = 0;
+    for (const auto& f : files) bytes += file_size(f);
+    unsigned threads = static_cast<unsigned>(state.range(0));
+    for (auto _ : state) {
+        auto rows = pmcad::Reader::read_multi_tsv(files, threads);
+        benchmark::DoNotOptimize(rows.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes));
+}
+BENCHMARK(BM_ReadMultiTsv)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// ---------------- 基因名匹配 ----------------
+
+using Reference = std::unordered_map<std::string, std::vector<std::string> >;
+
+/// gene_ref_<n>.tsv（每行 名称\tID\tID...），按大小缓存，多个基准共用
+const Reference* load_reference(std::size_t n) {
+    static std::map<std::size_t, Reference> cache;
+    auto it = cache.find(n);
+    if (it != cache.end()) return &it->second;
+
+    std::string path = corpus_path("gene_ref_" + std::to_string(n) + ".tsv");
+    if (!exists(path)) return nullptr;
+    Reference& ref = cache[n];
+    for (auto& row : pmcad::Reader::read_tsv_file(path)) {
+        if (row.empty()) continue;
+        auto& vals = ref[row[0]];
+        vals.insert(vals.end(), row.begin() + 1, row.end());
+    }
+    return &ref;
+}
+
+const std::vector<std::string>& load_queries() {
+    static std::vector<std::string> queries = [] {
+        std::vector<std::string> q;
+        std::ifstream in(corpus_path("gene_query.txt"));
+        for (std::string line; std::getline(in, line);) q.push_back(line);
+        return q;
+    }();
+    return queries;
+}
+
+/// 一次性接口：每次都重建索引（与 Python 的 match_reference 相同）
+void BM_MatchReference(benchmark::State& state) {
+    const Reference* ref = load_reference(static_cast<std::size_t>(state.range(0)));
+    const auto& queries = load_queries();
+    if (!ref || queries.empty()) {
+        state.SkipWithError("missing gene_ref_<n>.tsv / gene_query.txt");
+        return;
+    }
+    for (auto _ : state) {
+        auto result = pmcad::GeneMatch::match_reference(queries, *ref, false);
+        benchmark::DoNotOptimize(result.size());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * queries.size()));
+}
+
+/// 只建索引
+void BM_GeneIndexBuild(benchmark::State& state) {
+    const Reference* ref = load_reference(static_cast<std::size_t>(state.range(0)));
+    if (!ref) {
+        state.SkipWithError("missing gene_ref_<n>.tsv");
+        return;
+    }
+    for (auto _ : state) {
+        pmcad::GeneMatchIndex index(*ref);
+        benchmark::DoNotOptimize(index.size());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * ref->size()));
+}
+
+/// 索引已建好，只匹配（第二个参数为线程数）
+void BM_GeneIndexMatch(benchmark::State& state) {
+    const Reference* ref = load_reference(static_cast<std::size_t>(state.range(0)));
+    const auto& queries = load_queries();
+    if (!ref || queries.empty()) {
+        state.SkipWithError("missing gene_ref_<n>.tsv / gene_query.txt");
+        return;
+    }
+    pmcad::GeneMatchIndex index(*ref);
+    unsigned threads = static_cast<unsigned>(state.range(1));
+    for (auto _ : state) {
+        auto result = index.match(queries, false, threads);
+        benchmark::DoNotOptimize(result.size());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * queries.size()));
+}
+
+BENCHMARK(BM_MatchReference)->RangeMultiplier(10)->Range(10000, 10000000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_GeneIndexBuild)->RangeMultiplier(10)->Range(10000, 10000000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_GeneIndexMatch)
+    ->ArgsProduct({benchmark::CreateRange(10000, 10000000, 10), {1, 4}})
+    ->UseRealTime()->Unit(benchmark::kMillisecond);
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,80 @@
+"""
+Python 接口的基准测试（pytest-benchmark），数据与 C++ 基准共用 bench/gen_corpus.py 的输出：
+
+    python bench/gen_corpus.py bench_corpus
+    PMCAD_BENCH_CORPUS=bench_corpus pytest bench/bench_python.py --benchmark-only
+
+测量的是包含 pybind11 类型转换在内的端到端耗时；纯 C++ 吞吐见 bench_core.cpp。
+"""
+
+import json
+import os
+
+import pytest
+
+pytest.importorskip("pytest_benchmark")
+core = pytest.importorskip("pmcad.core")
+_core = pytest.importorskip("pmcad._core")
+
+CORPUS = os.environ.get("PMCAD_BENCH_CORPUS", "bench_corpus")
+
+
+def _manifest():
+    path = os.path.join(CORPUS, "manifest.json")
+    if not os.path.exists(path):
+        pytest.skip(f"no corpus at {CORPUS} (run bench/gen_corpus.py first)")
+    with open(path) as f:
+        return json.load(f)
+
+
+def _path(name):
+    return os.path.join(CORPUS, name)
+
+
+def _load_reference(name):
+    reference = {}
+    for row in _core.read_tsv_file(_path(name)):
+        if row:
+            reference.setdefault(row[0], []).extend(row[1:])
+    return reference
+
+
+def _queries():
+    with open(_path(_manifest()["files"]["gene_query"])) as f:
+        return f.read().splitlines()
+
+
+def _dict_sizes():
+    path = os.path.join(CORPUS, "manifest.json")
+    if not os.path.exists(path):
+        return [10000]
+    with open(path) as f:
+        return sorted(int(n) for n in json.load(f)["files"]["gene_ref"])
+
+
+def test_read_tsv_file(benchmark):
+    name = _manifest()["files"]["ner"][0]
+    rows = benchmark(_core.read_tsv_file, _path(name))
+    assert len(rows) > 1
+
+
+@pytest.mark.parametrize("num_threads", [1, 4])
+def test_read_tsv_files(benchmark, num_threads):
+    files = [_path(n) for n in _manifest()["files"]["ner"]]
+    df = benchmark(core.read_tsv_files, files, num_threads)
+    assert len(df) > 0
+
+
+@pytest.mark.parametrize("size", _dict_sizes())
+def test_match_reference(benchmark, size):
+    reference = _load_reference(_manifest()["files"]["gene_ref"][str(size)])
+    queries = _queries()
+    benchmark.pedantic(core.match_reference, args=(queries, reference), rounds=1, iterations=1)
+
+
+@pytest.mark.parametrize("size", _dict_sizes())
+def test_gene_index_match(benchmark, size):
+    reference = _load_reference(_manifest()["files"]["gene_ref"][str(size)])
+    index = core.GeneMatchIndex(reference)
+    queries = _queries()
+    benchmark(index.match, queries)
@@ -0,0 +1,197 @@
+"""
+基准测试用的合成数据生成器（固定随机种子，结果可复现）。
+
+生成内容：
+    uniprot.dat.gz        普通 gzip 的 UniProt 文本（ID / AC / DE / OS / DR / FT / SQ / //）
+    uniprot.bgzf.dat.gz   同样内容的 BGZF 版本（可并行解压）
+    ner_<i>.tsv           PubTator 风格的 NER 结果（pmid, start, end, mention, type, concept_id）
+    gene_ref_<n>.tsv      基因名字典：每行 "名称\\tID\\tID..."，n 为 key 数
+    gene_query.txt        查询：字典中名称的大小写 / 后缀 / 多词变体，以及不命中的随机名称
+    manifest.json         上述文件与生成参数
+
+用法:
+    python bench/gen_corpus.py bench_corpus
+    python bench/gen_corpus.py bench_corpus --dict-sizes 10000,100000,1000000,10000000
+"""
+
+import argparse
+import gzip
+import json
+import os
+import random
+import struct
+import zlib
+
+AMINO = "ACDEFGHIKLMNPQRSTVWY"
+SYLLABLES = ["ab", "ak", "br", "ca", "cd", "er", "fo", "gl", "hi", "ka", "li", "ma",
+             "my", "nf", "nk", "pa", "ra", "sm", "st", "tn", "tp", "wn", "xr", "zf"]
+GREEK = ["alpha", "beta", "gamma"]
+WORDS = ["protein", "kinase", "receptor", "factor", "homolog", "binding", "domain",
+         "subunit", "like", "associated", "transcription", "channel"]
+FEATURE_TYPES = ["CHAIN", "DOMAIN", "REGION", "BINDING", "MOD_RES", "DISULFID",
+                 "HELIX", "STRAND", "TURN", "SIGNAL"]
+DR_DATABASES = [
+    ("GO", lambda r: f"GO:{r.randrange(10**7):07d}; {r.choice('FPC')}:{r.choice(WORDS)} {r.choice(WORDS)}; IEA:InterPro"),
+    ("InterPro", lambda r: f"IPR{r.randrange(10**6):06d}; {r.choice(WORDS).capitalize()}_{r.choice(WORDS)}"),
+    ("Pfam", lambda r: f"PF{r.randrange(10**5):05d}; {r.choice(WORDS).capitalize()}; {r.randint(1, 3)}"),
+    ("PROSITE", lambda r: f"PS{r.randrange(10**5):05d}; {r.choice(WORDS).upper()}; {r.randint(1, 2)}"),
+    ("EMBL", lambda r: f"X{r.randrange(10**5):05d}; CAA{r.randrange(10**5):05d}.1; -; mRNA"),
+]
+NER_TYPES = ["Gene", "Chemical", "Disease", "Species", "CellLine"]
+
+
+def accession(r):
+    return r.choice("OPQ") + str(r.randrange(10)) + "".join(
+        r.choice("ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789") for _ in range(3)) + str(r.randrange(10))
+
+
+def uniprot_entry(r, idx):
+    accs = [accession(r) for _ in range(r.randint(1, 3))]
+    length = r.randint(50, 1200)
+    seq = "".join(r.choice(AMINO) for _ in range(length))
+
+    lines = [f"ID   SYN{idx}_HUMAN               Reviewed;        {length} AA.",
+             "AC   " + " ".join(a + ";" for a in accs),
+             "DT   01-JAN-2000, integrated into UniProtKB/Swiss-Prot.",
+             f"DE   RecName: Full={r.choice(WORDS).capitalize()} {r.choice(WORDS)} {idx};",
+             "OS   Homo sapiens (Human).",
+             "OX   NCBI_TaxID=9606;"]
+    for _ in range(r.randint(2, 12)):
+        db, fields = r.choice(DR_DATABASES)
+        lines.append(f"DR   {db}; {fields(r)}.")
+    for _ in range(r.randint(0, 8)):
+        start = r.randint(1, length)
+        end = r.randint(start, length)
+        lines.append(f"FT   {r.choice(FEATURE_TYPES):<16}{start}..{end}")
+        if r.random() < 0.7:
+            lines.append(f'FT                   /note="{r.choice(WORDS)} {r.choice(WORDS)}"')
+        if r.random() < 0.5:
+            lines.append(f'FT                   /evidence="ECO:{r.randrange(10**7):07d}"')
+    lines.append(f"SQ   SEQUENCE   {length} AA;  {length * 110} MW;  "
+                 f"{r.getrandbits(64):016X} CRC64;")
+    for i in range(0, length, 60):
+        row = seq[i:i + 60]
+        lines.append("     " + " ".join(row[j:j + 10] for j in range(0, len(row), 10)))
+    lines.append("//")
+    return "\n".join(lines) + "\n"
+
+
+def write_bgzf(path, data):
+    """按 BGZF 格式写出：每块不超过 64KB，gzip 头带 "BC" 扩展字段记录块大小，末尾为空块。"""
+    with open(path, "wb") as f:
+        blocks = [data[i:i + 65280] for i in range(0, len(data), 65280)] + [b""]
+        for block in blocks:
+            comp = zlib.compressobj(6, zlib.DEFLATED, -15)
+            payload = comp.compress(block) + comp.flush()
+            bsize = 12 + 6 + len(payload) + 8  # 头 + 扩展字段 + 数据 + CRC32/ISIZE
+            f.write(b"\x1f\x8b\x08\x04" + b"\x00" * 4 + b"\x00\xff" + struct.pack("<H", 6))
+            f.write(b"BC" + struct.pack("<HH", 2, bsize - 1))
+            f.write(payload)
+            f.write(struct.pack("<II", zlib.crc32(block) & 0xFFFFFFFF, len(block)))
+
+
+def gene_name(r):
+    name = "".join(r.choice(SYLLABLES) for _ in range(r.randint(1, 3))) + str(r.randint(1, 999))
+    if r.random() < 0.3:
+        name += r.choice("abcdefgh")
+    if r.random() < 0.2:
+        name = f"{r.choice(WORDS)} {name}"
+    return name
+
+
+def gene_query(r, names):
+    """字典中名称的变体（与 GeneMatch 的规范化规则对应），约 20% 不命中"""
+    if r.random() < 0.2:
+        return gene_name(r) + "x"
+    q = r.choice(names)
+    roll = r.random()
+    if roll < 0.2:
+        q = q.upper()
+    elif roll < 0.4:
+        q = q + r.choice(["-1", "-2", " " + r.choice(GREEK), "-a"])
+    elif roll < 0.6:
+        q = f"{r.choice(WORDS)} {q} {r.choice(WORDS)}"
+    elif roll < 0.7:
+        q = q.replace(" ", "-")
+    return q
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("out_dir")
+    parser.add_argument("--seed", type=int, default=42)
+    parser.add_argument("--entries", type=int, default=20000, help="UniProt 条目数")
+    parser.add_argument("--ner-files", type=int, default=8)
+    parser.add_argument("--ner-rows", type=int, default=200000, help="每个 NER 文件的行数")
+    parser.add_argument("--dict-sizes", default="10000,100000,1000000",
+                        help="基因名字典的 key 数（逗号分隔，最大可到 10000000）")
+    parser.add_argument("--queries", type=int, default=100000)
+    args = parser.parse_args()
+
+    os.makedirs(args.out_dir, exist_ok=True)
+    manifest = {"seed": args.seed, "files": {}}
+
+    def out(name):
+        return os.path.join(args.out_dir, name)
+
+    # ---------- UniProt ----------
+    r = random.Random(args.seed)
+    data = "".join(uniprot_entry(r, i) for i in range(args.entries)).encode()
+    with gzip.GzipFile(out("uniprot.dat.gz"), "wb", mtime=0) as f:
+        f.write(data)
+    write_bgzf(out("uniprot.bgzf.dat.gz"), data)
+    manifest["files"]["uniprot"] = {"plain": "uniprot.dat.gz", "bgzf": "uniprot.bgzf.dat.gz",
+                                    "entries": args.entries, "bytes": len(data)}
+    print(f"uniprot: {args.entries} entries, {len(data) / 2**20:.1f} MB")
+
+    # ---------- NER TSV ----------
+    ner = []
+    for i in range(args.ner_files):
+        r = random.Random(args.seed * 1000 + i)
+        name = f"ner_{i}.tsv"
+        with open(out(name), "w") as f:
+            f.write("pmid\tstart\tend\tmention\ttype\tconcept_id\n")
+            for _ in range(args.ner_rows):
+                start = r.randrange(5000)
+                mention = gene_name(r) if r.random() < 0.5 else r.choice(WORDS)
+                f.write(f"{r.randrange(10**8)}\t{start}\t{start + len(mention)}\t{mention}\t"
+                        f"{r.choice(NER_TYPES)}\t{r.randrange(10**6)}\n")
+        ner.append(name)
+    manifest["files"]["ner"] = ner
+    print(f"ner: {args.ner_files} files x {args.ner_rows} rows")
+
+    # ---------- 基因名字典与查询 ----------
+    sizes = sorted(int(float(s)) for s in args.dict_sizes.split(",") if s)
+    r = random.Random(args.seed + 1)
+    names = []
+    seen = set()
+    refs = {}
+    for n in sizes:
+        while len(names) < n:
+            name = gene_name(r)
+            if name not in seen:
+                seen.add(name)
+                names.append(name)
+        # 较小的字典是较大字典的前缀，查询对所有字典都有命中
+        refs[str(n)] = f"gene_ref_{n}.tsv"
+        with open(out(refs[str(n)]), "w") as f:
+            for i, name in enumerate(names[:n]):
+                ids = "\t".join(f"GENE{(i * 7 + k) % n}" for k in range(1 + i % 3))
+                f.write(f"{name}\t{ids}\n")
+        print(f"gene_ref: {n} keys")
+
+    r = random.Random(args.seed + 2)
+    smallest = names[:sizes[0]] if sizes else [gene_name(r)]
+    with open(out("gene_query.txt"), "w") as f:
+        for _ in range(args.queries):
+            f.write(gene_query(r, smallest) + "\n")
+    manifest["files"]["gene_ref"] = refs
+    manifest["files"]["gene_query"] = "gene_query.txt"
+
+    with open(out("manifest.json"), "w") as f:
+        json.dump(manifest, f, indent=2)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,42 @@
+#!/bin/bash
+# PGO 构建 pmcad._core：插桩构建 → 用基准套件训练 → 按 profile 重新构建
+#
+#   bash bench/pgo.sh                    # 在仓库根目录运行
+#   BUILD=build-pgo CORPUS=bench_corpus LTO=ON bash bench/pgo.sh
+#
+# 训练负载为 bench/pmcad_bench（C++ 基准）以及 bench/bench_python.py（需要 pytest-benchmark，
+# 没有时跳过）。两者链接的是同一个插桩后的 pmcad_native，profile 对应同一批目标文件。
+# 结束时与 build.sh 一样把 _core 复制到 src/pmcad/。
+set -euo pipefail
+
+BUILD=${BUILD:-build-pgo}
+CORPUS=${CORPUS:-bench_corpus}
+LTO=${LTO:-ON}
+JOBS=${JOBS:-$(nproc)}
+PGO_DIR="$PWD/$BUILD/pgo"
+
+configure() {
+    cmake -S . -B "$BUILD" -DCMAKE_BUILD_TYPE=Release -DPMCAD_BUILD_BENCH=ON \
+        -DPMCAD_LTO="$LTO" -DPMCAD_PGO="$1" -DPMCAD_PGO_DIR="$PGO_DIR"
+    cmake --build "$BUILD" -j "$JOBS"
+    cp "$BUILD"/_core*.so src/pmcad/
+}
+
+# 1. 插桩构建（旧 profile 会与新的累加，先清掉）
+rm -rf "$PGO_DIR"
+configure generate
+
+# 2. 训练
+[ -d "$CORPUS" ] || python bench/gen_corpus.py "$CORPUS"
+PMCAD_BENCH_CORPUS="$CORPUS" "$BUILD/bench/pmcad_bench" --benchmark_min_time=0.1
+if python -c "import pytest_benchmark" 2>/dev/null; then
+    PYTHONPATH=src PMCAD_BENCH_CORPUS="$CORPUS" \
+        python -m pytest bench/bench_python.py --benchmark-only --benchmark-disable-gc -q
+fi
+if compgen -G "$PGO_DIR/*.profraw" > /dev/null; then
+    cmake --build "$BUILD" --target pgo-merge  # Clang
+fi
+
+# 3. 按 profile 重新构建
+configure use
+echo "✅ PGO build done: $(ls "$BUILD"/_core*.so)"
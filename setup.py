@@ -3,15 +3,27 @@ from setuptools.command.build_ext import build_ext
 import pybind11
 import os
 
-# 定义C++扩展
+# 定义C++扩展（就地开发构建，见 build.sh）；带 LTO / PGO 选项的构建见 CMakeLists.txt
 ext_modules = [
     Extension(
         "pmcad._core",
         [
             "src/cpp/bindings.cpp",
             "src/cpp/reader.cpp",
+            "src/cpp/mapped_file.cpp",
             "src/cpp/gene_match.cpp",
+            "src/cpp/gene_index_format.cpp",
             "src/cpp/uniprot_importer.cpp",
+            "src/cpp/uniprot_parser.cpp",
+            "src/cpp/uniprot_reader.cpp",
+            "src/cpp/uniprot_scanner.cpp",
+            "src/cpp/uniprot_stream.cpp",
+            "src/cpp/pg_binary_copy.cpp",
+            "src/cpp/parquet_writer.cpp",
+            "src/cpp/sequence_codec.cpp",
+            "src/cpp/uniprot_lookup.cpp",
+            "src/cpp/ontology_graph.cpp",
+            "src/cpp/text_scan.cpp",
         ],
         include_dirs=[
             "src/cpp",
@@ -23,7 +35,8 @@ ext_modules = [
             os.path.expanduser("~/pgsql/lib")
         ],  # libpqxx/libpq library path
         language="c++",
-        extra_compile_args=["-std=c++17", "-O3", "-fPIC"],
+        extra_compile_args=["-std=c++17", "-O3", "-fPIC", "-pthread"],
+        extra_link_args=["-pthread"],
     ),
 ]
 
@@ -1,12 +1,158 @@
 #include <pybind11/pybind11.h>
+#include <pybind11/functional.h>
+#include <pybind11/numpy.h>
 #include <pybind11/stl.h>
 
 #include "gene_match.h"
+#include "ontology_graph.h"
 #include "reader.h"
+#include "sequence_codec.h"
+#include "text_scan.h"
 #include "uniprot_importer.h"
+#include "uniprot_lookup.h"
+#include "uniprot_stream.h"
 
 namespace py = pybind11;
 
+namespace {
+
+// Move a vector to the heap and hand it to numpy without copying;
+// the capsule frees it when the array is garbage collected.
+template <class T>
+py::array_t<T> to_numpy(std::vector<T>&& v) {
+    auto* heap = new std::vector<T>(std::move(v));
+    py::capsule owner(heap, [](void* p) { delete static_cast<std::vector<T>*>(p); });
+    return py::array_t<T>(static_cast<py::ssize_t>(heap->size()), heap->data(), owner);
+}
+
+// Same as to_numpy, viewed as a C-contiguous (rows, cols) array.
+template <class T, class U = T>
+py::array_t<U> to_numpy_2d(std::vector<T>&& v, size_t rows, size_t cols) {
+    static_assert(sizeof(T) == sizeof(U), "element size must match");
+    auto* heap = new std::vector<T>(std::move(v));
+    py::capsule owner(heap, [](void* p) { delete static_cast<std::vector<T>*>(p); });
+    return py::array_t<U>({static_cast<py::ssize_t>(rows), static_cast<py::ssize_t>(cols)},
+                          reinterpret_cast<const U*>(heap->data()), owner);
+}
+
+template <class T>
+py::dict matrix_to_dict(pmcad::TsvMatrix<T>&& m) {
+    py::dict out;
+    out["header"] = m.header;
+    out["values"] = to_numpy_2d(std::move(m.values), m.rows, m.cols);
+    // valid holds only 0 / 1, so it can be exposed directly as numpy bool
+    out["valid"] = to_numpy_2d<uint8_t, bool>(std::move(m.valid), m.rows, m.cols);
+    return out;
+}
+
+// Number of code points in a UTF-8 byte range (Python str indices).
+size_t utf8_length(const char* b, const char* e) {
+    size_t n = 0;
+    for (; b < e; ++b) n += (static_cast<unsigned char>(*b) & 0xC0) != 0x80;
+    return n;
+}
+
+// One UniprotStream table as numpy arrays; string columns keep the
+// Arrow offsets / data layout of read_tsv_columns.
+py::dict batch_table_to_dict(pmcad::BatchTable&& t) {
+    py::dict strings;
+    for (size_t i = 0; i < t.strings.size(); ++i) {
+        py::dict col;
+        col["offsets"] = to_numpy(std::move(t.strings[i].offsets));
+        col["data"] = to_numpy(std::move(t.strings[i].data));
+        strings[py::str(t.string_names[i])] = std::move(col);
+    }
+    py::dict ints;
+    for (size_t i = 0; i < t.ints.size(); ++i)
+        ints[py::str(t.int_names[i])] = to_numpy(std::move(t.ints[i]));
+
+    py::dict out;
+    out["num_rows"] = t.num_rows();
+    out["entry"] = to_numpy(std::move(t.entry));
+    out["strings"] = std::move(strings);
+    out["ints"] = std::move(ints);
+    return out;
+}
+
+constexpr const char* TSV_MATRIX_DOC = R"doc(
+Memory-map a TSV file and parse every cell with std::from_chars into a
+dense row-major matrix, without building a string table.
+
+A cell is valid only if, after trimming surrounding whitespace, the whole
+cell is a number. Empty lines are skipped; the matrix is as wide as the
+widest row and short rows are padded with invalid cells. Invalid cells
+hold NaN (double) or 0 (int).
+
+Returns
+-------
+dict
+    header : list[str]
+        First non-empty line when has_header is true, otherwise empty.
+    values : numpy.ndarray, shape (rows, cols)
+        Parsed values (zero-copy).
+    valid : numpy.ndarray of bool, shape (rows, cols)
+        False where a cell is missing or unparseable (zero-copy).
+)doc";
+
+// ft / dr / sq / multi_stream_parse_and_copy 共用的参数说明，拼接进各自的 docstring
+constexpr const char* IMPORT_OPTIONS_DOC = R"doc(num_threads : int, optional
+    Decompression / parsing threads (default 1). With more than one thread,
+    BGZF files are inflated in parallel; plain gzip is inflated on one
+    thread while entries are parsed in parallel. Rows are written in the
+    same order in each table as the single-threaded import.
+binary_copy : bool, optional
+    Use binary COPY (FORMAT binary) instead of text COPY (default False).
+    Integer columns are sent as int4, so the server skips text parsing.
+num_connections : int, optional
+    Connections / COPY streams per table (default 1). With more than one,
+    each connection is fed by its own writer thread and commits its own
+    batches of batch_commit rows.
+hash_partition : bool, optional
+    Route rows to connections by accession hash instead of round-robin
+    per entry (default False).
+bulk_load : bool, optional
+    Bulk load mode (default False). The table is created UNLOGGED and
+    without the id SERIAL PRIMARY KEY. After the load it is switched to
+    LOGGED and its accession index (plus db_id for DR) is built, with one
+    connection per index running in parallel.
+resume : bool, optional
+    Resume an interrupted import (default False). Every batch commit also
+    records, in the same transaction, a checkpoint in the
+    uniprot_import_checkpoint table: the number of committed entries, the
+    row count and the last accession. On resume, entries that are already
+    committed are skipped. num_connections and hash_partition must match
+    the interrupted run.
+on_metrics : callable, optional
+    Called with an ImportMetrics snapshot every metrics_interval seconds
+    (from a background thread) and at every phase change; the last call
+    has phase "done". Exceptions raised by the callback are re-raised when
+    the import ends.
+metrics_interval : float, optional
+    Seconds between metrics reports (default 1.0). The verbose progress
+    line is refreshed at the same interval.
+)doc";
+
+constexpr const char* DEDUP_SEQUENCES_DOC = R"doc(dedup_sequences : bool, optional
+    Store each distinct sequence once (default False). The SQ table then
+    holds accession, length, mol_weight, crc64 and seq_hash only, and a
+    second table named <sq_table>_seq holds crc64, length, seq_hash and the
+    sequence packed at 5 bits per residue as BYTEA (decode with
+    unpack_sequence). seq_hash is a 64-bit digest of the residues, so a
+    sequence is identified by (crc64, length, seq_hash): sequences that
+    share a CRC64 are stored as separate rows, and the two tables join on
+    those three columns. Keys already present in the _seq table are loaded
+    first, so re-imports and resumed imports never store a sequence twice.
+    Text COPY sends BYTEA as hex, so binary_copy is recommended.
+)doc";
+
+constexpr const char* NORMALIZED_MODE_DOC = R"doc(accession_table : str, optional
+    Normalized mode (default "", off); see multi_stream_parse_and_copy.
+entry_id_base : int, optional
+    entry_id of the first entry in normalized mode (default 1).
+)doc";
+
+} // namespace
+
 PYBIND11_MODULE(_core, m) {
     m.doc() = "pmcad core C++ extension module";
 
@@ -15,12 +161,62 @@ PYBIND11_MODULE(_core, m) {
           "Read a single TSV file", py::arg("filename"));
 
     m.def("read_multi_tsv", &pmcad::Reader::read_multi_tsv,
-          "Read multiple TSV files", py::arg("filelist"));
+          "Read multiple TSV files on a thread pool and merge them in file "
+          "order, keeping only the first file's header. num_threads = 0 "
+          "uses all hardware threads. The GIL is released while reading.",
+          py::arg("filelist"), py::arg("num_threads") = 0,
+          py::call_guard<py::gil_scoped_release>());
 
     m.def("read_tsv_safe", &pmcad::Reader::read_tsv_safe,
           "Read TSV file with error handling",
           py::arg("filename"), py::arg("skip_errors") = true);
 
+    m.def(
+        "read_tsv_columns",
+        [](const std::string& filename) {
+            pmcad::TsvTable table;
+            {
+                py::gil_scoped_release release;
+                table = pmcad::Reader::read_tsv_columns(filename);
+            }
+
+            py::list columns;
+            for (auto& c : table.columns) {
+                py::dict col;
+                col["offsets"] = to_numpy(std::move(c.offsets));
+                col["data"] = to_numpy(std::move(c.data));
+                col["validity"] = to_numpy(std::move(c.validity));
+                col["null_count"] = c.null_count;
+                columns.append(std::move(col));
+            }
+
+            py::dict out;
+            out["names"] = table.names;
+            out["num_rows"] = table.num_rows;
+            out["columns"] = std::move(columns);
+            return out;
+        },
+        py::arg("filename"),
+        R"doc(
+Memory-map a TSV file and return it column by column, Arrow style.
+
+The first non-empty line is the header. Lines are split the same way as
+read_tsv_file.
+
+Returns
+-------
+dict
+    names : list[str]
+        Column names.
+    num_rows : int
+        Number of data rows.
+    columns : list[dict]
+        One dict per column, each holding zero-copy numpy arrays:
+        offsets (int64, num_rows + 1), data (uint8, UTF-8 bytes for all
+        values), validity (uint8 bitmap, LSB first; 0 where a row has too
+        few fields), plus null_count.
+)doc");
+
     m.def("read_tsv_as_double", &pmcad::Reader::read_tsv_as_double,
           "Read TSV file and convert to double",
           py::arg("filename"));
@@ -29,6 +225,30 @@ PYBIND11_MODULE(_core, m) {
           "Read TSV file and convert to int",
           py::arg("filename"));
 
+    m.def(
+        "read_tsv_matrix_double",
+        [](const std::string& filename, bool has_header) {
+            pmcad::TsvMatrix<double> mat;
+            {
+                py::gil_scoped_release release;
+                mat = pmcad::Reader::read_tsv_matrix_double(filename, has_header);
+            }
+            return matrix_to_dict(std::move(mat));
+        },
+        py::arg("filename"), py::arg("has_header") = false, TSV_MATRIX_DOC);
+
+    m.def(
+        "read_tsv_matrix_int",
+        [](const std::string& filename, bool has_header) {
+            pmcad::TsvMatrix<int> mat;
+            {
+                py::gil_scoped_release release;
+                mat = pmcad::Reader::read_tsv_matrix_int(filename, has_header);
+            }
+            return matrix_to_dict(std::move(mat));
+        },
+        py::arg("filename"), py::arg("has_header") = false, TSV_MATRIX_DOC);
+
     m.def("find_files", &pmcad::Reader::find_files,
           "Find files with given pattern in a directory",
           py::arg("foldername"), py::arg("pattern"));
@@ -38,13 +258,118 @@ PYBIND11_MODULE(_core, m) {
           py::arg("dbname"), py::arg("user"),
           py::arg("password"), py::arg("host") = "localhost",
           py::arg("port") = "5432", py::arg("verbose") = false,
-          "Insert TSV files into PostgreSQL database");
+          py::arg("num_threads") = 1, py::arg("num_connections") = 1,
+          "Insert TSV files into PostgreSQL database. With num_threads > 1 "
+          "files are read in parallel; with num_connections > 1 rows are "
+          "written through several COPY connections and committed once every "
+          "file has been written. The commit is atomic (two-phase commit) when "
+          "the server's max_prepared_transactions is at least num_connections; "
+          "otherwise the connections commit one after another, and a failure "
+          "part-way leaves the earlier connections' rows committed. If the table "
+          "was created by this call, it is dropped again whenever the parallel "
+          "import fails before its outcome is decided.");
 
     // ================= GeneMatch =================
     m.def("match_reference", &pmcad::GeneMatch::match_reference,
           "Match the gene query to reference data",
           py::arg("query"), py::arg("reference"),
-          py::arg("verbose"));
+          py::arg("verbose"),
+          py::call_guard<py::gil_scoped_release>());
+
+    py::class_<pmcad::GeneMatchIndex>(m, "GeneMatchIndex",
+                                      "Gene name index built once from a reference "
+                                      "dictionary and reused across query batches")
+        .def(py::init<const std::unordered_map<std::string, std::vector<std::string> >&,
+                      bool>(),
+             "Normalize the reference dictionary and build all lookup tables",
+             py::arg("reference"), py::arg("verbose") = false)
+        .def("match", &pmcad::GeneMatchIndex::match,
+             "Match a batch of queries with the same rules as match_reference. "
+             "Queries are split into chunks handed out to num_threads threads "
+             "(0 = all hardware threads). The GIL is released while matching, "
+             "so several Python threads can share one index.",
+             py::arg("query"), py::arg("verbose") = false,
+             py::arg("num_threads") = 0,
+             py::call_guard<py::gil_scoped_release>())
+        .def(
+            "scan",
+            [](const pmcad::GeneMatchIndex& self, const std::vector<std::string>& texts,
+               bool longest_only, unsigned num_threads) {
+                std::vector<std::vector<pmcad::GeneMention> > found;
+                {
+                    py::gil_scoped_release release;
+                    found = self.scan(texts, longest_only, num_threads);
+                }
+                // byte offsets -> str indices; mentions are sorted by start
+                py::list out;
+                for (size_t i = 0; i < texts.size(); ++i) {
+                    const char* text = texts[i].data();
+                    size_t byte = 0, cp = 0;
+                    py::list mentions;
+                    for (const auto& m : found[i]) {
+                        cp += utf8_length(text + byte, text + m.begin);
+                        byte = m.begin;
+                        size_t end = cp + utf8_length(text + m.begin, text + m.end);
+                        py::list ids;
+                        for (uint32_t id : m.values) ids.append(id);
+                        mentions.append(py::make_tuple(cp, end, ids));
+                    }
+                    out.append(mentions);
+                }
+                return out;
+            },
+            "Find reference gene names in whole texts (e.g. abstracts) with one "
+            "Aho-Corasick pass per text. Punctuation is treated as whitespace and "
+            "the text is normalized like the queries of match; only hits on word "
+            "boundaries are kept. Returns, for every text, a list of "
+            "(start, end, value_ids) with str indices into the original text. "
+            "With longest_only the leftmost-longest non-overlapping hits are "
+            "kept, otherwise all hits. Use value(id) to get the value strings.",
+            py::arg("texts"), py::arg("longest_only") = true,
+            py::arg("num_threads") = 0)
+        .def(
+            "value",
+            [](const pmcad::GeneMatchIndex& self, uint32_t id) {
+                if (id >= self.num_values()) throw py::index_error("value id out of range");
+                return std::string(self.value(id));
+            },
+            "Value string of a value id returned by scan", py::arg("id"))
+        .def_static("load", &pmcad::GeneMatchIndex::load,
+                    "Memory-map an index file written by save(); no parsing, "
+                    "so processes loading the same file share its pages",
+                    py::arg("path"))
+        .def("save", &pmcad::GeneMatchIndex::save,
+             "Write the index image to a file for later load()",
+             py::arg("path"))
+        .def("__len__", &pmcad::GeneMatchIndex::size);
+
+    // ================= Import metrics =================
+    py::class_<pmcad::TableMetrics>(m, "TableMetrics",
+                                    "Write statistics of one target table")
+        .def_readonly("table", &pmcad::TableMetrics::table)
+        .def_readonly("rows", &pmcad::TableMetrics::rows,
+                      "Rows sent to COPY in this run")
+        .def_readonly("flushes", &pmcad::TableMetrics::flushes,
+                      "Number of sends to the server (one per row for text COPY)")
+        .def_readonly("flush_seconds", &pmcad::TableMetrics::flush_seconds)
+        .def_readonly("max_flush_seconds", &pmcad::TableMetrics::max_flush_seconds)
+        .def_readonly("commits", &pmcad::TableMetrics::commits)
+        .def_readonly("commit_seconds", &pmcad::TableMetrics::commit_seconds,
+                      "Time spent ending COPY, writing checkpoints and committing");
+
+    py::class_<pmcad::ImportMetrics>(m, "ImportMetrics",
+                                     "Snapshot passed to the on_metrics callback of the importers")
+        .def_readonly("phase", &pmcad::ImportMetrics::phase,
+                      "\"import\", \"finish\", \"merge\" (state_table), \"index\" (bulk_load) or \"done\"")
+        .def_readonly("elapsed_seconds", &pmcad::ImportMetrics::elapsed_seconds)
+        .def_readonly("compressed_bytes", &pmcad::ImportMetrics::compressed_bytes)
+        .def_readonly("total_bytes", &pmcad::ImportMetrics::total_bytes)
+        .def_readonly("inflated_bytes", &pmcad::ImportMetrics::inflated_bytes)
+        .def_readonly("parsed_bytes", &pmcad::ImportMetrics::parsed_bytes)
+        .def_readonly("entries", &pmcad::ImportMetrics::entries)
+        .def_readonly("parse_errors", &pmcad::ImportMetrics::parse_errors,
+                      "Malformed AC / FT / DR / SQ lines that were skipped")
+        .def_readonly("tables", &pmcad::ImportMetrics::tables);
 
     // ================= UniprotImporter =================
     py::class_<pmcad::UniprotImporter>(m, "UniprotImporter")
@@ -61,7 +386,18 @@ PYBIND11_MODULE(_core, m) {
             py::arg("port") = "5432",
             py::arg("batch_commit") = 200000,
             py::arg("verbose") = true,
-            R"doc(
+            py::arg("num_threads") = 1,
+            py::arg("binary_copy") = false,
+            py::arg("num_connections") = 1,
+            py::arg("hash_partition") = false,
+            py::arg("bulk_load") = false,
+            py::arg("resume") = false,
+            py::arg("on_metrics") = nullptr,
+            py::arg("metrics_interval") = 1.0,
+            py::arg("accession_table") = "",
+            py::arg("entry_id_base") = 1,
+            py::call_guard<py::gil_scoped_release>(),
+            (std::string(R"doc(
 Stream-parse UniProt .dat.gz Feature Table (FT) records and import directly into PostgreSQL.
 
 Each FT record is written as soon as it is parsed, using COPY FROM STDIN for high throughput.
@@ -86,7 +422,7 @@ batch_commit : int, optional
     Commit every N records (default 200,000).
 verbose : bool, optional
     Whether to print real-time progress (default True).
-
+)doc") + IMPORT_OPTIONS_DOC + NORMALIZED_MODE_DOC + R"doc(
 Table schema created automatically:
     id SERIAL PRIMARY KEY,
     accession TEXT,
@@ -95,7 +431,7 @@ Table schema created automatically:
     end_pos INT,
     note TEXT,
     evidence TEXT
-)doc")
+)doc").c_str())
         // -------- DR parser binding --------
         .def_static(
             "dr_stream_parse_and_copy",
@@ -109,7 +445,18 @@ Table schema created automatically:
             py::arg("port") = "5432",
             py::arg("batch_commit") = 200000,
             py::arg("verbose") = true,
-            R"doc(
+            py::arg("num_threads") = 1,
+            py::arg("binary_copy") = false,
+            py::arg("num_connections") = 1,
+            py::arg("hash_partition") = false,
+            py::arg("bulk_load") = false,
+            py::arg("resume") = false,
+            py::arg("on_metrics") = nullptr,
+            py::arg("metrics_interval") = 1.0,
+            py::arg("accession_table") = "",
+            py::arg("entry_id_base") = 1,
+            py::call_guard<py::gil_scoped_release>(),
+            (std::string(R"doc(
 Stream-parse UniProt .dat.gz Database Reference (DR) records and import directly into PostgreSQL.
 
 Each DR record is parsed as:
@@ -138,7 +485,7 @@ batch_commit : int, optional
     Commit every N records (default 200,000).
 verbose : bool, optional
     Whether to print real-time progress (default True).
-
+)doc") + IMPORT_OPTIONS_DOC + NORMALIZED_MODE_DOC + R"doc(
 Table schema created automatically:
     id SERIAL PRIMARY KEY,
     accession TEXT,
@@ -146,7 +493,7 @@ Table schema created automatically:
     db_id TEXT,
     description TEXT,
     evidence TEXT
-)doc")
+)doc").c_str())
 
         // -------- SQ parser binding --------
         .def_static(
@@ -161,7 +508,19 @@ Table schema created automatically:
             py::arg("port") = "5432",
             py::arg("batch_commit") = 20000,
             py::arg("verbose") = true,
-            R"doc(
+            py::arg("num_threads") = 1,
+            py::arg("binary_copy") = false,
+            py::arg("num_connections") = 1,
+            py::arg("hash_partition") = false,
+            py::arg("bulk_load") = false,
+            py::arg("resume") = false,
+            py::arg("on_metrics") = nullptr,
+            py::arg("metrics_interval") = 1.0,
+            py::arg("dedup_sequences") = false,
+            py::arg("accession_table") = "",
+            py::arg("entry_id_base") = 1,
+            py::call_guard<py::gil_scoped_release>(),
+            (std::string(R"doc(
 Stream-parse UniProt .dat.gz Sequence (SQ) records and import directly into PostgreSQL.
 
 Each entry is parsed as:
@@ -192,7 +551,7 @@ batch_commit : int, optional
     Commit every N records (default 20,000).
 verbose : bool, optional
     Whether to print real-time progress (default True).
-
+)doc") + IMPORT_OPTIONS_DOC + DEDUP_SEQUENCES_DOC + NORMALIZED_MODE_DOC + R"doc(
 Table schema created automatically:
     id SERIAL PRIMARY KEY,
     accession TEXT,
@@ -200,8 +559,349 @@ Table schema created automatically:
     mol_weight INT,
     crc64 TEXT,
     sequence TEXT
+(without the sequence column, plus the <sq_table>_seq table, when
+dedup_sequences is set)
 
 Example output:
     ✅ Completed SQ import into table: uniprot_sprot_sq (550000 sequences)
+)doc").c_str())
+
+        // -------- Single-pass FT + DR + SQ binding --------
+        .def_static(
+            "multi_stream_parse_and_copy",
+            &pmcad::UniprotImporter::multi_stream_parse_and_copy,
+            py::arg("gz_path"),
+            py::arg("ft_table"),
+            py::arg("dr_table"),
+            py::arg("sq_table"),
+            py::arg("dbname"),
+            py::arg("user"),
+            py::arg("password"),
+            py::arg("host") = "localhost",
+            py::arg("port") = "5432",
+            py::arg("batch_commit") = 200000,
+            py::arg("verbose") = true,
+            py::arg("num_threads") = 1,
+            py::arg("binary_copy") = false,
+            py::arg("num_connections") = 1,
+            py::arg("hash_partition") = false,
+            py::arg("bulk_load") = false,
+            py::arg("resume") = false,
+            py::arg("on_metrics") = nullptr,
+            py::arg("metrics_interval") = 1.0,
+            py::arg("dedup_sequences") = false,
+            py::arg("accession_table") = "",
+            py::arg("entry_id_base") = 1,
+            py::arg("state_table") = "",
+            py::call_guard<py::gil_scoped_release>(),
+            (std::string(R"doc(
+Decompress a UniProt .dat.gz once and import FT, DR and SQ records together.
+
+Each section is written to its own table over its own connection and COPY
+stream, using exactly the same parsing rules as the single-section importers.
+Pass an empty string as a table name to skip that section.
+
+Parameters
+----------
+gz_path : str
+    Path to the .dat.gz UniProt file.
+ft_table : str
+    Target table for Feature Table records ("" to skip).
+dr_table : str
+    Target table for Database Reference records ("" to skip).
+sq_table : str
+    Target table for Sequence records ("" to skip).
+dbname : str
+    Database name.
+user : str
+    PostgreSQL username.
+password : str
+    Password for the database.
+host : str, optional
+    Host address, default "localhost".
+port : str, optional
+    Port number, default "5432".
+batch_commit : int, optional
+    Commit every N records per table (default 200,000).
+verbose : bool, optional
+    Whether to print real-time progress (default True).
+)doc") + IMPORT_OPTIONS_DOC + DEDUP_SEQUENCES_DOC + R"doc(accession_table : str, optional
+    Normalized mode (default "", off). Every entry gets an integer
+    entry_id, and accession_table (entry_id BIGINT, accession TEXT,
+    position INT) gets one row per accession of the entry, position 0 being
+    the primary accession. FT / DR / SQ rows then carry entry_id BIGINT
+    instead of accession, and DR writes one row per DR line instead of one
+    per accession. With bulk_load the tables are indexed on entry_id, and
+    accession_table on accession and entry_id.
+entry_id_base : int, optional
+    entry_id of the first entry in the file (default 1). entry_id is
+    entry_id_base plus the entry's position in the file, so it does not
+    change on resume. Use distinct ranges when several files share tables.
+state_table : str, optional
+    Incremental update mode (default "", off; requires accession_table).
+    state_table (accession TEXT PRIMARY KEY, entry_id BIGINT, entry_hash
+    BIGINT) keeps the primary accession and a 64-bit hash of the full entry
+    text for every entry. On a new release the states are loaded into
+    memory (about 100 bytes per entry) and only new or changed entries are
+    copied into <table>_delta staging tables. At the end one transaction
+    deletes the rows of changed and vanished entries, inserts the staged
+    rows, upserts state_table and drops the staging tables. Unchanged
+    entries keep their rows and entry_id; new entries get ids above the
+    largest stored one. The first run with an empty state_table is a full
+    load. Cannot be combined with bulk_load or resume.
+    With dedup_sequences, new <sq_table>_seq rows are committed while parsing,
+    outside the merge transaction, so a failed run may leave unreferenced
+    sequences behind. Sequences whose last referencing entry is changed or
+    deleted are never removed from <sq_table>_seq either.
+)doc").c_str())
+        .def_static(
+            "multi_stream_parse_to_parquet",
+            &pmcad::UniprotImporter::multi_stream_parse_to_parquet,
+            py::arg("gz_path"),
+            py::arg("ft_path"),
+            py::arg("dr_path"),
+            py::arg("sq_path"),
+            py::arg("verbose") = true,
+            py::arg("num_threads") = 1,
+            py::arg("compression") = "none",
+            py::arg("row_group_rows") = 1 << 20,
+            py::arg("on_metrics") = nullptr,
+            py::arg("metrics_interval") = 1.0,
+            py::call_guard<py::gil_scoped_release>(),
+            R"doc(
+Decompress a UniProt .dat.gz once and write FT, DR and SQ records to Parquet.
+
+Uses the same parsing pipeline as multi_stream_parse_and_copy, but no
+PostgreSQL connection is needed. Columns match the database tables (without
+id): INT columns are INT32, all others UTF8 strings. Repetitive string
+columns (accession, db_name, feature_type, evidence, ...) are dictionary
+encoded; a column falls back to PLAIN in any row group where its dictionary
+would be more than half the raw data. Pass an empty string as a path to
+skip that section.
+
+Parameters
+----------
+gz_path : str
+    Path to the .dat.gz UniProt file.
+ft_path : str
+    Output file for Feature Table records ("" to skip).
+dr_path : str
+    Output file for Database Reference records ("" to skip).
+sq_path : str
+    Output file for Sequence records ("" to skip).
+verbose : bool, optional
+    Whether to print real-time progress (default True).
+num_threads : int, optional
+    Decompression / parsing threads (default 1), as for
+    multi_stream_parse_and_copy.
+compression : str, optional
+    Page compression: "none" (default) or "gzip".
+row_group_rows : int, optional
+    Maximum rows per row group (default 1,048,576). A row group is also
+    written early once 128 MB of column data is buffered.
+on_metrics : callable, optional
+    Called with an ImportMetrics snapshot every metrics_interval seconds
+    and at every phase change. Each row group counts as one flush and
+    writing the file footer as one commit.
+metrics_interval : float, optional
+    Seconds between metrics reports (default 1.0).
 )doc");
-}
\ No newline at end of file
+
+    // ================= UniprotStream =================
+    py::class_<pmcad::UniprotStream>(m, "UniprotStream", R"doc(
+Iterate over a UniProt .dat.gz in batches of parsed entries, without a database.
+
+A background thread decompresses and parses the file (with num_threads as in
+the importers) and queues up to max_batches batches of batch_entries entries;
+parsing pauses while the consumer is behind. The GIL is released while
+waiting for the next batch.
+
+Each batch is a dict with first_entry, num_entries and one table per
+requested section: "entries" and "accessions" (when entries=True), "ft",
+"dr", "sq". A table is a dict with num_rows, entry (int64 entry number of
+each row, counted from the start of the file), strings (name -> dict of
+zero-copy offsets / data arrays, Arrow layout) and ints (name -> int32 array).
+
+taxon_ids keeps only entries whose OX NCBI_TaxID is in the list; other
+entries are dropped before they are copied into a batch.
+)doc")
+        .def(py::init<const std::string&, bool, bool, bool, bool, unsigned,
+                      size_t, const std::vector<int>&, size_t>(),
+             py::arg("gz_path"),
+             py::arg("entries") = true,
+             py::arg("ft") = true,
+             py::arg("dr") = true,
+             py::arg("sq") = true,
+             py::arg("num_threads") = 1,
+             py::arg("batch_entries") = 10000,
+             py::arg("taxon_ids") = std::vector<int>(),
+             py::arg("max_batches") = 4)
+        .def("__iter__", [](pmcad::UniprotStream& self) -> pmcad::UniprotStream& { return self; })
+        .def("__next__", [](pmcad::UniprotStream& self) {
+            pmcad::UniprotBatch batch;
+            bool ok;
+            {
+                py::gil_scoped_release release;
+                ok = self.next(batch);
+            }
+            if (!ok) throw py::stop_iteration();
+
+            py::dict out;
+            out["first_entry"] = batch.first_entry;
+            out["num_entries"] = batch.num_entries;
+            if (self.want_entries()) {
+                out["entries"] = batch_table_to_dict(std::move(batch.entries));
+                out["accessions"] = batch_table_to_dict(std::move(batch.accessions));
+            }
+            if (self.want_ft()) out["ft"] = batch_table_to_dict(std::move(batch.ft));
+            if (self.want_dr()) out["dr"] = batch_table_to_dict(std::move(batch.dr));
+            if (self.want_sq()) out["sq"] = batch_table_to_dict(std::move(batch.sq));
+            return out;
+        })
+        .def("close", &pmcad::UniprotStream::close,
+             "Stop parsing early and drop queued batches",
+             py::call_guard<py::gil_scoped_release>())
+        .def("__enter__", [](pmcad::UniprotStream& self) -> pmcad::UniprotStream& { return self; })
+        .def("__exit__", [](pmcad::UniprotStream& self, py::args) {
+            py::gil_scoped_release release;
+            self.close();
+        })
+        .def_property_readonly("progress", [](const pmcad::UniprotStream& self) {
+            pmcad::ReadProgress p = self.progress();
+            py::dict out;
+            out["compressed_bytes"] = p.compressed_bytes;
+            out["total_bytes"] = p.total_bytes;
+            out["inflated_bytes"] = p.inflated_bytes;
+            out["parsed_bytes"] = p.parsed_bytes;
+            out["entries"] = p.entries;
+            out["parse_errors"] = p.parse_errors;
+            return out;
+        }, "Latest read progress (bytes, entries and parse errors so far)");
+
+    // ================= Lookup =================
+    py::class_<pmcad::UniprotLookup>(m, "UniprotLookup", R"doc(
+Batched, cached lookups by accession (or another text key column) against an
+imported table, shared by many threads.
+
+The lookup holds pool_size connections, each with its own worker thread.
+Keys that miss the cache are queued. A worker that picks up a key waits
+batch_window seconds, or until max_batch keys are queued, and then sends the
+whole batch as one prepared query:
+SELECT key_column, columns... FROM table WHERE key_column = ANY($1).
+When a key is already being fetched, other callers wait for that result
+instead of querying again. Results are kept in an LRU cache of cache_size
+keys, including keys with no rows (cache_size = 0 disables the cache).
+The GIL is released while waiting, so Python threads (e.g. parallel judge
+workers) can share one instance.
+)doc")
+        .def(py::init<const std::string&, const std::string&, const std::string&,
+                      const std::string&, const std::string&, const std::string&,
+                      const std::string&, const std::vector<std::string>&, unsigned,
+                      size_t, double, size_t>(),
+             py::arg("dbname"),
+             py::arg("user"),
+             py::arg("password"),
+             py::arg("host") = "localhost",
+             py::arg("port") = "5432",
+             py::arg("table") = "uniprot_dr",
+             py::arg("key_column") = "accession",
+             py::arg("columns") = std::vector<std::string>{"db_name", "db_id", "description"},
+             py::arg("pool_size") = 4,
+             py::arg("max_batch") = 1000,
+             py::arg("batch_window") = 0.002,
+             py::arg("cache_size") = 100000,
+             py::call_guard<py::gil_scoped_release>())
+        .def("lookup", &pmcad::UniprotLookup::lookup,
+             "Look up a list of keys. Returns, for every key, the list of its rows; "
+             "each row is a list of the requested column values (NULL as \"\"). "
+             "Blocks until all keys are answered; database errors are re-raised.",
+             py::arg("keys"),
+             py::call_guard<py::gil_scoped_release>())
+        .def("stats", [](const pmcad::UniprotLookup& self) {
+            pmcad::LookupStats st = self.stats();
+            py::dict out;
+            out["requests"] = st.requests;
+            out["cache_hits"] = st.cache_hits;
+            out["coalesced"] = st.coalesced;
+            out["queries"] = st.queries;
+            out["queried_keys"] = st.queried_keys;
+            return out;
+        }, "Counters: requested keys, cache hits, keys coalesced with an in-flight "
+           "query, database queries and keys sent in those queries")
+        .def("clear_cache", &pmcad::UniprotLookup::clear_cache,
+             "Drop all cached results (e.g. after the table was re-imported)");
+
+    // ================= Ontology graph =================
+    py::class_<pmcad::OntologyGraph>(m, "OntologyGraph", R"doc(
+Read-only ontology DAG (GO / DOID / CL ...) with the ancestor closure
+precomputed at build time.
+
+Parents and the closure are stored as CSR arrays. Every term keeps a sorted
+list of all its ancestors, so is_ancestor is a binary search and
+ancestors / descendants are plain slices. lca returns the lowest common
+ancestors of each pair (a DAG can have several), deepest first.
+alt_id aliases resolve to their main term. Unknown terms give False or an
+empty list. Batch methods release the GIL; a cycle raises RuntimeError.
+)doc")
+        .def_static("from_edges", &pmcad::OntologyGraph::from_edges,
+                    "Build from an edge list: parents[i] is a parent of children[i] "
+                    "(e.g. the obj of an is_a edge whose sub is children[i])",
+                    py::arg("children"),
+                    py::arg("parents"),
+                    py::call_guard<py::gil_scoped_release>())
+        .def_static("load_obo", &pmcad::OntologyGraph::load_obo,
+                    "Load the [Term] stanzas of an OBO file. relations selects the edges: "
+                    "\"is_a\" for is_a lines, any other name for "
+                    "\"relationship: <name> <term>\" lines (e.g. \"part_of\")",
+                    py::arg("path"),
+                    py::arg("relations") = std::vector<std::string>{"is_a"},
+                    py::call_guard<py::gil_scoped_release>())
+        .def("__len__", &pmcad::OntologyGraph::size)
+        .def("__contains__", &pmcad::OntologyGraph::contains, py::arg("term"))
+        .def_property_readonly("num_edges", &pmcad::OntologyGraph::num_edges)
+        .def("name", [](const pmcad::OntologyGraph& self, const std::string& term) {
+            return std::string(self.name(term));
+        }, "OBO name of a term (\"\" when absent)", py::arg("term"))
+        .def("depth", &pmcad::OntologyGraph::depth,
+             "Longest path from a root (roots are 0, unknown terms -1)",
+             py::arg("term"))
+        .def("is_ancestor", &pmcad::OntologyGraph::is_ancestor,
+             "For each pair, whether ancestors[i] is a proper ancestor of terms[i]",
+             py::arg("ancestors"),
+             py::arg("terms"),
+             py::call_guard<py::gil_scoped_release>())
+        .def("ancestors", &pmcad::OntologyGraph::ancestors,
+             "All ancestors of each term",
+             py::arg("terms"),
+             py::arg("include_self") = false,
+             py::call_guard<py::gil_scoped_release>())
+        .def("descendants", &pmcad::OntologyGraph::descendants,
+             "All descendants of each term",
+             py::arg("terms"),
+             py::arg("include_self") = false,
+             py::call_guard<py::gil_scoped_release>())
+        .def("lca", &pmcad::OntologyGraph::lca,
+             "Lowest common ancestors of each pair (a[i], b[i]), deepest first",
+             py::arg("a"),
+             py::arg("b"),
+             py::call_guard<py::gil_scoped_release>());
+
+    // ================= Sequence codec =================
+    m.def("pack_sequence",
+          [](const std::string& sequence) { return py::bytes(pmcad::pack_sequence(sequence)); },
+          "Pack an amino-acid sequence (letters A-Z) at 5 bits per residue, "
+          "the format of the sequence column in the dedup SQ table",
+          py::arg("sequence"));
+    m.def("unpack_sequence",
+          [](const py::bytes& packed) {
+              return pmcad::unpack_sequence(std::string(packed));
+          },
+          "Decode a sequence packed by pack_sequence (e.g. a BYTEA value read "
+          "from the <sq_table>_seq table)",
+          py::arg("packed"));
+
+    // ================= Build info =================
+    m.def("simd_level", &pmcad::simd_level,
+          "SIMD code path selected at runtime for the gene-name normalizer and text "
+          "scanner: \"avx512\", \"avx2\" or \"scalar\" (PMCAD_SIMD can lower it)");
+}
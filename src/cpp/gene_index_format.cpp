@@ -0,0 +1,436 @@
+// src/cpp/gene_index_format.cpp
+#include "gene_index_format.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace pmcad {
+
+static const char GENE_INDEX_MAGIC[8] = {'P', 'M', 'C', 'G', 'M', 'I', 'D', 'X'};
+static constexpr std::uint32_t GENE_INDEX_VERSION = 4;
+static constexpr std::uint32_t GENE_INDEX_BYTE_ORDER = 0x01020304u;
+
+[[noreturn]] static void corrupt(const char* what) {
+    throw std::runtime_error(std::string("Invalid gene match index: ") + what);
+}
+
+/// 剩余字节数不足 n 时报错
+static void need(const char* p, const char* end, std::size_t n) {
+    if (static_cast<std::size_t>(end - p) < n) corrupt("truncated");
+}
+
+static const char* read_u64(const char* p, const char* end, std::uint64_t& v) {
+    need(p, end, sizeof(v));
+    std::memcpy(&v, p, sizeof(v));
+    return p + sizeof(v);
+}
+
+/// offsets[0, n] 从 0 开始、单调不减且以 total 结束，即每一段都落在 [0, total) 内
+static bool valid_offsets(const std::uint64_t* offsets, std::uint64_t n, std::uint64_t total) {
+    if (offsets[0] != 0 || offsets[n] != total) return false;
+    for (std::uint64_t i = 0; i < n; ++i)
+        if (offsets[i] > offsets[i + 1]) return false;
+    return true;
+}
+
+/// ids[0, n) 均小于 limit
+static bool ids_below(const std::uint32_t* ids, std::uint64_t n, std::uint64_t limit) {
+    for (std::uint64_t i = 0; i < n; ++i)
+        if (ids[i] >= limit) return false;
+    return true;
+}
+
+/// 跳过对齐填充（镜像起始地址本身是 8 字节对齐的）
+static const char* align8(const char* p, const char* end) {
+    std::size_t rem = reinterpret_cast<std::uintptr_t>(p) % 8;
+    if (rem == 0) return p;
+    need(p, end, 8 - rem);
+    return p + (8 - rem);
+}
+
+// ---------------- StringTable ----------------
+
+const char* StringTable::attach(const char* p, const char* end) {
+    std::uint64_t count, bytes;
+    p = read_u64(p, end, count);
+    p = read_u64(p, end, bytes);
+
+    if (count >= static_cast<std::size_t>(end - p) / 8) corrupt("string table too large");
+    off_ = reinterpret_cast<const std::uint64_t*>(p);
+    p += (count + 1) * 8;
+
+    need(p, end, bytes);
+    if (!valid_offsets(off_, count, bytes)) corrupt("bad string offsets");
+    data_ = p;
+    count_ = static_cast<std::size_t>(count);
+    return align8(p + bytes, end);
+}
+
+std::size_t StringTable::find(std::string_view key) const {
+    std::size_t lo = 0, hi = count_;
+    while (lo < hi) {
+        std::size_t mid = lo + (hi - lo) / 2;
+        if (at(mid) < key)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return (lo < count_ && at(lo) == key) ? lo : npos;
+}
+
+// ---------------- TokenSeqTable ----------------
+
+/// 把序列哈希打散后再取低位作为槽位（splitmix64 的终结函数）
+static std::uint64_t slot_hash(std::uint64_t h) {
+    h ^= h >> 30;
+    h *= 0xBF58476D1CE4E5B9ull;
+    h ^= h >> 27;
+    h *= 0x94D049BB133111EBull;
+    return h ^ (h >> 31);
+}
+
+/// 在 [p, end) 上取 n 个 T（T 为 u32 / u64），返回之后的位置
+template <class T>
+static const char* take_array(const char* p, const char* end, std::uint64_t n,
+                              const T*& out) {
+    if (n > static_cast<std::size_t>(end - p) / sizeof(T)) corrupt("table too large");
+    out = reinterpret_cast<const T*>(p);
+    return p + n * sizeof(T);
+}
+
+const char* TokenSeqTable::attach(const char* p, const char* end, std::uint64_t id_limit) {
+    std::uint64_t count, num_tokens, num_ids, num_slots;
+    p = read_u64(p, end, count);
+    p = read_u64(p, end, num_tokens);
+    p = read_u64(p, end, num_ids);
+    p = read_u64(p, end, num_slots);
+    if (num_slots == 0 || (num_slots & (num_slots - 1)) != 0 || num_slots <= count)
+        corrupt("bad hash table size");
+    if (count >= UINT32_MAX) corrupt("table too large");
+
+    p = take_array(p, end, count, hashes_);
+    p = take_array(p, end, count + 1, tok_off_);
+    p = take_array(p, end, count + 1, post_off_);
+    p = take_array(p, end, num_tokens, tokens_);
+    p = take_array(p, end, num_ids, ids_);
+    p = take_array(p, end, num_slots, slots_);
+    if (!valid_offsets(tok_off_, count, num_tokens) || !valid_offsets(post_off_, count, num_ids))
+        corrupt("bad token table offsets");
+    if (!ids_below(ids_, num_ids, id_limit)) corrupt("bad value id");
+    // slot 存 key 下标 + 1，0 为空
+    for (std::uint64_t s = 0; s < num_slots; ++s)
+        if (slots_[s] > count) corrupt("bad hash table slot");
+
+    count_ = static_cast<std::size_t>(count);
+    num_slots_ = static_cast<std::size_t>(num_slots);
+    return align8(p, end);
+}
+
+bool TokenSeqTable::find(const std::uint32_t* tokens, std::size_t len,
+                         std::uint64_t hash, Postings& ids) const {
+    std::size_t mask = num_slots_ - 1;
+    std::size_t s = slot_hash(hash) & mask;
+    for (std::size_t probes = 0; probes < num_slots_; ++probes, s = (s + 1) & mask) {
+        std::uint32_t k = slots_[s];
+        if (k == 0) return false;
+        --k;
+        if (hashes_[k] != hash || tok_off_[k + 1] - tok_off_[k] != len) continue;
+        if (!std::equal(tokens, tokens + len, tokens_ + tok_off_[k])) continue;
+        ids = Postings(ids_ + post_off_[k], ids_ + post_off_[k + 1]);
+        return true;
+    }
+    return false;
+}
+
+// ---------------- TokenSeqTableBuilder ----------------
+
+std::vector<std::uint32_t>& TokenSeqTableBuilder::at(const std::uint32_t* tokens,
+                                                     std::size_t len,
+                                                     std::uint64_t hash) {
+    // 负载因子不超过 1/2
+    if ((hashes_.size() + 1) * 2 > slots_.size()) grow();
+
+    std::size_t mask = slots_.size() - 1;
+    for (std::size_t s = slot_hash(hash) & mask;; s = (s + 1) & mask) {
+        std::uint32_t k = slots_[s];
+        if (k == 0) {
+            if (hashes_.size() >= UINT32_MAX - 1)
+                throw std::runtime_error("Gene match index too large");
+            slots_[s] = static_cast<std::uint32_t>(hashes_.size() + 1);
+            hashes_.push_back(hash);
+            tokens_.insert(tokens_.end(), tokens, tokens + len);
+            tok_off_.push_back(tokens_.size());
+            postings_.emplace_back();
+            return postings_.back();
+        }
+        --k;
+        if (hashes_[k] == hash && tok_off_[k + 1] - tok_off_[k] == len &&
+            std::equal(tokens, tokens + len, tokens_.begin() + tok_off_[k]))
+            return postings_[k];
+    }
+}
+
+void TokenSeqTableBuilder::grow() {
+    std::vector<std::uint32_t> slots(std::max<std::size_t>(16, slots_.size() * 2), 0);
+    std::size_t mask = slots.size() - 1;
+    for (std::size_t k = 0; k < hashes_.size(); ++k) {
+        std::size_t s = slot_hash(hashes_[k]) & mask;
+        while (slots[s] != 0) s = (s + 1) & mask;
+        slots[s] = static_cast<std::uint32_t>(k + 1);
+    }
+    slots_.swap(slots);
+}
+
+// ---------------- PrefixTrie ----------------
+
+/// 在 nodes[node] 的子节点中二分查找字符 c，不存在时返回 0
+static std::uint32_t trie_child(const TrieNode* nodes, const char* labels,
+                                std::uint32_t node, char c) {
+    std::uint32_t lo = nodes[node].child_begin, hi = nodes[node].child_end;
+    while (lo < hi) {
+        std::uint32_t mid = lo + (hi - lo) / 2;
+        if (static_cast<unsigned char>(labels[mid]) < static_cast<unsigned char>(c))
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return (lo < nodes[node].child_end && labels[lo] == c) ? lo : 0;
+}
+
+static constexpr std::uint64_t TRIE_HAS_AUTOMATON = 1;
+
+const char* PrefixTrie::attach(const char* p, const char* end, std::uint64_t id_limit) {
+    std::uint64_t num_nodes, num_ids, flags;
+    p = read_u64(p, end, num_nodes);
+    p = read_u64(p, end, num_ids);
+    p = read_u64(p, end, flags);
+
+    if (flags & ~TRIE_HAS_AUTOMATON) corrupt("unknown trie flags");
+    if (num_nodes == 0 || num_nodes >= UINT32_MAX) corrupt("bad trie size");
+    p = take_array(p, end, num_nodes, nodes_);
+    p = take_array(p, end, num_ids, ids_);
+    p = take_array(p, end, num_nodes, labels_);
+    if (nodes_[0].ids_begin != 0 || nodes_[0].ids_end != num_ids) corrupt("bad trie root");
+    if (!ids_below(ids_, num_ids, id_limit)) corrupt("bad value id");
+    // 层序存放：各节点的子节点区间依次相接、覆盖 [1, num_nodes)，且都在父节点之后，
+    // 因此每个非根节点恰有一个编号更小的父节点，向下走不会越界或成环
+    std::uint32_t next_child = 1;
+    for (std::uint32_t v = 0; v < num_nodes; ++v) {
+        const TrieNode& node = nodes_[v];
+        if (node.child_begin != next_child || node.child_begin <= v ||
+            node.child_end < node.child_begin || node.child_end > num_nodes)
+            corrupt("bad trie children");
+        next_child = node.child_end;
+        if (node.ids_begin > node.ids_end || node.ids_end > num_ids) corrupt("bad trie ids");
+    }
+    if (next_child != num_nodes) corrupt("bad trie children");
+    p = align8(p, end);
+
+    fail_ = dict_ = term_end_ = depth_ = nullptr;
+    if (flags & TRIE_HAS_AUTOMATON) {
+        p = take_array(p, end, num_nodes, fail_);
+        p = take_array(p, end, num_nodes, dict_);
+        p = take_array(p, end, num_nodes, term_end_);
+        p = take_array(p, end, num_nodes, depth_);
+        p = align8(p, end);
+
+        // 深度沿子节点逐层加一；失配指针与输出链指向更浅的节点，scan 中的链必然终止
+        if (depth_[0] != 0 || dict_[0] != 0) corrupt("bad trie automaton");
+        for (std::uint32_t u = 0; u < num_nodes; ++u) {
+            for (std::uint32_t v = nodes_[u].child_begin; v < nodes_[u].child_end; ++v)
+                if (depth_[v] != depth_[u] + 1) corrupt("bad trie automaton");
+            if (term_end_[u] < nodes_[u].ids_begin || term_end_[u] > nodes_[u].ids_end)
+                corrupt("bad trie automaton");
+        }
+        for (std::uint32_t v = 1; v < num_nodes; ++v) {
+            if (fail_[v] >= num_nodes || depth_[fail_[v]] >= depth_[v] ||
+                dict_[v] >= num_nodes || (dict_[v] != 0 && depth_[dict_[v]] >= depth_[v]))
+                corrupt("bad trie automaton");
+        }
+    }
+    num_nodes_ = static_cast<std::size_t>(num_nodes);
+    return p;
+}
+
+std::uint32_t PrefixTrie::child(std::uint32_t node, char c) const {
+    return trie_child(nodes_, labels_, node, c);
+}
+
+bool PrefixTrie::longest_match(const char* begin, const char* end, bool reversed,
+                               Postings& ids) const {
+    std::uint32_t node = 0;
+    std::size_t n = static_cast<std::size_t>(end - begin);
+    for (std::size_t i = 0; i < n; ++i) {
+        char c = reversed ? end[-1 - static_cast<std::ptrdiff_t>(i)] : begin[i];
+        std::uint32_t next = child(node, c);
+        if (next == 0) break;
+        node = next;
+    }
+    if (node == 0) return false;
+    ids = Postings(ids_ + nodes_[node].ids_begin, ids_ + nodes_[node].ids_end);
+    return true;
+}
+
+// ---------------- GeneIndexWriter ----------------
+
+GeneIndexWriter::GeneIndexWriter() {
+    GeneIndexHeader h{};
+    std::memcpy(h.magic, GENE_INDEX_MAGIC, sizeof(h.magic));
+    h.version = GENE_INDEX_VERSION;
+    h.byte_order = GENE_INDEX_BYTE_ORDER;
+    put_bytes(&h, sizeof(h));
+    pad();
+}
+
+void GeneIndexWriter::put_u64(std::uint64_t v) { put_bytes(&v, sizeof(v)); }
+
+void GeneIndexWriter::put_bytes(const void* p, std::size_t n) {
+    const char* c = static_cast<const char*>(p);
+    buf_.insert(buf_.end(), c, c + n);
+}
+
+void GeneIndexWriter::pad() {
+    while (buf_.size() % 8) buf_.push_back('\0');
+}
+
+void GeneIndexWriter::put_strings(const std::vector<std::string_view>& items) {
+    std::uint64_t bytes = 0;
+    for (auto s : items) bytes += s.size();
+
+    put_u64(items.size());
+    put_u64(bytes);
+    std::uint64_t off = 0;
+    put_u64(off);
+    for (auto s : items) put_u64(off += s.size());
+    for (auto s : items) put_bytes(s.data(), s.size());
+    pad();
+}
+
+void GeneIndexWriter::put_token_table(const TokenSeqTableBuilder& table) {
+    std::uint64_t num_ids = 0;
+    for (const auto& ids : table.postings_) num_ids += ids.size();
+
+    // 空表也保留一个最小的槽位数组，查找逻辑无需特判
+    std::vector<std::uint32_t> empty_slots(16, 0);
+    const auto& slots = table.slots_.empty() ? empty_slots : table.slots_;
+
+    put_u64(table.hashes_.size());
+    put_u64(table.tokens_.size());
+    put_u64(num_ids);
+    put_u64(slots.size());
+    put_bytes(table.hashes_.data(), table.hashes_.size() * sizeof(std::uint64_t));
+    put_bytes(table.tok_off_.data(), table.tok_off_.size() * sizeof(std::uint64_t));
+    std::uint64_t off = 0;
+    put_u64(off);
+    for (const auto& ids : table.postings_) put_u64(off += ids.size());
+    put_bytes(table.tokens_.data(), table.tokens_.size() * sizeof(std::uint32_t));
+    for (const auto& ids : table.postings_)
+        put_bytes(ids.data(), ids.size() * sizeof(std::uint32_t));
+    put_bytes(slots.data(), slots.size() * sizeof(std::uint32_t));
+    pad();
+}
+
+void GeneIndexWriter::put_trie(
+    std::vector<std::pair<std::string, const std::vector<std::uint32_t>*> > keys,
+    bool automaton) {
+    keys.erase(std::remove_if(keys.begin(), keys.end(),
+                              [](const auto& k) { return k.first.empty(); }),
+               keys.end());
+    // 按 unsigned char 字典序排序（与查找时的比较一致），相同 key 保持原有顺序
+    std::stable_sort(keys.begin(), keys.end(),
+                     [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    // 第 i 个 key 的 value ID 从 first_id[i] 开始
+    std::vector<std::uint64_t> first_id(keys.size() + 1, 0);
+    for (std::size_t i = 0; i < keys.size(); ++i)
+        first_id[i + 1] = first_id[i] + keys[i].second->size();
+    if (first_id.back() > UINT32_MAX) throw std::runtime_error("Gene match index too large");
+
+    // 按层序构建：节点 i 覆盖 keys[lo, hi)，这些 key 的前 depth 个字符相同
+    struct Pending {
+        std::size_t lo, hi, depth;
+    };
+    std::vector<TrieNode> nodes;
+    std::vector<char> labels;
+    std::vector<Pending> pending;
+    std::vector<std::uint32_t> term_end; // 恰好在节点处结束的 key 的 ID 区间终点
+    nodes.push_back({0, 0, 0, static_cast<std::uint32_t>(first_id.back())});
+    labels.push_back('\0');
+    pending.push_back({0, keys.size(), 0});
+
+    for (std::size_t i = 0; i < pending.size(); ++i) {
+        Pending cur = pending[i];
+        std::size_t lo = cur.lo;
+        // 恰好在此结束的 key 排在最前面
+        while (lo < cur.hi && keys[lo].first.size() == cur.depth) ++lo;
+        term_end.push_back(static_cast<std::uint32_t>(first_id[lo]));
+
+        nodes[i].child_begin = static_cast<std::uint32_t>(nodes.size());
+        while (lo < cur.hi) {
+            char c = keys[lo].first[cur.depth];
+            std::size_t hi = lo + 1;
+            while (hi < cur.hi && keys[hi].first[cur.depth] == c) ++hi;
+
+            if (nodes.size() >= UINT32_MAX) throw std::runtime_error("Gene match index too large");
+            nodes.push_back({0, 0, static_cast<std::uint32_t>(first_id[lo]),
+                             static_cast<std::uint32_t>(first_id[hi])});
+            labels.push_back(c);
+            pending.push_back({lo, hi, cur.depth + 1});
+            lo = hi;
+        }
+        nodes[i].child_end = static_cast<std::uint32_t>(nodes.size());
+    }
+
+    put_u64(nodes.size());
+    put_u64(first_id.back());
+    put_u64(automaton ? TRIE_HAS_AUTOMATON : 0);
+    put_bytes(nodes.data(), nodes.size() * sizeof(TrieNode));
+    for (const auto& k : keys)
+        put_bytes(k.second->data(), k.second->size() * sizeof(std::uint32_t));
+    put_bytes(labels.data(), labels.size());
+    pad();
+    if (!automaton) return;
+
+    // 失配指针按层序计算：父节点的失配链上第一个有同字符子节点的节点
+    std::size_t n = nodes.size();
+    std::vector<std::uint32_t> fail(n, 0), dict(n, 0), depth(n, 0);
+    auto terminal = [&](std::uint32_t v) { return term_end[v] != nodes[v].ids_begin; };
+    for (std::uint32_t u = 0; u < n; ++u) {
+        for (std::uint32_t v = nodes[u].child_begin; v < nodes[u].child_end; ++v) {
+            depth[v] = depth[u] + 1;
+            if (u != 0) {
+                std::uint32_t f = fail[u];
+                std::uint32_t next;
+                while ((next = trie_child(nodes.data(), labels.data(), f, labels[v])) == 0 &&
+                       f != 0)
+                    f = fail[f];
+                fail[v] = next;
+            }
+            dict[v] = terminal(fail[v]) ? fail[v] : dict[fail[v]];
+        }
+    }
+    for (const auto* arr : {&fail, &dict, &term_end, &depth})
+        put_bytes(arr->data(), n * sizeof(std::uint32_t));
+    pad();
+}
+
+std::vector<char> GeneIndexWriter::finish() {
+    std::uint64_t size = buf_.size();
+    std::memcpy(buf_.data() + offsetof(GeneIndexHeader, size), &size, sizeof(size));
+    return std::move(buf_);
+}
+
+const char* check_gene_index_header(const char* data, std::size_t size) {
+    GeneIndexHeader h;
+    if (size < sizeof(h)) corrupt("truncated");
+    std::memcpy(&h, data, sizeof(h));
+    if (std::memcmp(h.magic, GENE_INDEX_MAGIC, sizeof(h.magic)) != 0) corrupt("bad magic");
+    if (h.byte_order != GENE_INDEX_BYTE_ORDER) corrupt("byte order mismatch");
+    if (h.version != GENE_INDEX_VERSION) corrupt("unsupported version");
+    if (h.size != size) corrupt("size mismatch");
+    if (reinterpret_cast<std::uintptr_t>(data) % 8) corrupt("misaligned image");
+    return align8(data + sizeof(h), data + size);
+}
+
+} // namespace pmcad
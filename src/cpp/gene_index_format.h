@@ -0,0 +1,256 @@
+// src/cpp/gene_index_format.h
+#ifndef PMC_GENE_INDEX_FORMAT_H
+#define PMC_GENE_INDEX_FORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace pmcad {
+
+/**
+ * GeneMatchIndex 的二进制镜像格式（内存中与磁盘上完全相同）。
+ *
+ * 文件头之后按固定顺序依次存放各个表，每个表从 8 字节对齐处开始：
+ *
+ *   StringTable:  u64 count, u64 bytes, u64 offsets[count + 1], char data[bytes]
+ *   TokenSeqTable: u64 count, u64 num_tokens, u64 num_ids, u64 num_slots,
+ *                 u64 hashes[count], u64 tok_offsets[count + 1],
+ *                 u64 post_offsets[count + 1], u32 tokens[num_tokens],
+ *                 u32 ids[num_ids], u32 slots[num_slots]
+ *                 （开放寻址哈希表，slot 存 key 下标 + 1，0 为空）
+ *   PrefixTrie:   u64 num_nodes, u64 num_ids, u64 flags, TrieNode nodes[num_nodes],
+ *                 u32 ids[num_ids], char labels[num_nodes]
+ *                 （节点按层序存放，0 号为根）
+ *                 flags & 1 时随后是 Aho-Corasick 数据（flags 其余位须为 0；
+ *                 GeneMatchIndex 的前缀树必须带自动机）：
+ *                 u32 fail[num_nodes], u32 dict[num_nodes],
+ *                 u32 term_end[num_nodes], u32 depth[num_nodes]
+ *
+ * 所有整数为本机字节序，文件头中的 byte_order 用于拒绝跨字节序加载。
+ * 读取端在 attach 时一次线性扫描校验全部偏移、下标与链接（损坏或截断的镜像
+ * 抛出 runtime_error），之后直接在映射的内存上查找，不做反序列化。
+ */
+struct GeneIndexHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_order;
+    std::uint64_t size; // 整个镜像的字节数
+};
+
+/// value ID 列表的只读视图
+class Postings {
+public:
+    Postings() = default;
+    Postings(const std::uint32_t* b, const std::uint32_t* e) : begin_(b), end_(e) {}
+
+    const std::uint32_t* begin() const { return begin_; }
+    const std::uint32_t* end() const { return end_; }
+    std::size_t size() const { return static_cast<std::size_t>(end_ - begin_); }
+    bool empty() const { return begin_ == end_; }
+
+private:
+    const std::uint32_t* begin_ = nullptr;
+    const std::uint32_t* end_ = nullptr;
+};
+
+/// 字符串表的只读视图
+class StringTable {
+public:
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    /// 在 [p, end) 上解析一个表（不拷贝），返回表之后的位置；越界时抛出 runtime_error
+    const char* attach(const char* p, const char* end);
+
+    std::size_t size() const { return count_; }
+
+    std::string_view at(std::size_t i) const {
+        return std::string_view(data_ + off_[i], off_[i + 1] - off_[i]);
+    }
+
+    /// 仅用于已排序的表：二分查找，未找到返回 npos
+    std::size_t find(std::string_view key) const;
+
+private:
+    std::size_t count_ = 0;
+    const std::uint64_t* off_ = nullptr;
+    const char* data_ = nullptr;
+};
+
+/// 单词序列哈希：h = h * BASE + token + 1，可按前缀和滚动计算任意窗口
+static constexpr std::uint64_t TOKEN_HASH_BASE = 0x9E3779B97F4A7C15ull;
+
+inline std::uint64_t token_hash_step(std::uint64_t h, std::uint32_t token) {
+    return h * TOKEN_HASH_BASE + token + 1;
+}
+
+/**
+ * @class TokenSeqTable
+ * @brief 单词 ID 序列 → value ID 列表的只读哈希表视图。
+ *
+ * 调用方传入序列及其 token_hash_step 累积哈希，查找时不构造任何字符串。
+ */
+class TokenSeqTable {
+public:
+    /// 同 StringTable::attach；列表中的 value ID 须小于 id_limit
+    const char* attach(const char* p, const char* end, std::uint64_t id_limit);
+
+    std::size_t size() const { return count_; }
+
+    /// 查找 key；key 存在（即使列表为空）时返回 true
+    bool find(const std::uint32_t* tokens, std::size_t len, std::uint64_t hash,
+              Postings& ids) const;
+
+private:
+    std::size_t count_ = 0;
+    std::size_t num_slots_ = 0;
+    const std::uint64_t* hashes_ = nullptr;
+    const std::uint64_t* tok_off_ = nullptr;
+    const std::uint64_t* post_off_ = nullptr;
+    const std::uint32_t* tokens_ = nullptr;
+    const std::uint32_t* ids_ = nullptr;
+    const std::uint32_t* slots_ = nullptr;
+};
+
+/**
+ * @class TokenSeqTableBuilder
+ * @brief 构建期使用的可写版本，由 GeneIndexWriter::put_token_table 写出。
+ */
+class TokenSeqTableBuilder {
+public:
+    /// 返回 key 的 value ID 列表，key 不存在时新建空列表
+    std::vector<std::uint32_t>& at(const std::uint32_t* tokens, std::size_t len,
+                                   std::uint64_t hash);
+
+    std::size_t size() const { return hashes_.size(); }
+
+    std::vector<std::vector<std::uint32_t> >& postings() { return postings_; }
+
+private:
+    friend class GeneIndexWriter;
+
+    void grow();
+
+    std::vector<std::uint32_t> tokens_;
+    std::vector<std::uint64_t> tok_off_{0};
+    std::vector<std::uint64_t> hashes_;
+    std::vector<std::vector<std::uint32_t> > postings_;
+    std::vector<std::uint32_t> slots_;
+};
+
+/// 前缀树节点：子节点在 nodes 中连续存放，按边上的字符排序
+struct TrieNode {
+    std::uint32_t child_begin;
+    std::uint32_t child_end;
+    std::uint32_t ids_begin; // 子树内所有 key 的 value ID 区间
+    std::uint32_t ids_end;
+};
+
+/**
+ * @class PrefixTrie
+ * @brief 只读前缀树视图。
+ *
+ * key 按字典序排列后，每个节点的子树对应一段连续的 key，
+ * 这些 key 的 value ID 也连续存放，节点只需记录 [ids_begin, ids_end)。
+ * 存储为 O(总字符数 + 总 ID 数)，而不是为每个前缀单独保存一份 ID 列表。
+ */
+class PrefixTrie {
+public:
+    /// 同 StringTable::attach；ids 中的 value ID 须小于 id_limit
+    const char* attach(const char* p, const char* end, std::uint64_t id_limit);
+
+    std::size_t size() const { return num_nodes_; }
+
+    /// 子节点（按字符二分查找），不存在时返回 0（根节点不是任何节点的子节点）
+    std::uint32_t child(std::uint32_t node, char c) const;
+
+    /**
+     * @brief 沿 [begin, end) 的字符（reversed 时从 end 往前）向下走到不能再走为止。
+     *
+     * 走过的最深节点对应 key 集合中"最长的、是某个 key 前缀的"输入前缀；
+     * 至少走过一个字符时返回 true，ids 为该节点子树内所有 key 的 value ID。
+     */
+    bool longest_match(const char* begin, const char* end, bool reversed,
+                       Postings& ids) const;
+
+    /// 是否带有 Aho-Corasick 失配指针（put_trie 时 automaton = true）
+    bool has_automaton() const { return fail_ != nullptr; }
+
+    /**
+     * @brief Aho-Corasick 扫描：一遍线性扫描 text，找出所有 key 的所有出现位置。
+     *
+     * 每当某个（value 列表非空的）key 出现在 text[end - len, end) 时
+     * 调用 f(end, len, ids)，ids 为该 key 自身的 value ID。
+     */
+    template <class F>
+    void scan(std::string_view text, F&& f) const {
+        std::uint32_t state = 0;
+        for (std::size_t i = 0; i < text.size(); ++i) {
+            std::uint32_t next;
+            while ((next = child(state, text[i])) == 0 && state != 0) state = fail_[state];
+            state = next;
+
+            std::uint32_t out = is_terminal(state) ? state : dict_[state];
+            for (; out != 0; out = dict_[out]) {
+                f(i + 1, depth_[out],
+                  Postings(ids_ + nodes_[out].ids_begin, ids_ + term_end_[out]));
+            }
+        }
+    }
+
+private:
+    bool is_terminal(std::uint32_t node) const {
+        return term_end_[node] != nodes_[node].ids_begin;
+    }
+
+    std::size_t num_nodes_ = 0;
+    const TrieNode* nodes_ = nullptr;
+    const std::uint32_t* ids_ = nullptr;
+    const char* labels_ = nullptr;
+
+    // Aho-Corasick
+    const std::uint32_t* fail_ = nullptr;      // 失配指针
+    const std::uint32_t* dict_ = nullptr;      // 沿失配链最近的终止节点，没有时为 0
+    const std::uint32_t* term_end_ = nullptr;  // 恰好在此结束的 key 的 ID 为 [ids_begin, term_end)
+    const std::uint32_t* depth_ = nullptr;     // 节点深度，即 key 长度
+};
+
+/**
+ * @class GeneIndexWriter
+ * @brief 按上述格式把各个表依次写入一块连续缓冲区。
+ */
+class GeneIndexWriter {
+public:
+    GeneIndexWriter();
+
+    void put_strings(const std::vector<std::string_view>& items);
+
+    void put_token_table(const TokenSeqTableBuilder& table);
+
+    /// 由 (key, value ID 列表) 构建前缀树后写入；空 key 被忽略。
+    /// automaton 为 true 时同时写入 Aho-Corasick 失配指针
+    void put_trie(
+        std::vector<std::pair<std::string, const std::vector<std::uint32_t>*> > keys,
+        bool automaton = false);
+
+    /// 回填文件头中的总长度并交出缓冲区
+    std::vector<char> finish();
+
+private:
+    void put_u64(std::uint64_t v);
+    void put_bytes(const void* p, std::size_t n);
+    void pad();
+
+    std::vector<char> buf_;
+};
+
+/// 校验文件头，返回第一个表的起始位置
+const char* check_gene_index_header(const char* data, std::size_t size);
+
+} // namespace pmcad
+
+#endif // PMC_GENE_INDEX_FORMAT_H
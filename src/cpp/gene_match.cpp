@@ -1,9 +1,14 @@
 #include "gene_match.h"
+#include "text_scan.h"
 
 #include <algorithm>
+#include <atomic>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
-#include <regex>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -11,343 +16,635 @@
 
 namespace pmcad {
 
-class FastPrefixSuffixMatcher {
-private:
-    std::unordered_map<std::string, std::vector<std::string> >
-        prefix_map;
-    std::unordered_map<std::string, std::vector<std::string> >
-        suffix_map;
-
-public:
-    void build(const std::unordered_map<
-               std::string, std::vector<std::string> >&
-                   normalized_ref) {
-        // 为每个reference生成所有可能的前缀和后缀
-        for (const auto& [ref, vals] : normalized_ref) {
-            if (ref.empty()) continue;
-
-            // 生成所有前缀
-            for (size_t len = 1; len <= ref.length(); ++len) {
-                std::string prefix = ref.substr(0, len);
-                prefix_map[prefix].insert(
-                    prefix_map[prefix].end(), vals.begin(),
-                    vals.end());
-            }
+void FastPrefixSuffixMatcher::build(
+    const std::unordered_map<std::string,
+                             std::vector<uint32_t> >&
+        normalized_ref,
+    GeneIndexWriter& out) {
+    // 前缀树的每个节点即一个前缀，节点上记录以它开头的所有reference的value
+    std::vector<std::pair<std::string, const std::vector<uint32_t>*> >
+        keys;
+    keys.reserve(normalized_ref.size());
+    for (const auto& [ref, vals] : normalized_ref) {
+        keys.emplace_back(ref, &vals);
+    }
+    out.put_trie(keys, true);
 
-            // 生成所有后缀
-            for (size_t start = 0; start < ref.length();
-                 ++start) {
-                std::string suffix = ref.substr(start);
-                suffix_map[suffix].insert(
-                    suffix_map[suffix].end(), vals.begin(),
-                    vals.end());
-            }
-        }
+    // 后缀：反转后同样建前缀树
+    for (auto& [key, vals] : keys) {
+        std::reverse(key.begin(), key.end());
     }
+    out.put_trie(std::move(keys));
+}
 
-    // O(1) 前缀匹配（从长到短）
-    void findPrefixMatches(const std::string& query,
-                           std::vector<std::string>& results) {
-        // 检查query的所有前缀，从最长到最短
-        for (size_t len = query.length(); len >= 1; --len) {
-            std::string prefix = query.substr(0, len);
-            auto it = prefix_map.find(prefix);
-            if (it != prefix_map.end()) {
-                results.insert(results.end(),
-                               it->second.begin(),
-                               it->second.end());
-                // 找到最长匹配后立即返回，避免找到更短的匹配
-                return;
-            }
+const char* FastPrefixSuffixMatcher::attach(const char* p,
+                                            const char* end,
+                                            std::uint64_t id_limit) {
+    p = prefix_trie.attach(p, end, id_limit);
+    return suffix_trie.attach(p, end, id_limit);
+}
+
+// 最长前缀匹配：沿前缀树走一遍
+bool FastPrefixSuffixMatcher::findPrefixMatches(
+    const std::string& query, Postings& ids) const {
+    return prefix_trie.longest_match(
+        query.data(), query.data() + query.size(), false, ids);
+}
+
+// 最长后缀匹配：从query末尾开始沿后缀树走一遍
+bool FastPrefixSuffixMatcher::findSuffixMatches(
+    const std::string& query, Postings& ids) const {
+    return suffix_trie.longest_match(
+        query.data(), query.data() + query.size(), true, ids);
+}
+
+static bool is_ascii_digit(char c) { return c >= '0' && c <= '9'; }
+
+static bool is_ascii_lower(char c) { return c >= 'a' && c <= 'z'; }
+
+static bool ends_with(std::string_view s, std::string_view suffix) {
+    return s.size() >= suffix.size() &&
+           s.compare(s.size() - suffix.size(), suffix.size(),
+                     suffix) == 0;
+}
+
+/**
+ * @brief 去掉一个单词（两侧为空白或串首尾）末尾的后缀。
+ *
+ * 原先的四个正则都以 (?=\s|$) 结尾且不跨越空白，因此每个单词每步
+ * 至多命中一次、且只会命中单词末尾；这里按原先的顺序依次处理：
+ *   (alpha|beta|gamma)  → 删除
+ *   -\d+                → 删除
+ *   (\d+)[a-z]          → 只保留数字
+ *   -[a-z]              → 删除
+ * 返回处理后的单词长度。
+ */
+static size_t strip_word_suffix(std::string_view w) {
+    size_t n = w.size();
+
+    for (std::string_view greek : {"alpha", "beta", "gamma"}) {
+        if (ends_with(w.substr(0, n), greek)) {
+            n -= greek.size();
+            break;
         }
     }
 
-    // O(1) 后缀匹配（从长到短）
-    void findSuffixMatches(const std::string& query,
-                           std::vector<std::string>& results) {
-        // 检查query的所有后缀，从最长到最短
-        for (size_t start = 0; start < query.length();
-             ++start) {
-            std::string suffix = query.substr(start);
-            auto it = suffix_map.find(suffix);
-            if (it != suffix_map.end()) {
-                results.insert(results.end(),
-                               it->second.begin(),
-                               it->second.end());
-                // 找到最长匹配后立即返回
-                return;
+    size_t digits = 0;
+    while (digits < n && is_ascii_digit(w[n - 1 - digits])) ++digits;
+    if (digits > 0 && digits < n && w[n - 1 - digits] == '-') {
+        n -= digits + 1;
+    }
+
+    if (n >= 2 && is_ascii_lower(w[n - 1]) && is_ascii_digit(w[n - 2])) {
+        n -= 1;
+    }
+
+    if (n >= 2 && is_ascii_lower(w[n - 1]) && w[n - 2] == '-') {
+        n -= 2;
+    }
+    return n;
+}
+
+/**
+ * @brief normalize_gene_name 的实现。starts / ends 非空时同时记录
+ * out 中每个字符在 in 中的字节区间；单词的最后一个字符的终点记为
+ * 原单词的终点，使被去掉的后缀也算在命中区间内。
+ */
+static void normalize_impl(std::string_view in, std::string& out,
+                           std::vector<size_t>* starts,
+                           std::vector<size_t>* ends) {
+    out.clear();
+    out.reserve(in.size());
+    if (starts) {
+        starts->clear();
+        ends->clear();
+    }
+
+    size_t pos = 0;
+    while (pos < in.size()) {
+        // 跳过空白，找到下一个单词
+        pos += find_non_space(in.data() + pos, in.size() - pos);
+        if (pos == in.size()) break;
+
+        // 单词之间先放一个分隔空格，单词为空时再撤销
+        if (!out.empty()) {
+            out.push_back(' ');
+            if (starts) {
+                starts->push_back(pos);
+                ends->push_back(pos);
+            }
+        }
+        size_t word_start = out.size();
+        size_t len = find_space(in.data() + pos, in.size() - pos);
+        out.resize(word_start + len);
+        lower_copy(in.data() + pos, len, &out[word_start]);
+        if (starts) {
+            for (size_t k = pos; k < pos + len; ++k) {
+                starts->push_back(k);
+                ends->push_back(k + 1);
+            }
+        }
+        pos += len;
+        out.resize(word_start + strip_word_suffix(std::string_view(out).substr(word_start)));
+
+        // '-' / '_' 视为空白：原地压缩，连续分隔符只保留一个空格
+        size_t w = word_start;
+        bool pending_space = false;
+        for (size_t r = word_start; r < out.size(); ++r) {
+            char c = out[r];
+            if (c == '-' || c == '_') {
+                pending_space = true;
+                continue;
+            }
+            if (pending_space && w > 0 && out[w - 1] != ' ') {
+                if (starts) {
+                    (*starts)[w] = (*ends)[w] = (*starts)[r];
+                }
+                out[w++] = ' ';
+            }
+            pending_space = false;
+            if (starts) {
+                (*starts)[w] = (*starts)[r];
+                (*ends)[w] = (*ends)[r];
             }
+            out[w++] = c;
+        }
+        // 去掉没有后续字符的分隔空格
+        if (w > 0 && out[w - 1] == ' ') --w;
+        out.resize(w);
+        if (starts) {
+            starts->resize(w);
+            ends->resize(w);
+            if (w > word_start) (*ends)[w - 1] = pos;
         }
     }
-};
-
-// 定义正则表达式
-std::regex alpha_beta_gamma_pattern(
-    "(alpha|beta|gamma)(?=\\s|$)");
-std::regex dash_digit_pattern("-\\d+(?=\\s|$)");
-std::regex digit_letter_pattern("(\\d+)[a-z](?=\\s|$)");
-std::regex dash_alpha_pattern("-[a-z](?=\\s|$)");
-std::regex whitespace_pattern("\\s+");
-
-// 规范化参考字符串（移除 alpha, beta, gamma, 数字后缀等）
-std::string normalize_reference(const std::string& ref) {
-    std::string normalized_ref = ref;
-    std::transform(normalized_ref.begin(), normalized_ref.end(),
-                   normalized_ref.begin(), ::tolower);
-    normalized_ref = std::regex_replace(
-        normalized_ref, alpha_beta_gamma_pattern, "");
-    normalized_ref = std::regex_replace(normalized_ref,
-                                        dash_digit_pattern, "");
-    normalized_ref = std::regex_replace(
-        normalized_ref, digit_letter_pattern, "$1");
-    normalized_ref = std::regex_replace(normalized_ref,
-                                        dash_alpha_pattern, "");
-    std::replace(normalized_ref.begin(), normalized_ref.end(),
-                 '-', ' ');
-    std::replace(normalized_ref.begin(), normalized_ref.end(),
-                 '_', ' ');
-    normalized_ref = std::regex_replace(
-        normalized_ref, whitespace_pattern, " ");
-    normalized_ref = std::regex_replace(
-        normalized_ref, std::regex("^\\s+|\\s+$"), "");
-    return normalized_ref;
 }
 
-// 规范化查询字符串
-std::string normalize_query(const std::string& query_str) {
-    std::string normalized_query = query_str;
-    std::transform(normalized_query.begin(),
-                   normalized_query.end(),
-                   normalized_query.begin(), ::tolower);
-    normalized_query = std::regex_replace(
-        normalized_query, alpha_beta_gamma_pattern, "");
-    normalized_query = std::regex_replace(
-        normalized_query, dash_digit_pattern, "");
-    normalized_query = std::regex_replace(
-        normalized_query, digit_letter_pattern, "$1");
-    normalized_query = std::regex_replace(
-        normalized_query, dash_alpha_pattern, "");
-    std::replace(normalized_query.begin(),
-                 normalized_query.end(), '-', ' ');
-    std::replace(normalized_query.begin(),
-                 normalized_query.end(), '_', ' ');
-    normalized_query = std::regex_replace(
-        normalized_query, whitespace_pattern, " ");
-    normalized_query = std::regex_replace(
-        normalized_query, std::regex("^\\s+|\\s+$"), "");
-    return normalized_query;
+void normalize_gene_name(std::string_view in, std::string& out) {
+    normalize_impl(in, out, nullptr, nullptr);
 }
 
-std::unordered_map<std::string, std::vector<std::string> >
-GeneMatch::match_reference(
-    const std::vector<std::string>& query,
+// 打印单行进度条（\r 覆盖上一次的输出）
+static void print_progress(const char* label, size_t current,
+                           size_t total) {
+    float progress = static_cast<float>(current) / total;
+    int bar_width = 50; // 进度条宽度
+    int pos = bar_width * progress;
+
+    std::cout << "\r" << label << ": [";
+    for (int i = 0; i < bar_width; ++i) {
+        if (i < pos)
+            std::cout << "=";
+        else if (i == pos)
+            std::cout << ">";
+        else
+            std::cout << " ";
+    }
+    std::cout << "] " << std::setw(3) << int(progress * 100) << "% ("
+              << current << "/" << total << ")";
+    std::flush(std::cout); // 确保输出立即更新
+}
+
+// 按 ' ' 切分单词（与原先的 find(' ') 循环一致：空串得到一个空单词）
+template <class F>
+static void for_each_word(std::string_view s, F&& f) {
+    size_t start = 0, end;
+    while ((end = s.find(' ', start)) != std::string_view::npos) {
+        f(s.substr(start, end - start));
+        start = end + 1;
+    }
+    f(s.substr(start));
+}
+
+static constexpr uint32_t UNKNOWN_TOKEN = UINT32_MAX;
+
+static void add_ids(std::vector<uint32_t>& out, Postings ids) {
+    out.insert(out.end(), ids.begin(), ids.end());
+}
+
+// 排序并去重一个 postings 列表
+static void sort_unique(std::vector<uint32_t>& ids) {
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+}
+
+GeneMatchIndex::GeneMatchIndex(
     const std::unordered_map<
         std::string, std::vector<std::string> >& reference,
     bool verbose) {
-    std::unordered_map<std::string, std::vector<std::string> >
-        result;
+    // value 字符串按首次出现的顺序编号，各个表中只存 ID
+    std::unordered_map<std::string, uint32_t> value_ids;
+    std::vector<std::string_view> values;
+    auto intern = [&](const std::vector<std::string>& vals) {
+        std::vector<uint32_t> ids;
+        ids.reserve(vals.size());
+        for (const auto& v : vals) {
+            auto [it, inserted] = value_ids.emplace(
+                v, static_cast<uint32_t>(values.size()));
+            if (inserted) values.push_back(it->first);
+            ids.push_back(it->second);
+        }
+        return ids;
+    };
 
-    // 预处理参考数据：normalize并合并相同key的value，同时构建扩展字典
-    std::unordered_map<std::string, std::vector<std::string> >
+    // 预处理参考数据：normalize并合并相同key的value
+    std::unordered_map<std::string, std::vector<uint32_t> >
         normalized_reference;
-    std::unordered_map<std::string, std::vector<std::string> >
-        expanded_reference;
 
     int current = 0;
     int total_references = reference.size();
+    std::string ref_norm;
 
     for (const auto& [ref_key, ref_vals] : reference) {
         if (verbose) {
-            float progress = static_cast<float>(current + 1) /
-                             total_references;
-            int bar_width = 50;
-            int pos = bar_width * progress;
-
-            std::cout << "\rProcessing references: [";
-            for (int i = 0; i < bar_width; ++i) {
-                if (i < pos)
-                    std::cout << "=";
-                else if (i == pos)
-                    std::cout << ">";
-                else
-                    std::cout << " ";
-            }
-            std::cout << "] " << std::setw(3)
-                      << int(progress * 100) << "% ("
-                      << current + 1 << "/" << total_references
-                      << ")";
-            std::flush(std::cout);
+            print_progress("Processing references", current + 1,
+                           total_references);
         }
 
-        std::string ref_norm = normalize_reference(ref_key);
+        normalize_gene_name(ref_key, ref_norm);
+        std::vector<uint32_t> ref_ids = intern(ref_vals);
 
-        // 1. 添加到normalized_reference
+        // 添加到normalized_reference
         normalized_reference[ref_norm].insert(
             normalized_reference[ref_norm].end(),
-            ref_vals.begin(), ref_vals.end());
-
-        // 2. 构建扩展字典：将reference拆分为所有连续子序列
-        // 分割参考key为单词序列
-        std::vector<std::string> words;
-        size_t start = 0, end;
-        while ((end = ref_norm.find(' ', start)) !=
-               std::string::npos) {
-            words.push_back(
-                ref_norm.substr(start, end - start));
-            start = end + 1;
-        }
-        words.push_back(ref_norm.substr(start));
-
-        // 生成所有可能的连续子序列
-        for (size_t i = 0; i < words.size(); ++i) {
-            for (size_t j = i; j < words.size(); ++j) {
-                // 构建子序列
-                std::string subsequence;
-                for (size_t k = i; k <= j; ++k) {
-                    if (k > i) subsequence += " ";
-                    subsequence += words[k];
-                }
-
-                // 添加到扩展字典
-                expanded_reference[subsequence].insert(
-                    expanded_reference[subsequence].end(),
-                    ref_vals.begin(), ref_vals.end());
-            }
-        }
+            ref_ids.begin(), ref_ids.end());
 
         current++;
     }
     if (verbose) {
         std::cout << std::endl;
     }
-    FastPrefixSuffixMatcher matcher;
-    matcher.build(normalized_reference);
 
-    // 处理每个查询
-    size_t total_queries = query.size();
-    for (size_t idx = 0; idx < query.size(); ++idx) {
-        const std::string& q = query[idx];
-        if (verbose) {
-            float progress =
-                static_cast<float>(idx + 1) / total_queries;
-            int bar_width = 50; // 进度条宽度
-            int pos = bar_width * progress;
-
-            // 清除当前行并打印新的进度条
-            std::cout << "\rProcessing queries: [";
-            for (int i = 0; i < bar_width; ++i) {
-                if (i < pos)
-                    std::cout << "=";
-                else if (i == pos)
-                    std::cout << ">";
-                else
-                    std::cout << " ";
+    // 按字符串字典序重新编号 value，并把每个 postings 列表排序去重
+    std::vector<uint32_t> order(values.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = static_cast<uint32_t>(i);
+    }
+    std::sort(order.begin(), order.end(),
+              [&](uint32_t a, uint32_t b) {
+                  return values[a] < values[b];
+              });
+    std::vector<uint32_t> remap(values.size());
+    std::vector<std::string_view> sorted_values(values.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        remap[order[i]] = static_cast<uint32_t>(i);
+        sorted_values[i] = values[order[i]];
+    }
+    for (auto& [key, ids] : normalized_reference) {
+        for (auto& id : ids) id = remap[id];
+        sort_unique(ids);
+    }
+
+    // 单词表：按字典序编号，查询时二分查找得到单词 ID
+    std::vector<std::string_view> words;
+    for (const auto& [key, ids] : normalized_reference) {
+        for_each_word(key, [&](std::string_view w) { words.push_back(w); });
+    }
+    std::sort(words.begin(), words.end());
+    words.erase(std::unique(words.begin(), words.end()), words.end());
+    std::unordered_map<std::string_view, uint32_t> word_ids;
+    word_ids.reserve(words.size());
+    for (size_t i = 0; i < words.size(); ++i) {
+        word_ids.emplace(words[i], static_cast<uint32_t>(i));
+    }
+
+    // 规范化字典和扩展字典都以单词 ID 序列为 key
+    TokenSeqTableBuilder normalized_table, expanded_table;
+    std::vector<uint32_t> tokens;
+    for (const auto& [key, ids] : normalized_reference) {
+        tokens.clear();
+        for_each_word(key, [&](std::string_view w) {
+            tokens.push_back(word_ids.at(w));
+        });
+
+        uint64_t hash = 0;
+        for (uint32_t t : tokens) hash = token_hash_step(hash, t);
+        normalized_table.at(tokens.data(), tokens.size(), hash) = ids;
+
+        // 构建扩展字典：所有连续子序列，哈希随右端点滚动计算
+        for (size_t i = 0; i < tokens.size(); ++i) {
+            uint64_t h = 0;
+            for (size_t j = i; j < tokens.size(); ++j) {
+                h = token_hash_step(h, tokens[j]);
+                auto& sub = expanded_table.at(tokens.data() + i,
+                                              j - i + 1, h);
+                sub.insert(sub.end(), ids.begin(), ids.end());
             }
-            std::cout << "] " << std::setw(3)
-                      << int(progress * 100) << "% (" << idx + 1
-                      << "/" << total_queries << ")";
-            std::flush(std::cout); // 确保输出立即更新
         }
-        std::string q_norm = normalize_query(q);
+    }
+    for (auto& ids : expanded_table.postings()) sort_unique(ids);
+
+    // 写出镜像：value 表、单词表、规范化字典、扩展字典、前缀树、后缀树
+    GeneIndexWriter writer;
+    writer.put_strings(sorted_values);
+    writer.put_strings(words);
+    writer.put_token_table(normalized_table);
+    writer.put_token_table(expanded_table);
+    FastPrefixSuffixMatcher::build(normalized_reference, writer);
+
+    storage_ = writer.finish();
+    attach(storage_.data(), storage_.size());
+}
 
-        // 首先尝试直接匹配
-        auto direct_match = normalized_reference.find(q_norm);
-        if (direct_match != normalized_reference.end()) {
-            result[q] = direct_match->second;
-            continue;
-        }
+GeneMatchIndex GeneMatchIndex::load(const std::string& path) {
+    GeneMatchIndex index;
+    // attach 会校验整个镜像，之后的查找随机访问各表：一次读入全部页，
+    // 而不是按顺序预读后又回收
+    index.file_ = std::make_unique<MappedFile>(path, MappedFile::Advice::WillNeed);
+    index.attach(index.file_->data(), index.file_->size());
+    return index;
+}
 
-        // 分割查询字符串为单词序列
-        std::vector<std::string> words;
-        size_t start = 0, end;
-        while ((end = q_norm.find(' ', start)) !=
-               std::string::npos) {
-            words.push_back(q_norm.substr(start, end - start));
-            start = end + 1;
-        }
-        words.push_back(q_norm.substr(start));
-
-        // 生成查询的所有可能连续子序列，并在reference中查找
-        bool judge = false;
-        for (size_t i = words.size(); i > 0; --i) {
-            for (size_t j = 0; i + j <= words.size(); ++j) {
-                // 构建子序列
-                std::string subsequence;
-                for (size_t k = j; k < i + j; ++k) {
-                    if (k > j) subsequence += " ";
-                    subsequence += words[k];
-                }
+void GeneMatchIndex::attach(const char* data, size_t size) {
+    const char* end = data + size;
+    const char* p = check_gene_index_header(data, size);
+    p = values_.attach(p, end);
+    p = tokens_.attach(p, end);
+    p = normalized_reference_.attach(p, end, values_.size());
+    p = expanded_reference_.attach(p, end, values_.size());
+    p = matcher_.attach(p, end, values_.size());
+    // scan() 依赖前缀树上的 Aho-Corasick 自动机
+    if (!matcher_.prefix().has_automaton()) {
+        throw std::runtime_error(
+            "Invalid gene match index: prefix trie has no automaton");
+    }
+    if (p != end) {
+        throw std::runtime_error(
+            "Invalid gene match index: trailing data");
+    }
+    image_ = std::string_view(data, size);
+}
 
-                // 在normalized_reference中查找这个子序列
-                auto ref_match =
-                    normalized_reference.find(subsequence);
-                if (ref_match != normalized_reference.end()) {
-                    result[q].insert(result[q].end(),
-                                     ref_match->second.begin(),
-                                     ref_match->second.end());
-                    judge = true;
-                }
-            }
-            if (judge) {
-                break;
+void GeneMatchIndex::save(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        throw std::runtime_error("Cannot open file: " + path);
+    }
+    out.write(image_.data(),
+              static_cast<std::streamsize>(image_.size()));
+    out.close();
+    if (!out) {
+        throw std::runtime_error("Failed to write file: " + path);
+    }
+}
+
+// value ID 按字符串字典序编号，排序去重后的 ID 即为排好序的 value
+std::vector<std::string> GeneMatchIndex::values_of(
+    std::vector<uint32_t>& ids) const {
+    sort_unique(ids);
+
+    std::vector<std::string> out;
+    out.reserve(ids.size());
+    for (uint32_t id : ids) out.emplace_back(values_.at(id));
+    return out;
+}
+
+void GeneMatchIndex::tokenize(std::string_view s,
+                              QueryScratch& sc) const {
+    sc.tokens.clear();
+    sc.prefix_hash.assign(1, 0);
+    sc.unknown.assign(1, 0);
+    for_each_word(s, [&](std::string_view w) {
+        size_t id = tokens_.find(w);
+        uint32_t t = id == StringTable::npos
+                         ? UNKNOWN_TOKEN
+                         : static_cast<uint32_t>(id);
+        sc.tokens.push_back(t);
+        sc.prefix_hash.push_back(
+            token_hash_step(sc.prefix_hash.back(), t));
+        sc.unknown.push_back(sc.unknown.back() +
+                             (t == UNKNOWN_TOKEN));
+    });
+    if (sc.power.empty()) sc.power.push_back(1);
+    while (sc.power.size() <= sc.tokens.size()) {
+        sc.power.push_back(sc.power.back() * TOKEN_HASH_BASE);
+    }
+}
+
+bool GeneMatchIndex::find_window(const TokenSeqTable& table,
+                                 const QueryScratch& sc, size_t j,
+                                 size_t len, Postings& ids) const {
+    // 含有词表外单词的子序列不可能命中
+    if (sc.unknown[j + len] != sc.unknown[j]) return false;
+    uint64_t hash =
+        sc.prefix_hash[j + len] - sc.prefix_hash[j] * sc.power[len];
+    return table.find(sc.tokens.data() + j, len, hash, ids);
+}
+
+void GeneMatchIndex::match_one(const std::string& q,
+                               QueryScratch& sc,
+                               IdLists& hits) const {
+    normalize_gene_name(q, sc.q_norm);
+
+    // 分割查询字符串为单词 ID 序列
+    tokenize(sc.q_norm, sc);
+    size_t n = sc.tokens.size();
+
+    // 首先尝试直接匹配
+    Postings ids;
+    if (find_window(normalized_reference_, sc, 0, n, ids)) {
+        auto& out = hits[q];
+        out.clear();
+        add_ids(out, ids);
+        return;
+    }
+
+    // 查询的所有可能连续子序列，按滚动哈希在reference中查找（不构造子串）
+    bool judge = false;
+    for (size_t i = n; i > 0; --i) {
+        for (size_t j = 0; i + j <= n; ++j) {
+            if (find_window(normalized_reference_, sc, j, i, ids)) {
+                add_ids(hits[q], ids);
+                judge = true;
             }
         }
-        if (judge) continue;
-
-        auto expanded_match = expanded_reference.find(q);
-        if (expanded_match != expanded_reference.end()) {
-            result[q].insert(result[q].end(),
-                             expanded_match->second.begin(),
-                             expanded_match->second.end());
-            judge = true;
+        if (judge) {
+            return;
         }
-        if (judge) continue;
-
-        for (size_t i = words.size(); i > 0; --i) {
-            for (size_t j = 0; i + j <= words.size(); ++j) {
-                // 构建子序列
-                std::string subsequence;
-                for (size_t k = j; k < i + j; ++k) {
-                    if (k > j) subsequence += " ";
-                    subsequence += words[k];
-                }
+    }
 
-                // 在normalized_reference中查找这个子序列
-                auto ref_match =
-                    expanded_reference.find(subsequence);
-                if (ref_match != expanded_reference.end()) {
-                    result[q].insert(result[q].end(),
-                                     ref_match->second.begin(),
-                                     ref_match->second.end());
-                    judge = true;
-                }
+    // 原始（未规范化的）查询串在扩展字典中查找
+    tokenize(q, sc);
+    if (find_window(expanded_reference_, sc, 0, sc.tokens.size(),
+                    ids)) {
+        add_ids(hits[q], ids);
+        return;
+    }
+
+    tokenize(sc.q_norm, sc);
+    for (size_t i = n; i > 0; --i) {
+        for (size_t j = 0; i + j <= n; ++j) {
+            // 在expanded_reference中查找这个子序列
+            if (find_window(expanded_reference_, sc, j, i, ids)) {
+                add_ids(hits[q], ids);
+                judge = true;
+            }
+        }
+    }
+    if (judge) return;
+
+    Postings prefix_matches, suffix_matches;
+
+    // 高效前缀匹配
+    matcher_.findPrefixMatches(sc.q_norm, prefix_matches);
+    // 高效后缀匹配
+    matcher_.findSuffixMatches(sc.q_norm, suffix_matches);
+
+    if (!prefix_matches.empty() ||
+        !suffix_matches.empty()) {
+        auto& out = hits[q];
+        add_ids(out, prefix_matches);
+        add_ids(out, suffix_matches);
+    }
+}
+
+std::unordered_map<std::string, std::vector<std::string> >
+GeneMatchIndex::match(const std::vector<std::string>& query,
+                      bool verbose, unsigned num_threads) const {
+    // 查询按块分发，空闲线程从共享计数器领取下一块
+    const size_t chunk_size = 256;
+    size_t total_queries = query.size();
+    size_t num_chunks = (total_queries + chunk_size - 1) / chunk_size;
+
+    if (num_threads == 0) num_threads = std::thread::hardware_concurrency();
+    num_threads = std::max(1u, std::min<unsigned>(
+        num_threads, static_cast<unsigned>(std::max<size_t>(num_chunks, 1))));
+
+    // 每个线程一份局部结果，互不加锁，最后合并
+    std::vector<std::unordered_map<std::string, std::vector<std::string> > >
+        partial(num_threads);
+    std::atomic<size_t> next_chunk{0};
+    size_t done = 0;
+    std::mutex progress_mutex;
+
+    auto worker = [&](unsigned t) {
+        // 匹配过程中只收集 value ID，最后统一排序去重再转换为字符串
+        IdLists hits;
+        QueryScratch scratch;
+        for (size_t c; (c = next_chunk++) < num_chunks;) {
+            size_t begin = c * chunk_size;
+            size_t end = std::min(total_queries, begin + chunk_size);
+            for (size_t idx = begin; idx < end; ++idx) {
+                match_one(query[idx], scratch, hits);
+            }
+            if (verbose) {
+                std::lock_guard<std::mutex> lock(progress_mutex);
+                done += end - begin;
+                print_progress("Processing queries", done, total_queries);
             }
         }
-        if (judge) continue;
-
-        std::vector<std::string> prefix_matches, suffix_matches;
-
-        // 高效前缀匹配
-        matcher.findPrefixMatches(q_norm, prefix_matches);
-        // 高效后缀匹配
-        matcher.findSuffixMatches(q_norm, suffix_matches);
-
-        if (!prefix_matches.empty() ||
-            !suffix_matches.empty()) {
-            result[q].insert(result[q].end(),
-                             prefix_matches.begin(),
-                             prefix_matches.end());
-            result[q].insert(result[q].end(),
-                             suffix_matches.begin(),
-                             suffix_matches.end());
+
+        auto& out = partial[t];
+        out.reserve(hits.size());
+        for (auto& [q, ids] : hits) {
+            out.emplace(q, values_of(ids));
         }
+    };
+
+    if (num_threads <= 1) {
+        worker(0);
+    } else {
+        std::vector<std::thread> threads;
+        for (unsigned t = 0; t < num_threads; ++t) threads.emplace_back(worker, t);
+        for (auto& t : threads) t.join();
     }
 
     if (verbose) {
         std::cout << std::endl;
     }
 
+    // 同一个查询在不同线程得到的结果相同，合并时保留任意一份即可
+    std::unordered_map<std::string, std::vector<std::string> > result =
+        std::move(partial[0]);
+    for (unsigned t = 1; t < num_threads; ++t) {
+        result.merge(partial[t]);
+    }
+    return result;
+}
+
+void GeneMatchIndex::scan_one(std::string_view text, bool longest_only,
+                              ScanScratch& sc,
+                              std::vector<GeneMention>& out) const {
+    out.clear();
+    // 全文中的标点视为空白（逐字节替换，偏移不变）
+    sc.text.assign(text.data(), text.size());
+    blank_punctuation(sc.text.data(), sc.text.size());
+    normalize_impl(sc.text, sc.norm, &sc.starts, &sc.ends);
+
+    // 只保留两侧为空格或文本边界的命中，即完整的单词序列
+    const std::string& norm = sc.norm;
+    matcher_.prefix().scan(norm, [&](size_t end, size_t len, Postings ids) {
+        size_t begin = end - len;
+        if ((begin == 0 || norm[begin - 1] == ' ') &&
+            (end == norm.size() || norm[end] == ' ')) {
+            out.push_back({begin, end, ids});
+        }
+    });
+
+    // 按起点、再按长度从长到短排序（此时区间仍是规范化文本中的位置）
+    std::sort(out.begin(), out.end(),
+              [](const GeneMention& a, const GeneMention& b) {
+                  return a.begin != b.begin ? a.begin < b.begin
+                                            : a.end > b.end;
+              });
+    if (longest_only) {
+        size_t kept = 0, covered = 0;
+        for (const auto& m : out) {
+            if (m.begin < covered) continue;
+            covered = m.end;
+            out[kept++] = m;
+        }
+        out.resize(kept);
+    }
+
+    for (auto& m : out) {
+        m.begin = sc.starts[m.begin];
+        m.end = sc.ends[m.end - 1];
+    }
+}
+
+std::vector<std::vector<GeneMention> >
+GeneMatchIndex::scan(const std::vector<std::string>& texts,
+                     bool longest_only, unsigned num_threads) const {
+    // 每段文本的结果写入各自的位置，线程之间无需合并
+    std::vector<std::vector<GeneMention> > result(texts.size());
+    const size_t chunk_size = 64;
+    size_t num_chunks = (texts.size() + chunk_size - 1) / chunk_size;
+
+    if (num_threads == 0) num_threads = std::thread::hardware_concurrency();
+    num_threads = std::max(1u, std::min<unsigned>(
+        num_threads, static_cast<unsigned>(std::max<size_t>(num_chunks, 1))));
+
+    std::atomic<size_t> next_chunk{0};
+    auto worker = [&]() {
+        ScanScratch scratch;
+        for (size_t c; (c = next_chunk++) < num_chunks;) {
+            size_t begin = c * chunk_size;
+            size_t end = std::min(texts.size(), begin + chunk_size);
+            for (size_t idx = begin; idx < end; ++idx) {
+                scan_one(texts[idx], longest_only, scratch, result[idx]);
+            }
+        }
+    };
+
+    if (num_threads <= 1) {
+        worker();
+    } else {
+        std::vector<std::thread> threads;
+        for (unsigned t = 0; t < num_threads; ++t) threads.emplace_back(worker);
+        for (auto& t : threads) t.join();
+    }
     return result;
 }
 
+std::unordered_map<std::string, std::vector<std::string> >
+GeneMatch::match_reference(
+    const std::vector<std::string>& query,
+    const std::unordered_map<
+        std::string, std::vector<std::string> >& reference,
+    bool verbose) {
+    GeneMatchIndex index(reference, verbose);
+    return index.match(query, verbose);
+}
+
 } // namespace pmcad
\ No newline at end of file
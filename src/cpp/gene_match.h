@@ -1,16 +1,177 @@
 #pragma once
 #include <algorithm>
+#include <cstdint>
 #include <iostream>
-#include <regex>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
+#include "gene_index_format.h"
+#include "mapped_file.h"
+
 namespace pmcad {
 
+/**
+ * @brief 基因名规范化：转小写，去掉单词末尾的 alpha/beta/gamma、-数字、
+ * 数字后的单个字母、-字母，'-' / '_' 视为空白，空白压缩为单个空格并去掉首尾空白。
+ *
+ * 手写的单遍扫描，结果写入 out（复用其容量），与原先的多次 std::regex_replace 等价。
+ * 参考和查询使用同一规则。
+ */
+void normalize_gene_name(std::string_view in, std::string& out);
+
+// 前缀 / 后缀最长匹配：参考字符串的前缀树 + 反转字符串的前缀树（即后缀树）
+class FastPrefixSuffixMatcher {
+private:
+    PrefixTrie prefix_trie;
+    PrefixTrie suffix_trie;
+
+public:
+    // 把两棵树依次写入索引镜像
+    static void build(const std::unordered_map<
+                          std::string, std::vector<uint32_t> >&
+                          normalized_ref,
+                      GeneIndexWriter& out);
+
+    // 在镜像上挂接两个表，返回之后的位置；value ID 须小于 id_limit
+    const char* attach(const char* p, const char* end, std::uint64_t id_limit);
+
+    // 找到最长匹配时返回 true，ids 为其 value ID 列表
+    bool findPrefixMatches(const std::string& query,
+                           Postings& ids) const;
+
+    bool findSuffixMatches(const std::string& query,
+                           Postings& ids) const;
+
+    // 前缀树带有 Aho-Corasick 失配指针，可直接用于全文扫描
+    const PrefixTrie& prefix() const { return prefix_trie; }
+};
+
+/// 全文扫描命中的一处基因名：原文中的字节区间 [begin, end) 及其 value ID
+struct GeneMention {
+    size_t begin;
+    size_t end;
+    Postings values;  // 指向索引镜像，索引存活期间有效
+};
+
+/**
+ * @class GeneMatchIndex
+ * @brief 预先构建好的基因名匹配索引。
+ *
+ * 构造时完成参考字典的规范化、连续子序列展开和前缀/后缀索引，
+ * 之后可对同一份参考字典反复调用 match()，不再重复建索引。
+ * value 字符串在构建时编号为 uint32_t（按字典序），各表只存排序去重后的 ID 列表；
+ * 每个查询的结果为所有命中 value 的并集，按字典序排列且不含重复。
+ *
+ * 所有表（value 字符串表、规范化/扩展字典、前缀/后缀表）存放在一块连续镜像中，
+ * 格式见 gene_index_format.h。save() 原样写出镜像，load() 只做 mmap 和一次线性校验，
+ * 多个进程加载同一文件时通过 page cache 共享同一份物理内存。
+ */
+class GeneMatchIndex {
+public:
+    explicit GeneMatchIndex(
+        const std::unordered_map<
+            std::string, std::vector<std::string> >& reference,
+        bool verbose = false);
+
+    /// mmap 加载 save() 写出的索引文件
+    static GeneMatchIndex load(const std::string& path);
+
+    void save(const std::string& path) const;
+
+    // 表视图指向 storage_ / file_，移动后地址不变
+    GeneMatchIndex(GeneMatchIndex&&) = default;
+    GeneMatchIndex& operator=(GeneMatchIndex&&) = default;
+
+    /**
+     * @brief 批量匹配。索引只读，查询按块分发到 num_threads 个线程
+     * （0 表示使用全部硬件线程），各线程的局部结果最后合并。
+     */
+    std::unordered_map<std::string, std::vector<std::string> >
+    match(const std::vector<std::string>& query,
+          bool verbose = false, unsigned num_threads = 0) const;
+
+    /**
+     * @brief 在整段文本（如 PubMed 摘要）中扫描参考字典里的基因名。
+     *
+     * 文本中的标点（, ; : 括号 引号 ! ? 以及句末的 .）先视为空白，再按
+     * normalize_gene_name 的规则规范化，然后用前缀树上的 Aho-Corasick
+     * 自动机一遍线性扫描，只保留以单词为边界的完整命中。
+     * longest_only 为 true 时从左到右贪心选取最长且互不重叠的命中，
+     * 否则返回所有命中（按起点、再按长度从长到短排序）。
+     * 返回区间为原文中的字节偏移；文本按块分发到 num_threads 个线程。
+     */
+    std::vector<std::vector<GeneMention> >
+    scan(const std::vector<std::string>& texts, bool longest_only = true,
+         unsigned num_threads = 0) const;
+
+    /// value ID 对应的 value 字符串
+    std::string_view value(uint32_t id) const { return values_.at(id); }
+
+    size_t num_values() const { return values_.size(); }
+
+    /// 规范化后不同参考 key 的数量
+    size_t size() const { return normalized_reference_.size(); }
+
+private:
+    using IdLists =
+        std::unordered_map<std::string, std::vector<uint32_t> >;
+
+    GeneMatchIndex() = default;
+
+    // 每个线程复用的查询缓冲区
+    struct QueryScratch {
+        std::string q_norm;
+        std::vector<uint32_t> tokens;       // 单词 ID，词表外为 UINT32_MAX
+        std::vector<uint64_t> prefix_hash;  // 前 i 个单词的序列哈希
+        std::vector<uint32_t> unknown;      // 前 i 个单词中词表外单词的个数
+        std::vector<uint64_t> power;        // TOKEN_HASH_BASE 的幂
+    };
+
+    // 每个线程复用的全文扫描缓冲区
+    struct ScanScratch {
+        std::string text;           // 标点替换为空格后的原文
+        std::string norm;           // 规范化后的文本
+        std::vector<size_t> starts; // norm[k] 在原文中的起点
+        std::vector<size_t> ends;   // norm[k] 在原文中的终点
+    };
+
+    void scan_one(std::string_view text, bool longest_only,
+                  ScanScratch& sc, std::vector<GeneMention>& out) const;
+
+    // 把 s 按空格切分并转换为单词 ID，同时计算前缀哈希
+    void tokenize(std::string_view s, QueryScratch& sc) const;
+
+    // 查找 tokens[j, j + len) 这个子序列
+    bool find_window(const TokenSeqTable& table, const QueryScratch& sc,
+                     size_t j, size_t len, Postings& ids) const;
+
+    // 匹配单个查询，命中的 value ID 追加到 hits[q]
+    void match_one(const std::string& q, QueryScratch& sc,
+                   IdLists& hits) const;
+
+    void attach(const char* data, size_t size);
+
+    // 排序去重 ids，并转换为 value 字符串
+    std::vector<std::string> values_of(std::vector<uint32_t>& ids) const;
+
+    std::vector<char> storage_;         // 构建得到的镜像
+    std::unique_ptr<MappedFile> file_;  // 或者从文件映射的镜像
+    std::string_view image_;
+
+    StringTable values_;  // value ID → value 字符串
+    StringTable tokens_;  // 单词 ID → 单词（按字典序）
+    TokenSeqTable normalized_reference_;
+    TokenSeqTable expanded_reference_;
+    FastPrefixSuffixMatcher matcher_;
+};
+
 class GeneMatch {
 public:
+    // 一次性接口：内部构建 GeneMatchIndex 后匹配
     static std::unordered_map<std::string,
                               std::vector<std::string> >
     match_reference(
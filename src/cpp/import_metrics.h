@@ -0,0 +1,102 @@
+// src/cpp/import_metrics.h
+#ifndef PMC_IMPORT_METRICS_H
+#define PMC_IMPORT_METRICS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace pmcad {
+
+/// 一张目标表的写入统计（多连接时为各分区之和）
+struct TableMetrics {
+    std::string table;
+    std::size_t rows = 0;           ///< 本次导入送入 COPY 流的行数
+    std::size_t flushes = 0;        ///< 向服务端发送数据的次数
+    double flush_seconds = 0;       ///< 发送耗时合计
+    double max_flush_seconds = 0;   ///< 单次发送的最长耗时
+    std::size_t commits = 0;        ///< 已提交的批次数
+    double commit_seconds = 0;      ///< 结束 COPY、写断点并提交事务的耗时合计
+};
+
+/**
+ * @brief 导入过程的指标快照。
+ *
+ * phase 依次为 "import"（解压 / 解析 / COPY）、"finish"（提交剩余批次）、
+ * "merge"（增量更新时把暂存表合并进正式表）、"index"（bulk_load 时 SET LOGGED 并建索引）、
+ * "done"。
+ * 对比 inflated_bytes、parsed_bytes 的增速与各表的 flush / commit 耗时，
+ * 可以看出瓶颈在解压、解析还是 PostgreSQL。
+ */
+struct ImportMetrics {
+    std::string phase;
+    double elapsed_seconds = 0;
+    std::size_t compressed_bytes = 0; ///< 已读取的压缩字节
+    std::size_t total_bytes = 0;      ///< 压缩文件总大小
+    std::size_t inflated_bytes = 0;   ///< 已解压的字节
+    std::size_t parsed_bytes = 0;     ///< 已解析的字节
+    std::size_t entries = 0;          ///< 已解析的条目数
+    std::size_t parse_errors = 0;     ///< 无法解析而被跳过的行数
+    std::vector<TableMetrics> tables;
+};
+
+using MetricsCallback = std::function<void(const ImportMetrics&)>;
+
+/**
+ * @class CopyStats
+ * @brief 写入端累加的计数器。
+ *
+ * 写入线程只做 relaxed 原子累加，指标线程随时读取，互不加锁。
+ */
+class CopyStats {
+public:
+    using Duration = std::chrono::steady_clock::duration;
+
+    void add_row() { rows_.fetch_add(1, std::memory_order_relaxed); }
+
+    void add_flush(Duration d) {
+        auto ns = to_ns(d);
+        flushes_.fetch_add(1, std::memory_order_relaxed);
+        flush_ns_.fetch_add(ns, std::memory_order_relaxed);
+        auto max = max_flush_ns_.load(std::memory_order_relaxed);
+        while (ns > max && !max_flush_ns_.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {
+        }
+    }
+
+    void add_commit(Duration d) {
+        commits_.fetch_add(1, std::memory_order_relaxed);
+        commit_ns_.fetch_add(to_ns(d), std::memory_order_relaxed);
+    }
+
+    /// 累加到 out（多个分区合并为同一张表）
+    void collect(TableMetrics& out) const {
+        out.rows += rows_.load(std::memory_order_relaxed);
+        out.flushes += flushes_.load(std::memory_order_relaxed);
+        out.flush_seconds += flush_ns_.load(std::memory_order_relaxed) * 1e-9;
+        double max = max_flush_ns_.load(std::memory_order_relaxed) * 1e-9;
+        if (max > out.max_flush_seconds) out.max_flush_seconds = max;
+        out.commits += commits_.load(std::memory_order_relaxed);
+        out.commit_seconds += commit_ns_.load(std::memory_order_relaxed) * 1e-9;
+    }
+
+private:
+    static std::uint64_t to_ns(Duration d) {
+        return static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(d).count());
+    }
+
+    std::atomic<std::uint64_t> rows_{0};
+    std::atomic<std::uint64_t> flushes_{0};
+    std::atomic<std::uint64_t> flush_ns_{0};
+    std::atomic<std::uint64_t> max_flush_ns_{0};
+    std::atomic<std::uint64_t> commits_{0};
+    std::atomic<std::uint64_t> commit_ns_{0};
+};
+
+} // namespace pmcad
+
+#endif // PMC_IMPORT_METRICS_H
@@ -0,0 +1,47 @@
+// src/cpp/mapped_file.cpp
+#include "mapped_file.h"
+
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace pmcad {
+
+static int madvise_flag(MappedFile::Advice advice) {
+    switch (advice) {
+    case MappedFile::Advice::Random: return MADV_RANDOM;
+    case MappedFile::Advice::WillNeed: return MADV_WILLNEED;
+    default: return MADV_SEQUENTIAL;
+    }
+}
+
+MappedFile::MappedFile(const std::string& path, Advice advice) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("Cannot open file: " + path);
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Cannot stat file: " + path);
+    }
+    size_ = static_cast<std::size_t>(st.st_size);
+
+    if (size_ > 0) {
+        void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("Cannot mmap file: " + path);
+        }
+        ::madvise(p, size_, madvise_flag(advice));
+        data_ = static_cast<const char*>(p);
+    }
+    ::close(fd); // 映射建立后即可关闭文件描述符
+}
+
+MappedFile::~MappedFile() {
+    if (data_) ::munmap(const_cast<char*>(data_), size_);
+}
+
+} // namespace pmcad
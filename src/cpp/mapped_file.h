@@ -0,0 +1,44 @@
+// src/cpp/mapped_file.h
+#ifndef PMC_MAPPED_FILE_H
+#define PMC_MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace pmcad {
+
+/**
+ * @class MappedFile
+ * @brief 只读 mmap 整个文件，析构时 munmap。
+ *
+ * 数据由内核按需分页读入，不经过用户态缓冲区拷贝；
+ * 空文件不做映射，view() 返回空视图。
+ */
+class MappedFile {
+public:
+    /// 映射建立后传给 madvise 的访问模式
+    enum class Advice {
+        Sequential,  // 从头到尾读一遍（MADV_SEQUENTIAL：加大预读，读过的页尽早回收）
+        Random,      // 随机访问（MADV_RANDOM：关闭预读）
+        WillNeed,    // 很快会访问整个文件（MADV_WILLNEED：立即异步读入全部页）
+    };
+
+    explicit MappedFile(const std::string& path, Advice advice = Advice::Sequential);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return data_; }
+    std::size_t size() const { return size_; }
+    std::string_view view() const { return std::string_view(data_, size_); }
+
+private:
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+} // namespace pmcad
+
+#endif // PMC_MAPPED_FILE_H
@@ -0,0 +1,304 @@
+// src/cpp/ontology_graph.cpp
+#include "ontology_graph.h"
+#include "mapped_file.h"
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <unordered_set>
+
+namespace pmcad {
+
+/// 构建中的图：term 编号、名称、边表与 alt_id 别名
+struct OntologyGraph::Builder {
+    std::vector<std::string> terms;
+    std::vector<std::string> names;
+    std::unordered_map<std::string, std::uint32_t> index;
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> edges;  // (child, parent)
+    std::vector<std::pair<std::string, std::uint32_t>> alt_ids;
+
+    std::uint32_t intern(std::string_view term) {
+        auto [it, inserted] = index.emplace(std::string(term), static_cast<std::uint32_t>(terms.size()));
+        if (inserted) {
+            terms.emplace_back(term);
+            names.emplace_back();
+        }
+        return it->second;
+    }
+};
+
+OntologyGraph OntologyGraph::from_edges(const std::vector<std::string>& children,
+                                        const std::vector<std::string>& parents) {
+    if (children.size() != parents.size())
+        throw std::invalid_argument("❌ children and parents must have the same length");
+    Builder b;
+    for (std::size_t i = 0; i < children.size(); ++i) {
+        std::uint32_t child = b.intern(children[i]);
+        b.edges.emplace_back(child, b.intern(parents[i]));
+    }
+    return OntologyGraph(std::move(b));
+}
+
+/// 行首 key 之后的值（"is_a: GO:1 ! x" → "GO:1 ! x"），不匹配时返回 false
+static bool obo_value(std::string_view line, std::string_view key, std::string_view& value) {
+    if (line.size() <= key.size() || line.compare(0, key.size(), key) != 0 ||
+        line[key.size()] != ':')
+        return false;
+    value = line.substr(key.size() + 1);
+    while (!value.empty() && value.front() == ' ') value.remove_prefix(1);
+    return true;
+}
+
+/// 第一个空白之前的部分
+static std::string_view first_token(std::string_view s) {
+    std::size_t end = s.find_first_of(" \t");
+    return end == std::string_view::npos ? s : s.substr(0, end);
+}
+
+OntologyGraph OntologyGraph::load_obo(const std::string& path,
+                                      const std::vector<std::string>& relations) {
+    MappedFile file(path, MappedFile::Advice::Sequential);
+    std::string_view text = file.view();
+    std::unordered_set<std::string> wanted(relations.begin(), relations.end());
+    bool want_is_a = wanted.count("is_a") > 0;
+
+    Builder b;
+    bool in_term = false;
+    std::uint32_t current = NONE;
+    for (std::size_t pos = 0; pos < text.size();) {
+        std::size_t nl = text.find('\n', pos);
+        if (nl == std::string_view::npos) nl = text.size();
+        std::string_view line = text.substr(pos, nl - pos);
+        pos = nl + 1;
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+
+        if (!line.empty() && line.front() == '[') {
+            in_term = line == "[Term]";
+            current = NONE;
+            continue;
+        }
+        if (!in_term) continue;
+
+        std::string_view v;
+        if (obo_value(line, "id", v)) {
+            current = b.intern(first_token(v));
+        } else if (current == NONE) {
+            continue;  // id 行之前的内容
+        } else if (obo_value(line, "name", v)) {
+            b.names[current].assign(v.data(), v.size());
+        } else if (obo_value(line, "alt_id", v)) {
+            b.alt_ids.emplace_back(std::string(first_token(v)), current);
+        } else if (want_is_a && obo_value(line, "is_a", v)) {
+            std::string_view parent = first_token(v);
+            if (!parent.empty()) b.edges.emplace_back(current, b.intern(parent));
+        } else if (obo_value(line, "relationship", v)) {
+            // relationship: part_of GO:0005737 ! cytoplasm
+            std::string_view rel = first_token(v);
+            if (!wanted.count(std::string(rel))) continue;
+            v.remove_prefix(rel.size());
+            while (!v.empty() && v.front() == ' ') v.remove_prefix(1);
+            std::string_view parent = first_token(v);
+            if (!parent.empty()) b.edges.emplace_back(current, b.intern(parent));
+        }
+    }
+    return OntologyGraph(std::move(b));
+}
+
+OntologyGraph::OntologyGraph(Builder&& b)
+    : terms_(std::move(b.terms)), names_(std::move(b.names)), index_(std::move(b.index)) {
+    const std::uint32_t n = static_cast<std::uint32_t>(terms_.size());
+
+    // alt_id 与已有 term 同名时保留 term 本身
+    for (auto& [alt, main] : b.alt_ids) index_.emplace(std::move(alt), main);
+
+    // ---------- 父节点 CSR（去重） ----------
+    std::sort(b.edges.begin(), b.edges.end());
+    b.edges.erase(std::unique(b.edges.begin(), b.edges.end()), b.edges.end());
+    parent_off_.assign(n + 1, 0);
+    parents_.reserve(b.edges.size());
+    for (const auto& [child, parent] : b.edges) {
+        if (child == parent)
+            throw std::runtime_error("❌ Ontology graph has a cycle at " + terms_[child]);
+        parent_off_[child + 1]++;
+        parents_.push_back(parent);
+    }
+    for (std::uint32_t i = 0; i < n; ++i) parent_off_[i + 1] += parent_off_[i];
+
+    // ---------- 拓扑序（Kahn，父先于子） ----------
+    std::vector<std::uint32_t> child_off(n + 1, 0), children(parents_.size());
+    for (std::uint32_t p : parents_) child_off[p + 1]++;
+    for (std::uint32_t i = 0; i < n; ++i) child_off[i + 1] += child_off[i];
+    {
+        std::vector<std::uint32_t> fill(child_off.begin(), child_off.end() - 1);
+        for (std::uint32_t c = 0; c < n; ++c)
+            for (std::uint32_t k = parent_off_[c]; k < parent_off_[c + 1]; ++k)
+                children[fill[parents_[k]]++] = c;
+    }
+    std::vector<std::uint32_t> order, remaining(n);
+    order.reserve(n);
+    for (std::uint32_t i = 0; i < n; ++i) {
+        remaining[i] = parent_off_[i + 1] - parent_off_[i];
+        if (remaining[i] == 0) order.push_back(i);
+    }
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        std::uint32_t p = order[i];
+        for (std::uint32_t k = child_off[p]; k < child_off[p + 1]; ++k)
+            if (--remaining[children[k]] == 0) order.push_back(children[k]);
+    }
+    if (order.size() != n) {
+        for (std::uint32_t i = 0; i < n; ++i)
+            if (remaining[i] > 0)
+                throw std::runtime_error("❌ Ontology graph has a cycle through " + terms_[i]);
+    }
+
+    // ---------- 祖先闭包与深度 ----------
+    std::vector<std::vector<std::uint32_t>> closure(n);
+    depth_.assign(n, 0);
+    for (std::uint32_t t : order) {
+        auto& anc = closure[t];
+        for (std::uint32_t k = parent_off_[t]; k < parent_off_[t + 1]; ++k) {
+            std::uint32_t p = parents_[k];
+            anc.push_back(p);
+            anc.insert(anc.end(), closure[p].begin(), closure[p].end());
+            depth_[t] = std::max(depth_[t], depth_[p] + 1);
+        }
+        std::sort(anc.begin(), anc.end());
+        anc.erase(std::unique(anc.begin(), anc.end()), anc.end());
+    }
+    anc_off_.assign(n + 1, 0);
+    for (std::uint32_t t = 0; t < n; ++t)
+        anc_off_[t + 1] = anc_off_[t] + static_cast<std::uint32_t>(closure[t].size());
+    anc_.reserve(anc_off_[n]);
+    for (auto& anc : closure) {
+        anc_.insert(anc_.end(), anc.begin(), anc.end());
+        std::vector<std::uint32_t>().swap(anc);
+    }
+
+    // ---------- 后代闭包（祖先闭包的转置，按编号递增填充即有序） ----------
+    desc_off_.assign(n + 1, 0);
+    for (std::uint32_t a : anc_) desc_off_[a + 1]++;
+    for (std::uint32_t i = 0; i < n; ++i) desc_off_[i + 1] += desc_off_[i];
+    desc_.resize(anc_.size());
+    std::vector<std::uint32_t> fill(desc_off_.begin(), desc_off_.end() - 1);
+    for (std::uint32_t t = 0; t < n; ++t)
+        for (std::uint32_t k = anc_off_[t]; k < anc_off_[t + 1]; ++k)
+            desc_[fill[anc_[k]]++] = t;
+}
+
+std::uint32_t OntologyGraph::find(std::string_view term) const {
+    auto it = index_.find(std::string(term));
+    return it == index_.end() ? NONE : it->second;
+}
+
+std::string_view OntologyGraph::name(std::string_view term) const {
+    std::uint32_t t = find(term);
+    return t == NONE ? std::string_view() : std::string_view(names_[t]);
+}
+
+int OntologyGraph::depth(std::string_view term) const {
+    std::uint32_t t = find(term);
+    return t == NONE ? -1 : depth_[t];
+}
+
+bool OntologyGraph::has_ancestor(std::uint32_t term, std::uint32_t ancestor) const {
+    auto [begin, end] = ancestors_of(term);
+    return std::binary_search(begin, end, ancestor);
+}
+
+std::vector<bool> OntologyGraph::is_ancestor(const std::vector<std::string>& ancestors,
+                                             const std::vector<std::string>& terms) const {
+    if (ancestors.size() != terms.size())
+        throw std::invalid_argument("❌ ancestors and terms must have the same length");
+    std::vector<bool> out(terms.size(), false);
+    for (std::size_t i = 0; i < terms.size(); ++i) {
+        std::uint32_t a = find(ancestors[i]), t = find(terms[i]);
+        if (a != NONE && t != NONE) out[i] = has_ancestor(t, a);
+    }
+    return out;
+}
+
+std::vector<std::string> OntologyGraph::to_terms(const std::uint32_t* begin,
+                                                 const std::uint32_t* end,
+                                                 std::uint32_t self) const {
+    std::vector<std::string> out;
+    out.reserve(end - begin + (self != NONE));
+    // self 按编号顺序插入
+    for (const std::uint32_t* p = begin; p != end; ++p) {
+        if (self != NONE && self < *p) {
+            out.push_back(terms_[self]);
+            self = NONE;
+        }
+        out.push_back(terms_[*p]);
+    }
+    if (self != NONE) out.push_back(terms_[self]);
+    return out;
+}
+
+std::vector<std::vector<std::string>> OntologyGraph::ancestors(
+    const std::vector<std::string>& terms, bool include_self) const {
+    std::vector<std::vector<std::string>> out(terms.size());
+    for (std::size_t i = 0; i < terms.size(); ++i) {
+        std::uint32_t t = find(terms[i]);
+        if (t == NONE) continue;
+        auto [begin, end] = ancestors_of(t);
+        out[i] = to_terms(begin, end, include_self ? t : NONE);
+    }
+    return out;
+}
+
+std::vector<std::vector<std::string>> OntologyGraph::descendants(
+    const std::vector<std::string>& terms, bool include_self) const {
+    std::vector<std::vector<std::string>> out(terms.size());
+    for (std::size_t i = 0; i < terms.size(); ++i) {
+        std::uint32_t t = find(terms[i]);
+        if (t == NONE) continue;
+        auto [begin, end] = descendants_of(t);
+        out[i] = to_terms(begin, end, include_self ? t : NONE);
+    }
+    return out;
+}
+
+std::vector<std::vector<std::string>> OntologyGraph::lca(
+    const std::vector<std::string>& a, const std::vector<std::string>& b) const {
+    if (a.size() != b.size())
+        throw std::invalid_argument("❌ a and b must have the same length");
+    std::vector<std::vector<std::string>> out(a.size());
+    std::vector<std::uint32_t> sa, sb, common;
+    std::vector<char> covered;
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        std::uint32_t x = find(a[i]), y = find(b[i]);
+        if (x == NONE || y == NONE) continue;
+
+        // 含自身的祖先集合求交
+        auto with_self = [&](std::uint32_t t, std::vector<std::uint32_t>& s) {
+            auto [begin, end] = ancestors_of(t);
+            s.assign(begin, end);
+            s.insert(std::upper_bound(s.begin(), s.end(), t), t);
+        };
+        with_self(x, sa);
+        with_self(y, sb);
+        common.clear();
+        std::set_intersection(sa.begin(), sa.end(), sb.begin(), sb.end(),
+                              std::back_inserter(common));
+
+        // 是某个公共祖先的祖先的，都不是最低的
+        covered.assign(common.size(), 0);
+        for (std::uint32_t c : common) {
+            auto [begin, end] = ancestors_of(c);
+            for (const std::uint32_t* p = begin; p != end; ++p) {
+                auto it = std::lower_bound(common.begin(), common.end(), *p);
+                if (it != common.end() && *it == *p) covered[it - common.begin()] = 1;
+            }
+        }
+        std::vector<std::uint32_t> lowest;
+        for (std::size_t k = 0; k < common.size(); ++k)
+            if (!covered[k]) lowest.push_back(common[k]);
+        std::stable_sort(lowest.begin(), lowest.end(), [&](std::uint32_t l, std::uint32_t r) {
+            return depth_[l] > depth_[r];
+        });
+        for (std::uint32_t t : lowest) out[i].push_back(terms_[t]);
+    }
+    return out;
+}
+
+} // namespace pmcad
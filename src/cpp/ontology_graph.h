@@ -0,0 +1,103 @@
+// src/cpp/ontology_graph.h
+#ifndef PMC_ONTOLOGY_GRAPH_H
+#define PMC_ONTOLOGY_GRAPH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace pmcad {
+
+/**
+ * @class OntologyGraph
+ * @brief 本体 DAG（GO / DOID / CL 等）的只读图，祖先闭包在构建时预先计算。
+ *
+ * term 按首次出现的顺序编号；父节点以 CSR（offsets + 下标数组）存放。
+ * 构建时按拓扑序（父先于子）求出每个 term 全部祖先的有序列表，同样以 CSR 存放，
+ * 后代闭包由祖先闭包转置得到：
+ *   - is_ancestor：在有序祖先列表中二分查找，O(log k)；
+ *   - ancestors / descendants：直接取闭包切片；
+ *   - lca：两个 term 的祖先（含自身）的交集中，去掉是其它公共祖先之祖先的那些。
+ * 本体中每个 term 的祖先通常只有几十个，闭包大小约为 term 数 × 平均祖先数，
+ * 比 n × n 的祖先位图小几个数量级。
+ *
+ * alt_id 作为主 term 的别名，查询时等同于主 term。对于图中没有的 term，
+ * is_ancestor 返回 false，ancestors / descendants / lca 返回空列表。
+ * 构建完成后只读，可在多个线程中同时查询；图中有环时构建抛出 std::runtime_error。
+ */
+class OntologyGraph {
+public:
+    /// 由边表构建：parents[i] 是 children[i] 的父节点（如 is_a 边的 sub → obj）
+    static OntologyGraph from_edges(const std::vector<std::string>& children,
+                                    const std::vector<std::string>& parents);
+
+    /**
+     * @brief 读取 OBO 文件中的 [Term] 段（id / name / alt_id / is_a / relationship）
+     * @param relations 作为父子边的关系："is_a" 对应 is_a 行，其它名称对应
+     *        "relationship: <名称> <term>" 行（如 "part_of"）
+     */
+    static OntologyGraph load_obo(const std::string& path,
+                                  const std::vector<std::string>& relations = {"is_a"});
+
+    /// term 数（不含 alt_id 别名）
+    std::size_t size() const { return terms_.size(); }
+    /// 去重后的父子边数
+    std::size_t num_edges() const { return parents_.size(); }
+
+    bool contains(std::string_view term) const { return find(term) != NONE; }
+    /// OBO 中的 name（没有时为空）
+    std::string_view name(std::string_view term) const;
+    /// 到根的最长路径长度（根为 0），图中没有的 term 为 -1
+    int depth(std::string_view term) const;
+
+    /// 逐对判断 ancestors[i] 是否为 terms[i] 的真祖先（两个列表等长）
+    std::vector<bool> is_ancestor(const std::vector<std::string>& ancestors,
+                                  const std::vector<std::string>& terms) const;
+
+    /// 每个 term 的全部祖先（按编号排序；include_self 时包含自身）
+    std::vector<std::vector<std::string>> ancestors(const std::vector<std::string>& terms,
+                                                    bool include_self = false) const;
+
+    /// 每个 term 的全部后代
+    std::vector<std::vector<std::string>> descendants(const std::vector<std::string>& terms,
+                                                      bool include_self = false) const;
+
+    /// 逐对的最低公共祖先（DAG 中可能有多个，按 depth 从深到浅）
+    std::vector<std::vector<std::string>> lca(const std::vector<std::string>& a,
+                                              const std::vector<std::string>& b) const;
+
+private:
+    static constexpr std::uint32_t NONE = UINT32_MAX;
+
+    struct Builder;
+    explicit OntologyGraph(Builder&& b);
+
+    std::uint32_t find(std::string_view term) const;
+    /// ancestor 是否在 term 的祖先闭包中
+    bool has_ancestor(std::uint32_t term, std::uint32_t ancestor) const;
+    /// 编号的闭包切片 [begin, end)
+    std::pair<const std::uint32_t*, const std::uint32_t*> ancestors_of(std::uint32_t t) const {
+        return {anc_.data() + anc_off_[t], anc_.data() + anc_off_[t + 1]};
+    }
+    std::pair<const std::uint32_t*, const std::uint32_t*> descendants_of(std::uint32_t t) const {
+        return {desc_.data() + desc_off_[t], desc_.data() + desc_off_[t + 1]};
+    }
+    std::vector<std::string> to_terms(const std::uint32_t* begin, const std::uint32_t* end,
+                                      std::uint32_t self) const;
+
+    std::vector<std::string> terms_;
+    std::vector<std::string> names_;
+    std::unordered_map<std::string, std::uint32_t> index_;  // term 与 alt_id → 编号
+    std::vector<std::uint32_t> parent_off_, parents_;
+    std::vector<std::uint32_t> anc_off_, anc_;
+    std::vector<std::uint32_t> desc_off_, desc_;
+    std::vector<int> depth_;
+};
+
+} // namespace pmcad
+
+#endif // PMC_ONTOLOGY_GRAPH_H
@@ -0,0 +1,430 @@
+// src/cpp/parquet_writer.cpp
+#include "parquet_writer.h"
+#include "import_metrics.h"
+
+#include <zlib.h>
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace pmcad {
+
+// ---------- Parquet 枚举（parquet.thrift） ----------
+static const std::int32_t PQ_INT32 = 1;
+static const std::int32_t PQ_BYTE_ARRAY = 6;
+static const std::int32_t PQ_REQUIRED = 0;
+static const std::int32_t PQ_UTF8 = 0;
+
+static const std::int32_t ENC_PLAIN = 0;
+static const std::int32_t ENC_RLE = 3;
+static const std::int32_t ENC_RLE_DICTIONARY = 8;
+
+static const int PAGE_DATA = 0;
+static const int PAGE_DICTIONARY = 2;
+
+static const std::int32_t CODEC_UNCOMPRESSED = 0;
+static const std::int32_t CODEC_GZIP = 2;
+
+static const char PARQUET_MAGIC[] = "PAR1";
+
+/**
+ * @brief Thrift compact protocol 编码（只实现 Parquet 元数据用到的类型）。
+ *
+ * 字段头为 (字段号增量 << 4 | 类型)，增量超出 1..15 时改写完整字段号；
+ * 整数为 zigzag varint；每个 struct 以 0 结尾。
+ */
+class ThriftWriter {
+public:
+    explicit ThriftWriter(std::string& out) : out_(out) { last_.push_back(0); }
+
+    void i32(int id, std::int32_t v) { field(CT_I32, id); varint(zigzag(v)); }
+    void i64(int id, std::int64_t v) { field(CT_I64, id); varint(zigzag(v)); }
+
+    void binary(int id, std::string_view v) {
+        field(CT_BINARY, id);
+        raw_binary(v);
+    }
+
+    /// 开始一个 struct 类型的字段
+    void begin_struct(int id) {
+        field(CT_STRUCT, id);
+        begin_element();
+    }
+
+    /// 开始 list 中的一个 struct 元素（没有字段头）
+    void begin_element() { last_.push_back(0); }
+
+    void end_struct() {
+        out_ += '\0';
+        last_.pop_back();
+    }
+
+    void begin_list(int id, int elem_type, std::size_t size) {
+        field(CT_LIST, id);
+        if (size < 15) {
+            out_ += static_cast<char>((size << 4) | elem_type);
+        } else {
+            out_ += static_cast<char>(0xF0 | elem_type);
+            varint(size);
+        }
+    }
+
+    void list_i32(std::int32_t v) { varint(zigzag(v)); }
+    void list_binary(std::string_view v) { raw_binary(v); }
+
+    /// 结束最外层的 struct
+    void finish() { out_ += '\0'; }
+
+    static const int CT_I32 = 5;
+    static const int CT_I64 = 6;
+    static const int CT_BINARY = 8;
+    static const int CT_LIST = 9;
+    static const int CT_STRUCT = 12;
+
+private:
+    static std::uint64_t zigzag(std::int64_t v) {
+        return (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63);
+    }
+
+    void varint(std::uint64_t v) {
+        while (v >= 0x80) {
+            out_ += static_cast<char>((v & 0x7F) | 0x80);
+            v >>= 7;
+        }
+        out_ += static_cast<char>(v);
+    }
+
+    void field(int type, int id) {
+        int delta = id - last_.back();
+        if (delta > 0 && delta <= 15) {
+            out_ += static_cast<char>((delta << 4) | type);
+        } else {
+            out_ += static_cast<char>(type);
+            varint(zigzag(id));
+        }
+        last_.back() = id;
+    }
+
+    void raw_binary(std::string_view v) {
+        varint(v.size());
+        out_.append(v.data(), v.size());
+    }
+
+    std::string& out_;
+    std::vector<int> last_;  ///< 每层 struct 上一个字段号
+};
+
+static void put_u32_le(std::string& out, std::uint32_t v) {
+    char b[4] = {static_cast<char>(v), static_cast<char>(v >> 8),
+                 static_cast<char>(v >> 16), static_cast<char>(v >> 24)};
+    out.append(b, 4);
+}
+
+/// 表示 0..max_value 所需的位数（至少 1 位）
+static int bit_width(std::uint32_t max_value) {
+    int w = 1;
+    while (w < 32 && (max_value >> w)) ++w;
+    return w;
+}
+
+static std::size_t run_length(const std::vector<std::uint32_t>& v, std::size_t i) {
+    std::size_t j = i + 1;
+    while (j < v.size() && v[j] == v[i]) ++j;
+    return j - i;
+}
+
+/**
+ * @brief RLE / bit-packing 混合编码（RLE_DICTIONARY 数据页的字典下标）。
+ *
+ * 连续 8 个以上相同的下标写成 RLE 段，其余按 8 个一组 bit-pack；
+ * 最后一组不足 8 个时补 0（读取端按页头的 num_values 截断）。
+ */
+static void encode_rle_hybrid(const std::vector<std::uint32_t>& values, int width,
+                              std::string& out) {
+    auto varint = [&](std::uint64_t v) {
+        while (v >= 0x80) {
+            out += static_cast<char>((v & 0x7F) | 0x80);
+            v >>= 7;
+        }
+        out += static_cast<char>(v);
+    };
+    const int value_bytes = (width + 7) / 8;
+
+    std::size_t i = 0, n = values.size();
+    while (i < n) {
+        std::size_t run = run_length(values, i);
+        if (run >= 8) {
+            varint(static_cast<std::uint64_t>(run) << 1);
+            for (int b = 0; b < value_bytes; ++b)
+                out += static_cast<char>(values[i] >> (8 * b));
+            i += run;
+            continue;
+        }
+
+        // 一直 bit-pack 到下一个 8 的倍数位置开始出现长 RLE 段为止
+        std::size_t start = i, groups = 0;
+        do {
+            i += 8;
+            ++groups;
+        } while (i < n && run_length(values, i) < 8);
+        varint((static_cast<std::uint64_t>(groups) << 1) | 1);
+
+        std::uint64_t acc = 0;
+        int bits = 0;
+        for (std::size_t k = start; k < start + groups * 8; ++k) {
+            acc |= static_cast<std::uint64_t>(k < n ? values[k] : 0) << bits;
+            bits += width;
+            while (bits >= 8) {
+                out += static_cast<char>(acc);
+                acc >>= 8;
+                bits -= 8;
+            }
+        }
+        // groups * 8 * width 必为 8 的倍数，不会有剩余位
+    }
+}
+
+static void gzip_compress(const std::string& in, std::string& out) {
+    z_stream zs{};
+    // windowBits + 16：gzip 封装（Parquet 的 GZIP codec 即 RFC 1952 格式）
+    if (deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        throw std::runtime_error("deflateInit2 failed");
+    out.resize(deflateBound(&zs, in.size()) + 32);
+    zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in.data()));
+    zs.avail_in = static_cast<uInt>(in.size());
+    zs.next_out = reinterpret_cast<Bytef*>(&out[0]);
+    zs.avail_out = static_cast<uInt>(out.size());
+    int ret = deflate(&zs, Z_FINISH);
+    out.resize(zs.total_out);
+    deflateEnd(&zs);
+    if (ret != Z_STREAM_END) throw std::runtime_error("deflate failed");
+}
+
+ParquetWriter::Codec ParquetWriter::parse_codec(const std::string& name) {
+    if (name.empty() || name == "none" || name == "uncompressed") return Codec::UNCOMPRESSED;
+    if (name == "gzip") return Codec::GZIP;
+    throw std::invalid_argument("Unknown parquet compression: " + name);
+}
+
+ParquetWriter::ParquetWriter(const std::string& path, std::vector<Column> columns,
+                             Codec codec, std::size_t row_group_rows,
+                             std::size_t row_group_bytes)
+    : path_(path),
+      out_(path, std::ios::binary | std::ios::trunc),
+      columns_(std::move(columns)),
+      buffers_(columns_.size()),
+      codec_(codec),
+      row_group_rows_(std::max<std::size_t>(row_group_rows, 1)),
+      row_group_bytes_(std::min<std::size_t>(row_group_bytes, 1u << 30)) {
+    if (!out_.is_open()) throw std::runtime_error("Cannot open file: " + path);
+    if (columns_.empty()) throw std::invalid_argument("Parquet file needs at least one column");
+    write_bytes(std::string(PARQUET_MAGIC, 4));
+}
+
+ParquetWriter::ColumnBuffer& ParquetWriter::next_column(Type type) {
+    if (col_ >= columns_.size() || columns_[col_].type != type)
+        throw std::logic_error("Parquet value does not match column " +
+                               (col_ < columns_.size() ? columns_[col_].name : std::string("<end>")));
+    return buffers_[col_++];
+}
+
+void ParquetWriter::text(std::string_view value) {
+    ColumnBuffer& buf = next_column(Type::STRING);
+    put_u32_le(buf.plain, static_cast<std::uint32_t>(value.size()));
+    buf.offsets.push_back(static_cast<std::uint32_t>(buf.plain.size()));
+    buf.plain.append(value.data(), value.size());
+    group_bytes_ += value.size() + 4;
+}
+
+void ParquetWriter::int4(std::int32_t value) {
+    put_u32_le(next_column(Type::INT32).plain, static_cast<std::uint32_t>(value));
+    group_bytes_ += 4;
+}
+
+void ParquetWriter::end_row() {
+    if (col_ != columns_.size())
+        throw std::logic_error("Parquet row ended before column " + columns_[col_].name);
+    col_ = 0;
+    if (++group_rows_ >= row_group_rows_ || group_bytes_ >= row_group_bytes_)
+        flush_row_group();
+}
+
+void ParquetWriter::write_bytes(const std::string& data) {
+    out_.write(data.data(), static_cast<std::streamsize>(data.size()));
+    if (!out_) throw std::runtime_error("Failed to write file: " + path_);
+    offset_ += static_cast<std::int64_t>(data.size());
+}
+
+void ParquetWriter::write_page(int page_type, std::int32_t num_values, int encoding,
+                               const std::string& body, ChunkMeta& meta) {
+    const std::string* payload = &body;
+    if (codec_ == Codec::GZIP) {
+        gzip_compress(body, scratch_);
+        payload = &scratch_;
+    }
+
+    std::string header;
+    ThriftWriter t(header);
+    t.i32(1, page_type);
+    t.i32(2, static_cast<std::int32_t>(body.size()));
+    t.i32(3, static_cast<std::int32_t>(payload->size()));
+    if (page_type == PAGE_DATA) {
+        t.begin_struct(5);
+        t.i32(1, num_values);
+        t.i32(2, encoding);
+        t.i32(3, ENC_RLE);  // 定义 / 重复级别的编码（REQUIRED 扁平列不写级别数据）
+        t.i32(4, ENC_RLE);
+        t.end_struct();
+    } else {
+        t.begin_struct(7);
+        t.i32(1, num_values);
+        t.i32(2, encoding);
+        t.end_struct();
+    }
+    t.finish();
+
+    if (page_type == PAGE_DATA) meta.data_page_offset = offset_;
+    else meta.dictionary_page_offset = offset_;
+    meta.uncompressed_size += static_cast<std::int64_t>(header.size() + body.size());
+    meta.compressed_size += static_cast<std::int64_t>(header.size() + payload->size());
+    write_bytes(header);
+    write_bytes(*payload);
+}
+
+void ParquetWriter::write_chunk(const Column& column, const ColumnBuffer& buf,
+                                ChunkMeta& meta) {
+    auto n = static_cast<std::int32_t>(group_rows_);
+    meta.num_values = n;
+
+    if (column.type == Type::STRING && column.dictionary) {
+        // 字典超过原始数据的一半时放弃，按 PLAIN 写出
+        std::unordered_map<std::string_view, std::uint32_t> ids;
+        std::vector<std::uint32_t> indices;
+        indices.reserve(buf.offsets.size());
+        std::string dict;
+        const std::size_t limit = buf.plain.size() / 2;
+        bool use_dict = true;
+        for (std::size_t i = 0; i < buf.offsets.size(); ++i) {
+            std::size_t end = i + 1 < buf.offsets.size() ? buf.offsets[i + 1] - 4 : buf.plain.size();
+            std::string_view v(buf.plain.data() + buf.offsets[i], end - buf.offsets[i]);
+            auto [it, inserted] = ids.emplace(v, static_cast<std::uint32_t>(ids.size()));
+            if (inserted) {
+                put_u32_le(dict, static_cast<std::uint32_t>(v.size()));
+                dict.append(v.data(), v.size());
+                if (dict.size() > limit) {
+                    use_dict = false;
+                    break;
+                }
+            }
+            indices.push_back(it->second);
+        }
+
+        if (use_dict) {
+            write_page(PAGE_DICTIONARY, static_cast<std::int32_t>(ids.size()), ENC_PLAIN, dict, meta);
+            int width = bit_width(ids.empty() ? 0 : static_cast<std::uint32_t>(ids.size() - 1));
+            std::string body(1, static_cast<char>(width));
+            encode_rle_hybrid(indices, width, body);
+            write_page(PAGE_DATA, n, ENC_RLE_DICTIONARY, body, meta);
+            meta.encodings = {ENC_PLAIN, ENC_RLE, ENC_RLE_DICTIONARY};
+            return;
+        }
+    }
+
+    write_page(PAGE_DATA, n, ENC_PLAIN, buf.plain, meta);
+    meta.encodings = {ENC_PLAIN, ENC_RLE};
+}
+
+void ParquetWriter::flush_row_group() {
+    if (group_rows_ == 0) return;
+    auto start = std::chrono::steady_clock::now();
+
+    RowGroupMeta group;
+    group.num_rows = static_cast<std::int64_t>(group_rows_);
+    group.columns.resize(columns_.size());
+    for (std::size_t c = 0; c < columns_.size(); ++c) {
+        write_chunk(columns_[c], buffers_[c], group.columns[c]);
+        group.total_byte_size += group.columns[c].uncompressed_size;
+        // 保留容量，下一个行组不再重新分配
+        buffers_[c].plain.clear();
+        buffers_[c].offsets.clear();
+    }
+    row_groups_.push_back(std::move(group));
+
+    rows_ += group_rows_;
+    group_rows_ = 0;
+    group_bytes_ = 0;
+    if (stats_) stats_->add_flush(std::chrono::steady_clock::now() - start);
+}
+
+void ParquetWriter::close() {
+    if (closed_) return;
+    if (col_ != 0) throw std::logic_error("Parquet file closed in the middle of a row");
+    flush_row_group();
+
+    // ---------- FileMetaData ----------
+    std::string meta;
+    ThriftWriter t(meta);
+    t.i32(1, 1);  // version
+
+    t.begin_list(2, ThriftWriter::CT_STRUCT, columns_.size() + 1);
+    t.begin_element();
+    t.binary(4, "schema");
+    t.i32(5, static_cast<std::int32_t>(columns_.size()));
+    t.end_struct();
+    for (const auto& c : columns_) {
+        t.begin_element();
+        t.i32(1, c.type == Type::INT32 ? PQ_INT32 : PQ_BYTE_ARRAY);
+        t.i32(3, PQ_REQUIRED);
+        t.binary(4, c.name);
+        if (c.type == Type::STRING) t.i32(6, PQ_UTF8);
+        t.end_struct();
+    }
+
+    t.i64(3, static_cast<std::int64_t>(rows_));
+
+    t.begin_list(4, ThriftWriter::CT_STRUCT, row_groups_.size());
+    for (const auto& g : row_groups_) {
+        t.begin_element();
+        t.begin_list(1, ThriftWriter::CT_STRUCT, g.columns.size());
+        for (std::size_t c = 0; c < g.columns.size(); ++c) {
+            const ChunkMeta& m = g.columns[c];
+            std::int64_t first = m.dictionary_page_offset >= 0 ? m.dictionary_page_offset
+                                                                 : m.data_page_offset;
+            t.begin_element();
+            t.i64(2, first);  // file_offset
+            t.begin_struct(3);
+            t.i32(1, columns_[c].type == Type::INT32 ? PQ_INT32 : PQ_BYTE_ARRAY);
+            t.begin_list(2, ThriftWriter::CT_I32, m.encodings.size());
+            for (auto e : m.encodings) t.list_i32(e);
+            t.begin_list(3, ThriftWriter::CT_BINARY, 1);
+            t.list_binary(columns_[c].name);
+            t.i32(4, codec_ == Codec::GZIP ? CODEC_GZIP : CODEC_UNCOMPRESSED);
+            t.i64(5, m.num_values);
+            t.i64(6, m.uncompressed_size);
+            t.i64(7, m.compressed_size);
+            t.i64(9, m.data_page_offset);
+            if (m.dictionary_page_offset >= 0) t.i64(11, m.dictionary_page_offset);
+            t.end_struct();
+            t.end_struct();
+        }
+        t.i64(2, g.total_byte_size);
+        t.i64(3, g.num_rows);
+        t.end_struct();
+    }
+
+    t.binary(6, "pmcad");  // created_by
+    t.finish();
+
+    write_bytes(meta);
+    std::string tail;
+    put_u32_le(tail, static_cast<std::uint32_t>(meta.size()));
+    tail.append(PARQUET_MAGIC, 4);
+    write_bytes(tail);
+
+    out_.close();
+    if (!out_) throw std::runtime_error("Failed to write file: " + path_);
+    closed_ = true;
+}
+
+} // namespace pmcad
@@ -0,0 +1,123 @@
+// src/cpp/parquet_writer.h
+#ifndef PMC_PARQUET_WRITER_H
+#define PMC_PARQUET_WRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace pmcad {
+
+class CopyStats;
+
+/**
+ * @class ParquetWriter
+ * @brief 不依赖 Arrow / parquet-cpp 的最小 Parquet 文件写入器。
+ *
+ * 只支持 REQUIRED（非空）的扁平列：INT32 与 BYTE_ARRAY (UTF8)。
+ * 行数据按列缓存，攒够 row_group_rows 行或 row_group_bytes 字节后写出一个行组，
+ * 每个行组的每一列为一个 v1 数据页；close() 时写出 footer（FileMetaData）。
+ *
+ * dictionary = true 的字符串列在写出行组时做字典编码（字典页 + RLE_DICTIONARY 数据页），
+ * 适合 db_name / feature_type / evidence 这类重复度高的列；
+ * 若该行组的字典超过原始数据的一半（几乎不重复），该列退回 PLAIN 编码。
+ *
+ * 用法与 PgBinaryCopy 相同，按列顺序写值：
+ *   ParquetWriter out("ft.parquet", {{"accession", ParquetWriter::Type::STRING},
+ *                                    {"start_pos", ParquetWriter::Type::INT32}});
+ *   out.text("P12345"); out.int4(1); out.end_row();
+ *   out.close();
+ */
+class ParquetWriter {
+public:
+    enum class Type { INT32, STRING };
+    enum class Codec { UNCOMPRESSED, GZIP };
+
+    struct Column {
+        std::string name;
+        Type type;
+        bool dictionary = false;  ///< 是否尝试字典编码（仅 STRING 列）
+    };
+
+    ParquetWriter(const std::string& path, std::vector<Column> columns,
+                  Codec codec = Codec::UNCOMPRESSED,
+                  std::size_t row_group_rows = 1 << 20,
+                  std::size_t row_group_bytes = 128 << 20);
+
+    /// 未 close() 时不写 footer，留下的文件不完整（异常退出）
+    ~ParquetWriter() = default;
+
+    ParquetWriter(const ParquetWriter&) = delete;
+    ParquetWriter& operator=(const ParquetWriter&) = delete;
+
+    void text(std::string_view value);
+    void int4(std::int32_t value);
+    void end_row();
+
+    /// 写出剩余的行组和 footer 并关闭文件
+    void close();
+
+    /// 已写入的行数（含尚未写出的行组）
+    std::size_t rows() const { return rows_ + group_rows_; }
+
+    /// 记录每个行组的写出耗时（可为 nullptr，不取得所有权）
+    void set_stats(CopyStats* stats) { stats_ = stats; }
+
+    /// 解析 "none" / "uncompressed" / "gzip"
+    static Codec parse_codec(const std::string& name);
+
+private:
+    /// 一列在当前行组中的数据（PLAIN 编码：INT32 为 4 字节小端，字符串为 4 字节长度 + 内容）
+    struct ColumnBuffer {
+        std::string plain;
+        std::vector<std::uint32_t> offsets;  ///< 字符串列：每个值内容在 plain 中的位置
+    };
+
+    /// 一个列块在 footer 中的元数据
+    struct ChunkMeta {
+        std::vector<std::int32_t> encodings;
+        std::int64_t num_values = 0;
+        std::int64_t uncompressed_size = 0;
+        std::int64_t compressed_size = 0;
+        std::int64_t data_page_offset = 0;
+        std::int64_t dictionary_page_offset = -1;
+    };
+
+    struct RowGroupMeta {
+        std::vector<ChunkMeta> columns;
+        std::int64_t num_rows = 0;
+        std::int64_t total_byte_size = 0;
+    };
+
+    ColumnBuffer& next_column(Type type);
+    void flush_row_group();
+    void write_chunk(const Column& column, const ColumnBuffer& buf, ChunkMeta& meta);
+    void write_page(int page_type, std::int32_t num_values, int encoding,
+                    const std::string& body, ChunkMeta& meta);
+    void write_bytes(const std::string& data);
+
+    std::string path_;
+    std::ofstream out_;
+    std::vector<Column> columns_;
+    std::vector<ColumnBuffer> buffers_;
+    Codec codec_;
+    std::size_t row_group_rows_;
+    std::size_t row_group_bytes_;
+
+    std::size_t col_ = 0;          ///< 当前行中下一个要写的列
+    std::size_t group_rows_ = 0;   ///< 当前行组已缓存的行数
+    std::size_t group_bytes_ = 0;  ///< 当前行组已缓存的字节数
+    std::size_t rows_ = 0;         ///< 已写出的行数
+    std::int64_t offset_ = 0;      ///< 文件当前写入位置
+    std::vector<RowGroupMeta> row_groups_;
+    std::string scratch_;          ///< 压缩输出缓冲（复用）
+    bool closed_ = false;
+    CopyStats* stats_ = nullptr;
+};
+
+} // namespace pmcad
+
+#endif // PMC_PARQUET_WRITER_H
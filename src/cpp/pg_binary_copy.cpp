@@ -0,0 +1,165 @@
+// src/cpp/pg_binary_copy.cpp
+#include "pg_binary_copy.h"
+#include "import_metrics.h"
+
+#include <libpq-fe.h>
+#include <chrono>
+#include <stdexcept>
+
+namespace pmcad {
+
+// 二进制 COPY 文件头：签名 + flags + 扩展区长度
+static const char COPY_SIGNATURE[] = "PGCOPY\n\377\r\n\0";
+
+PgBinaryCopy::PgBinaryCopy(const std::string& conn_str, std::size_t flush_bytes)
+    : flush_bytes_(flush_bytes) {
+    conn_ = PQconnectdb(conn_str.c_str());
+    if (!conn_ || PQstatus(conn_) != CONNECTION_OK) {
+        std::string msg = conn_ ? PQerrorMessage(conn_) : "out of memory";
+        if (conn_) PQfinish(conn_);
+        conn_ = nullptr;
+        throw std::runtime_error("❌ Cannot connect to PostgreSQL: " + msg);
+    }
+    buffer_.reserve(flush_bytes_ + (64 << 10));
+}
+
+PgBinaryCopy::~PgBinaryCopy() {
+    if (!conn_) return;
+    if (in_copy_) {
+        // 异常退出：放弃本批次
+        PQputCopyEnd(conn_, "aborted by client");
+        while (PGresult* r = PQgetResult(conn_)) PQclear(r);
+        PQclear(PQexec(conn_, "ROLLBACK"));
+    }
+    PQfinish(conn_);
+}
+
+void PgBinaryCopy::fail(const std::string& what) {
+    throw std::runtime_error("❌ " + what + ": " + PQerrorMessage(conn_));
+}
+
+void PgBinaryCopy::exec(const std::string& sql) {
+    PGresult* r = PQexec(conn_, sql.c_str());
+    ExecStatusType st = PQresultStatus(r);
+    PQclear(r);
+    if (st != PGRES_COMMAND_OK && st != PGRES_TUPLES_OK)
+        fail("SQL failed (" + sql + ")");
+}
+
+std::string PgBinaryCopy::quote_ident(const std::string& name) const {
+    char* q = PQescapeIdentifier(conn_, name.data(), name.size());
+    if (!q) throw std::runtime_error("❌ Cannot quote identifier: " + name);
+    std::string out(q);
+    PQfreemem(q);
+    return out;
+}
+
+std::string PgBinaryCopy::quote_literal(const std::string& value) const {
+    char* q = PQescapeLiteral(conn_, value.data(), value.size());
+    if (!q) throw std::runtime_error("❌ Cannot quote literal: " + value);
+    std::string out(q);
+    PQfreemem(q);
+    return out;
+}
+
+void PgBinaryCopy::begin(const std::string& table,
+                         const std::vector<std::string>& columns) {
+    std::string cols;
+    for (const auto& c : columns) {
+        if (!cols.empty()) cols += ", ";
+        cols += quote_ident(c);
+    }
+
+    exec("BEGIN");
+    std::string sql = "COPY " + quote_ident(table) + " (" + cols +
+                      ") FROM STDIN (FORMAT binary)";
+    PGresult* r = PQexec(conn_, sql.c_str());
+    ExecStatusType st = PQresultStatus(r);
+    PQclear(r);
+    if (st != PGRES_COPY_IN) fail("COPY failed (" + sql + ")");
+    in_copy_ = true;
+
+    buffer_.clear();
+    buffer_.append(COPY_SIGNATURE, sizeof(COPY_SIGNATURE) - 1);
+    put_u32(0); // flags
+    put_u32(0); // header extension length
+}
+
+void PgBinaryCopy::put_u16(std::uint16_t v) {
+    char b[2] = {static_cast<char>(v >> 8), static_cast<char>(v)};
+    buffer_.append(b, 2);
+}
+
+void PgBinaryCopy::put_u32(std::uint32_t v) {
+    char b[4] = {static_cast<char>(v >> 24), static_cast<char>(v >> 16),
+                 static_cast<char>(v >> 8), static_cast<char>(v)};
+    buffer_.append(b, 4);
+}
+
+void PgBinaryCopy::start_row(std::int16_t num_fields) {
+    put_u16(static_cast<std::uint16_t>(num_fields));
+}
+
+void PgBinaryCopy::text(std::string_view value) {
+    put_u32(static_cast<std::uint32_t>(value.size()));
+    buffer_.append(value.data(), value.size());
+}
+
+void PgBinaryCopy::int4(std::int32_t value) {
+    put_u32(4);
+    put_u32(static_cast<std::uint32_t>(value));
+}
+
+void PgBinaryCopy::int8(std::int64_t value) {
+    put_u32(8);
+    put_u32(static_cast<std::uint32_t>(static_cast<std::uint64_t>(value) >> 32));
+    put_u32(static_cast<std::uint32_t>(value));
+}
+
+void PgBinaryCopy::null() {
+    put_u32(0xFFFFFFFFu); // -1
+}
+
+void PgBinaryCopy::end_row() {
+    if (buffer_.size() >= flush_bytes_) flush();
+}
+
+void PgBinaryCopy::flush() {
+    if (buffer_.empty()) return;
+    auto start = std::chrono::steady_clock::now();
+    if (PQputCopyData(conn_, buffer_.data(), static_cast<int>(buffer_.size())) != 1)
+        fail("PQputCopyData failed");
+    if (stats_) stats_->add_flush(std::chrono::steady_clock::now() - start);
+    buffer_.clear();
+}
+
+void PgBinaryCopy::commit() {
+    if (!in_copy_) return;
+    end_copy();
+    exec("COMMIT");
+}
+
+void PgBinaryCopy::end_copy() {
+    if (!in_copy_) return;
+    put_u16(0xFFFF); // 文件尾：字段数 -1
+    flush();
+
+    in_copy_ = false;
+    if (PQputCopyEnd(conn_, nullptr) != 1) fail("PQputCopyEnd failed");
+
+    bool ok = true;
+    std::string err;
+    while (PGresult* r = PQgetResult(conn_)) {
+        if (PQresultStatus(r) != PGRES_COMMAND_OK) {
+            ok = false;
+            err = PQresultErrorMessage(r);
+        }
+        PQclear(r);
+    }
+    if (!ok) {
+        PQclear(PQexec(conn_, "ROLLBACK"));
+        throw std::runtime_error("❌ Binary COPY failed: " + err);
+    }
+}
+
+} // namespace pmcad
@@ -0,0 +1,87 @@
+// src/cpp/pg_binary_copy.h
+#ifndef PMC_PG_BINARY_COPY_H
+#define PMC_PG_BINARY_COPY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct pg_conn;
+
+namespace pmcad {
+
+class CopyStats;
+
+/**
+ * @class PgBinaryCopy
+ * @brief 基于 libpq 的 COPY ... FROM STDIN (FORMAT binary) 写入器。
+ *
+ * libpqxx 的 stream_to 只支持文本 COPY，整数需要先格式化为文本再由服务端解析；
+ * 二进制格式直接发送网络字节序的 int4，服务端无需再做文本解析。
+ *
+ * 行数据写入一块预分配、可复用的缓冲区，累积到 flush_bytes 后
+ * 一次 PQputCopyData，缓冲区容量保留，稳定后不再分配内存。
+ *
+ * 用法：
+ *   PgBinaryCopy copy(conn_str);
+ *   copy.begin("table", {"a", "b"});
+ *   copy.start_row(2); copy.text("x"); copy.int4(1); copy.end_row();
+ *   copy.commit();
+ */
+class PgBinaryCopy {
+public:
+    explicit PgBinaryCopy(const std::string& conn_str,
+                          std::size_t flush_bytes = 1 << 20);
+    ~PgBinaryCopy();
+
+    PgBinaryCopy(const PgBinaryCopy&) = delete;
+    PgBinaryCopy& operator=(const PgBinaryCopy&) = delete;
+
+    /// 执行一条普通 SQL（不可在 COPY 进行中调用）
+    void exec(const std::string& sql);
+
+    /// 开启事务并进入 COPY 状态，发送二进制 COPY 文件头
+    void begin(const std::string& table, const std::vector<std::string>& columns);
+
+    void start_row(std::int16_t num_fields);
+    void text(std::string_view value);
+    void int4(std::int32_t value);
+    void int8(std::int64_t value);
+    void null();
+    void end_row();
+
+    /// 发送结束标记，结束 COPY 并提交事务
+    void commit();
+
+    /// 发送结束标记并结束 COPY，事务保持打开（之后可继续 exec，再 exec("COMMIT")）
+    void end_copy();
+
+    bool in_copy() const { return in_copy_; }
+
+    /// 记录每次 PQputCopyData 的耗时（可为 nullptr，不取得所有权）
+    void set_stats(CopyStats* stats) { stats_ = stats; }
+
+    /// 按 PostgreSQL 规则为标识符加引号
+    std::string quote_ident(const std::string& name) const;
+
+    /// 按 PostgreSQL 规则转义为字符串字面量（含引号）
+    std::string quote_literal(const std::string& value) const;
+
+private:
+    void put_u16(std::uint16_t v);
+    void put_u32(std::uint32_t v);
+    void flush();
+    [[noreturn]] void fail(const std::string& what);
+
+    pg_conn* conn_ = nullptr;
+    std::string buffer_;
+    std::size_t flush_bytes_;
+    bool in_copy_ = false;
+    CopyStats* stats_ = nullptr;
+};
+
+} // namespace pmcad
+
+#endif // PMC_PG_BINARY_COPY_H
@@ -1,12 +1,27 @@
 #include "reader.h"
-
+#include "mapped_file.h"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
 #include <filesystem>
 #include <fstream>
+#include <functional>
+#include <iomanip>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
 #include <pqxx/pqxx>
 #include <regex>
 #include <sstream>
 #include <stdexcept>
+#include <string_view>
+#include <thread>
 
 namespace fs = std::filesystem;
 
@@ -65,28 +80,68 @@ std::vector<std::vector<std::string> > Reader::read_tsv_file(
 }
 
 std::vector<std::vector<std::string> > Reader::read_multi_tsv(
-    const std::vector<std::string>& filelist) {
-    std::vector<std::vector<std::string> > all_data;
-    bool first_file = true; // 标记是否是第一个文件
+    const std::vector<std::string>& filelist, unsigned num_threads) {
+    if (num_threads == 0) num_threads = std::thread::hardware_concurrency();
+    num_threads = std::max(1u, std::min<unsigned>(
+        num_threads, static_cast<unsigned>(filelist.size())));
+
+    // 每个文件一个预分配的槽位，各线程并发解析，互不加锁
+    struct FileChunk {
+        std::vector<std::vector<std::string> > rows;
+        std::string error;
+        bool ok = false;
+    };
+    std::vector<FileChunk> chunks(filelist.size());
+
+    std::atomic<size_t> next_file{0};
+    auto worker = [&] {
+        for (size_t i; (i = next_file++) < filelist.size();) {
+            try {
+                chunks[i].rows = read_tsv_file(filelist[i]);
+                chunks[i].ok = true;
+            } catch (const std::exception& e) {
+                chunks[i].error = e.what();
+            }
+        }
+    };
+
+    if (num_threads <= 1) {
+        worker();
+    } else {
+        std::vector<std::thread> threads;
+        for (unsigned t = 0; t < num_threads; ++t) threads.emplace_back(worker);
+        for (auto& t : threads) t.join();
+    }
 
-    for (const auto& file : filelist) {
-        try {
-            auto data = read_tsv_file(file);
+    // ---------- 按文件顺序合并：只保留第一个成功读取文件的表头 ----------
+    size_t total = 0;
+    bool first_file = true;
+    for (const auto& c : chunks) {
+        if (!c.ok) continue;
+        total += first_file ? c.rows.size()
+                            : (c.rows.empty() ? 0 : c.rows.size() - 1);
+        first_file = false;
+    }
 
-            if (first_file) {
-                // 如果是第一个文件，保存表头并合并所有数据
-                all_data = data;
-                first_file =
-                    false; // 设置为 false，以后不再重复添加表头
-            } else {
-                // 如果不是第一个文件，从第二行开始添加数据（跳过表头）
-                all_data.insert(all_data.end(),
-                                data.begin() + 1, data.end());
-            }
-        } catch (const std::exception& e) {
-            std::cerr << "Warning: Failed to read " << file
-                      << ": " << e.what() << std::endl;
+    std::vector<std::vector<std::string> > all_data;
+    all_data.reserve(total);
+    first_file = true; // 标记是否是第一个文件
+
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        auto& c = chunks[i];
+        if (!c.ok) {
+            std::cerr << "Warning: Failed to read " << filelist[i]
+                      << ": " << c.error << std::endl;
+            continue;
         }
+
+        // 第一个文件保留表头，之后的文件跳过表头；逐行移动而非拷贝
+        auto begin = c.rows.begin();
+        if (!first_file && begin != c.rows.end()) ++begin;
+        first_file = false;
+        all_data.insert(all_data.end(), std::make_move_iterator(begin),
+                        std::make_move_iterator(c.rows.end()));
+        c.rows = {}; // 尽早释放该文件的行容器
     }
 
     return all_data; // 返回合并后的数据
@@ -135,6 +190,180 @@ std::vector<std::vector<std::string> > Reader::read_tsv_safe(
     return data;
 }
 
+// 按 read_tsv_file 的规则逐个切分字段，对每个字段调用 fn(列号, 值)，返回字段数
+template <class Fn>
+static size_t for_each_tsv_field(std::string_view line, Fn&& fn) {
+    size_t col = 0, pos = 0;
+    while (pos < line.size()) {
+        size_t tab = line.find('\t', pos);
+        if (tab == std::string_view::npos) tab = line.size();
+        fn(col++, line.substr(pos, tab - pos));
+        pos = tab + 1;
+    }
+    return col;
+}
+
+TsvTable Reader::read_tsv_columns(const std::string& filename) {
+    MappedFile file(filename, MappedFile::Advice::Sequential);
+    std::string_view text = file.view();
+    TsvTable table;
+
+    // 预估行数用于预分配（空行会使估计偏大，无妨）
+    size_t est_rows = static_cast<size_t>(
+        std::count(text.begin(), text.end(), '\n')) + 1;
+
+    bool header_line = true;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t nl = text.find('\n', pos);
+        if (nl == std::string_view::npos) nl = text.size();
+        std::string_view line = text.substr(pos, nl - pos);
+        pos = nl + 1;
+        if (line.empty()) continue; // 跳过空行
+
+        if (header_line) {
+            header_line = false;
+            for_each_tsv_field(line, [&](size_t, std::string_view v) {
+                table.names.emplace_back(v);
+            });
+            table.columns.resize(table.names.size());
+            for (auto& c : table.columns) {
+                c.offsets.reserve(est_rows + 1);
+                c.offsets.push_back(0);
+                c.data.reserve(text.size() / table.columns.size());
+                c.validity.reserve(est_rows / 8 + 1);
+            }
+            continue;
+        }
+
+        size_t row = table.num_rows;
+        if (row % 8 == 0) {
+            for (auto& c : table.columns) c.validity.push_back(0);
+        }
+
+        size_t n = for_each_tsv_field(line, [&](size_t col, std::string_view v) {
+            if (col >= table.columns.size()) {
+                throw std::runtime_error(
+                    "Too many columns in " + filename + " at data row " +
+                    std::to_string(row + 1));
+            }
+            TsvColumn& c = table.columns[col];
+            c.data.insert(c.data.end(), v.begin(), v.end());
+            c.offsets.push_back(static_cast<int64_t>(c.data.size()));
+            c.validity.back() |= static_cast<uint8_t>(1u << (row % 8));
+        });
+
+        // 字段不足：其余列记为空值
+        for (size_t col = n; col < table.columns.size(); ++col) {
+            TsvColumn& c = table.columns[col];
+            c.offsets.push_back(static_cast<int64_t>(c.data.size()));
+            c.null_count++;
+        }
+        table.num_rows++;
+    }
+
+    return table;
+}
+
+// 整个单元格（去掉首尾空白和 '\r'）必须恰好是一个数值才算解析成功
+template <class T>
+static bool parse_number(std::string_view cell, T& out) {
+    auto is_blank = [](char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n' ||
+               c == '\f' || c == '\v';
+    };
+    while (!cell.empty() && is_blank(cell.front())) cell.remove_prefix(1);
+    while (!cell.empty() && is_blank(cell.back())) cell.remove_suffix(1);
+    if (cell.size() > 1 && cell.front() == '+' && cell[1] != '-') cell.remove_prefix(1);
+    if (cell.empty()) return false;
+
+    auto res = std::from_chars(cell.data(), cell.data() + cell.size(), out);
+    return res.ec == std::errc() && res.ptr == cell.data() + cell.size();
+}
+
+// 与 for_each_tsv_field 切出的字段数一致（行尾的 '\t' 之后不算一个字段）
+static size_t tsv_field_count(std::string_view line) {
+    size_t tabs = static_cast<size_t>(std::count(line.begin(), line.end(), '\t'));
+    return line.empty() || line.back() == '\t' ? tabs : tabs + 1;
+}
+
+// 把矩阵加宽到 cols 列，已有的行整体重排，并按 est_rows 行重新预分配
+template <class T>
+static void widen_matrix(TsvMatrix<T>& m, size_t cols, T missing, size_t est_rows) {
+    std::vector<T> values;
+    std::vector<uint8_t> valid;
+    values.reserve(std::max(est_rows, m.rows) * cols);
+    valid.reserve(std::max(est_rows, m.rows) * cols);
+    values.resize(m.rows * cols, missing);
+    valid.resize(m.rows * cols, 0);
+    for (size_t r = 0; r < m.rows; ++r) {
+        std::copy_n(m.values.begin() + r * m.cols, m.cols, values.begin() + r * cols);
+        std::copy_n(m.valid.begin() + r * m.cols, m.cols, valid.begin() + r * cols);
+    }
+    m.values.swap(values);
+    m.valid.swap(valid);
+    m.cols = cols;
+}
+
+template <class T>
+static TsvMatrix<T> read_tsv_matrix(const std::string& filename,
+                                    bool has_header, T missing) {
+    MappedFile file(filename, MappedFile::Advice::Sequential);
+    std::string_view text = file.view();
+    TsvMatrix<T> m;
+
+    size_t est_rows = static_cast<size_t>(
+        std::count(text.begin(), text.end(), '\n')) + 1;
+    bool header_line = has_header;
+
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t nl = text.find('\n', pos);
+        if (nl == std::string_view::npos) nl = text.size();
+        std::string_view line = text.substr(pos, nl - pos);
+        pos = nl + 1;
+        if (line.empty()) continue; // 跳过空行
+
+        if (header_line) {
+            header_line = false;
+            for_each_tsv_field(line, [&](size_t, std::string_view v) {
+                m.header.emplace_back(v);
+            });
+            continue;
+        }
+
+        // 先确定本行宽度：第一行（以及更宽的行）在写入单元格之前一次加宽并预分配
+        size_t width = tsv_field_count(line);
+        if (width > m.cols) widen_matrix(m, width, missing, est_rows);
+
+        size_t row = m.rows++;
+        m.values.resize(m.rows * m.cols, missing);
+        m.valid.resize(m.rows * m.cols, 0);
+
+        for_each_tsv_field(line, [&](size_t col, std::string_view v) {
+            size_t idx = row * m.cols + col;
+            if (parse_number(v, m.values[idx])) {
+                m.valid[idx] = 1;
+            } else {
+                m.values[idx] = missing;
+            }
+        });
+    }
+
+    return m;
+}
+
+TsvMatrix<double> Reader::read_tsv_matrix_double(const std::string& filename,
+                                                 bool has_header) {
+    return read_tsv_matrix<double>(filename, has_header,
+                                   std::numeric_limits<double>::quiet_NaN());
+}
+
+TsvMatrix<int> Reader::read_tsv_matrix_int(const std::string& filename,
+                                           bool has_header) {
+    return read_tsv_matrix<int>(filename, has_header, 0);
+}
+
 std::vector<std::vector<double> > Reader::read_tsv_as_double(
     const std::string& filename) {
     auto string_data = read_tsv_file(filename);
@@ -176,12 +405,354 @@ std::vector<std::vector<int> > Reader::read_tsv_as_int(
     return result;
 }
 
+// 按 read_tsv_file 的规则切分一行：以 '\t' 分隔，行尾的 '\t' 不产生空字段
+static void split_tsv_line(std::string_view line,
+                           std::vector<std::string_view>& fields) {
+    fields.clear();
+    size_t pos = 0;
+    while (pos < line.size()) {
+        size_t tab = line.find('\t', pos);
+        if (tab == std::string_view::npos) tab = line.size();
+        fields.push_back(line.substr(pos, tab - pos));
+        pos = tab + 1;
+    }
+}
+
+// 把一行字段转写为 COPY 文本格式：转义 '\\' 和 '\r'，
+// 字段不足 num_columns 时以 NULL (\N) 补齐（与 INSERT 省略尾部列一致）
+static void append_copy_row(const std::vector<std::string_view>& fields,
+                            size_t num_columns, std::string& out) {
+    for (size_t i = 0; i < num_columns; ++i) {
+        if (i) out += '\t';
+        if (i >= fields.size()) {
+            out += "\\N";
+            continue;
+        }
+        for (char c : fields[i]) {
+            if (c == '\\') out += "\\\\";
+            else if (c == '\r') out += "\\r";
+            else out += c;
+        }
+    }
+}
+
+// 显示进度条：Processing files: [====>    ]  42% (42/100)
+static void print_file_progress(size_t done, size_t total_files) {
+    float progress = static_cast<float>(done) / total_files;
+    int bar_width = 50;
+    int pos = static_cast<int>(bar_width * progress);
+
+    std::cout << "\rProcessing files: [";
+    for (int i = 0; i < bar_width; ++i) {
+        if (i < pos)
+            std::cout << "=";
+        else if (i == pos)
+            std::cout << ">";
+        else
+            std::cout << " ";
+    }
+    std::cout << "] " << std::setw(3)
+              << int(progress * 100) << "% ("
+              << done << "/" << total_files
+              << ")";
+    std::cout << std::flush;
+}
+
+static std::string create_table_sql(
+    const std::string& table_name,
+    const std::vector<std::string_view>& header) {
+    std::string create_sql = "CREATE TABLE IF NOT EXISTS " + table_name + " (";
+    for (size_t i = 0; i < header.size(); i++) {
+        create_sql += "\"" + std::string(header[i]) + "\" TEXT";
+        if (i != header.size() - 1) create_sql += ", ";
+    }
+    create_sql += ");";
+    return create_sql;
+}
+
+// 把一个文件（跳过表头）转写为若干 COPY 行，每行以 '\n' 结尾
+static void file_to_copy_rows(const std::string& file, size_t num_columns,
+                              std::string& out) {
+    std::ifstream in(file);
+    if (!in.is_open()) {
+        throw std::runtime_error("Cannot open file: " + file);
+    }
+
+    std::string line;
+    std::vector<std::string_view> fields;
+    bool header_line = true;
+    while (std::getline(in, line)) {
+        if (line.empty()) continue; // 跳过空行
+        if (header_line) {
+            header_line = false;
+            continue;
+        }
+
+        split_tsv_line(line, fields);
+        if (fields.size() > num_columns) {
+            throw std::runtime_error(
+                "Too many columns in " + file + ": " +
+                std::to_string(fields.size()) + " > " +
+                std::to_string(num_columns));
+        }
+        append_copy_row(fields, num_columns, out);
+        out += '\n';
+    }
+}
+
+/**
+ * @brief insert_files_parallel 的读取 / 写入部分（表已建好）。
+ *
+ * two_phase 时各连接以 BEGIN ... PREPARE TRANSACTION 写入，全部 PREPARE 成功后
+ * 再 COMMIT PREPARED；失败时回滚已 PREPARE 的事务，未 PREPARE 的随连接关闭回滚。
+ * 全部 PREPARE 成功后 decided 置为 true：此后即使抛出异常，结果也已确定为提交。
+ */
+static void insert_files_streams(
+    const std::vector<std::string>& filelist,
+    const std::string& table_name, const std::string& conn_str,
+    bool verbose, unsigned num_threads, unsigned num_connections,
+    size_t num_columns, bool two_phase, bool& decided) {
+    // ---------- 写入端：每个连接一个事务 + COPY 流 ----------
+    // nontransaction 上显式 BEGIN，以便用 PREPARE TRANSACTION 结束事务
+    struct CopyStream {
+        std::unique_ptr<pqxx::connection> conn;
+        std::unique_ptr<pqxx::nontransaction> txn;
+        std::unique_ptr<pqxx::stream_to> writer;
+        std::string gid;  // 两阶段提交的全局事务 ID
+    };
+    const auto stamp = std::chrono::system_clock::now().time_since_epoch().count();
+    std::vector<CopyStream> streams(num_connections);
+    for (size_t i = 0; i < streams.size(); ++i) {
+        auto& cs = streams[i];
+        cs.conn = std::make_unique<pqxx::connection>(conn_str);
+        if (!cs.conn->is_open()) {
+            throw std::runtime_error("Failed to connect to the database!");
+        }
+        cs.txn = std::make_unique<pqxx::nontransaction>(*cs.conn);
+        cs.txn->exec("BEGIN;");
+        cs.writer = std::make_unique<pqxx::stream_to>(
+            pqxx::stream_to::raw_table(*cs.txn, table_name));
+        cs.gid = "pmcad_insert_" + std::to_string(stamp) + "_" + std::to_string(i);
+    }
+
+    // ---------- 有界队列 ----------
+    const size_t max_queued = 4 * num_threads;
+    std::mutex mu;
+    std::condition_variable not_empty, not_full, progress_cv;
+    std::deque<std::string> queue;
+    size_t readers_left = num_threads;
+    bool failed = false;
+    std::exception_ptr error;
+
+    std::atomic<size_t> next_file{0};
+    std::atomic<size_t> files_done{0};
+
+    auto fail = [&](std::exception_ptr e) {
+        {
+            std::lock_guard<std::mutex> lk(mu);
+            if (!error) error = e;
+            failed = true;
+        }
+        not_empty.notify_all();
+        not_full.notify_all();
+        progress_cv.notify_all();
+    };
+
+    auto reader = [&] {
+        try {
+            for (size_t i; (i = next_file++) < filelist.size();) {
+                std::string rows;
+                file_to_copy_rows(filelist[i], num_columns, rows);
+                files_done++;
+                if (rows.empty()) continue;
+
+                std::unique_lock<std::mutex> lk(mu);
+                not_full.wait(lk, [&] { return failed || queue.size() < max_queued; });
+                if (failed) return;
+                queue.push_back(std::move(rows));
+                lk.unlock();
+                not_empty.notify_one();
+            }
+        } catch (...) {
+            fail(std::current_exception());
+        }
+        {
+            std::lock_guard<std::mutex> lk(mu);
+            readers_left--;
+        }
+        not_empty.notify_all();
+        progress_cv.notify_all();
+    };
+
+    auto writer = [&](CopyStream& cs) {
+        try {
+            while (true) {
+                std::string rows;
+                {
+                    std::unique_lock<std::mutex> lk(mu);
+                    not_empty.wait(lk, [&] {
+                        return failed || !queue.empty() || readers_left == 0;
+                    });
+                    if (failed) return;
+                    if (queue.empty()) break;
+                    rows = std::move(queue.front());
+                    queue.pop_front();
+                }
+                not_full.notify_one();
+
+                std::string_view text(rows);
+                while (!text.empty()) {
+                    size_t nl = text.find('\n');
+                    cs.writer->write_raw_line(text.substr(0, nl));
+                    text.remove_prefix(nl + 1);
+                }
+            }
+            cs.writer->complete();
+        } catch (...) {
+            fail(std::current_exception());
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i < num_threads; ++i) threads.emplace_back(reader);
+    for (auto& cs : streams) threads.emplace_back(writer, std::ref(cs));
+
+    // 主线程只负责刷新进度
+    if (verbose) {
+        std::unique_lock<std::mutex> lk(mu);
+        while (!failed && readers_left > 0) {
+            progress_cv.wait_for(lk, std::chrono::milliseconds(200));
+            print_file_progress(files_done.load(), filelist.size());
+        }
+    }
+    for (auto& t : threads) t.join();
+    if (error) std::rethrow_exception(error);
+
+    // 全部写入成功后再提交；未提交的事务在连接关闭时回滚
+    if (!two_phase) {
+        for (auto& cs : streams) cs.txn->exec("COMMIT;");
+        if (verbose) print_file_progress(filelist.size(), filelist.size());
+        return;
+    }
+
+    size_t prepared = 0;
+    try {
+        for (auto& cs : streams) {
+            cs.txn->exec("PREPARE TRANSACTION " + cs.txn->quote(cs.gid) + ";");
+            prepared++;
+        }
+    } catch (...) {
+        for (size_t i = 0; i < prepared; ++i) {
+            try {
+                streams[i].txn->exec("ROLLBACK PREPARED " + streams[i].txn->quote(streams[i].gid) + ";");
+            } catch (const std::exception& e) {
+                std::cerr << "Failed to roll back prepared transaction " << streams[i].gid
+                          << ": " << e.what() << std::endl;
+            }
+        }
+        throw;
+    }
+    decided = true;
+    // 全部 PREPARE 成功后结果已确定为提交：已 PREPARE 的事务不会因连接断开而丢失，
+    // 个别 COMMIT PREPARED 失败时报告其 gid，可在服务端手动提交
+    std::string failed_gids;
+    for (auto& cs : streams) {
+        try {
+            cs.txn->exec("COMMIT PREPARED " + cs.txn->quote(cs.gid) + ";");
+        } catch (const std::exception&) {
+            failed_gids += " " + cs.gid;
+        }
+    }
+    if (!failed_gids.empty()) {
+        throw std::runtime_error("COMMIT PREPARED failed; run COMMIT PREPARED manually for:" +
+                                 failed_gids);
+    }
+    if (verbose) print_file_progress(filelist.size(), filelist.size());
+}
+
+/**
+ * @brief insert_files_to_pgdb 的并行版本
+ *
+ * 大量小文件时瓶颈在逐个打开、读取文件的延迟，因此：
+ *   - 主线程先从第一个非空文件读出表头并建表（只建一次）；
+ *   - num_threads 个读取线程按序领取文件，整文件转写为 COPY 行，
+ *     放入有界队列；
+ *   - num_connections 个写入线程各持一个连接和 COPY 流，从队列取数据写入；
+ *   - 所有写入成功后才提交。服务器允许足够的预备事务（max_prepared_transactions
+ *     不小于 num_connections）时用两阶段提交：先在每个连接上 PREPARE TRANSACTION，
+ *     全部成功后再逐个 COMMIT PREPARED，任一 PREPARE 失败则全部回滚；
+ *     否则依次提交，第 k 个提交失败时前 k 个连接的数据已经生效。
+ *   - 表由本次调用新建时，任何失败（包括提交阶段）都会 DROP 掉该表，不留下空表或
+ *     部分数据；表原本已存在时不删除，依次提交模式下可能残留部分数据。
+ *
+ * 不同文件的行在表中的先后顺序不再与 filelist 一致。
+ */
+static void insert_files_parallel(
+    const std::vector<std::string>& filelist,
+    const std::string& table_name, const std::string& conn_str,
+    bool verbose, unsigned num_threads, unsigned num_connections) {
+    // ---------- 表头：第一个非空文件的第一个非空行 ----------
+    std::vector<std::string_view> header;
+    std::string header_line;
+    for (const auto& file : filelist) {
+        std::ifstream in(file);
+        if (!in.is_open()) {
+            throw std::runtime_error("Cannot open file: " + file);
+        }
+        while (std::getline(in, header_line)) {
+            if (!header_line.empty()) break;
+        }
+        if (!header_line.empty()) break;
+    }
+    if (header_line.empty()) return; // 所有文件都为空
+    split_tsv_line(header_line, header);
+    const size_t num_columns = header.size();
+
+    // 建表在独立事务中提交（写入端的多个连接都要看到它）；记录是否为本次新建，
+    // 失败时只删除自己建的表
+    bool created = false;
+    bool two_phase = false;
+    {
+        pqxx::connection conn(conn_str);
+        if (!conn.is_open()) {
+            throw std::runtime_error("Failed to connect to the database!");
+        }
+        pqxx::work txn(conn);
+        created = txn.exec("SELECT to_regclass(" + txn.quote(table_name) + ") IS NULL;")
+                      .one_field().as<bool>();
+        txn.exec(create_table_sql(table_name, header));
+        two_phase = txn.exec("SHOW max_prepared_transactions;").one_field().as<int>() >=
+                    static_cast<int>(num_connections);
+        txn.commit();
+    }
+    auto drop_created_table = [&] {
+        if (!created) return;
+        try {
+            pqxx::connection conn(conn_str);
+            pqxx::nontransaction txn(conn);
+            txn.exec("DROP TABLE IF EXISTS " + table_name + ";");
+        } catch (const std::exception& e) {
+            std::cerr << "Failed to drop table " << table_name << ": " << e.what() << std::endl;
+        }
+    };
+
+    bool decided = false;
+    try {
+        insert_files_streams(filelist, table_name, conn_str, verbose, num_threads,
+                             num_connections, num_columns, two_phase, decided);
+    } catch (...) {
+        if (!decided) drop_created_table();
+        throw;
+    }
+}
+
 void Reader::insert_files_to_pgdb(
     const std::vector<std::string>& filelist,
     const std::string& table_name, const std::string& dbname,
     const std::string& user, const std::string& password,
     const std::string& host = "localhost",
-    const std::string& port = "5432", bool verbose = false) 
+    const std::string& port = "5432", bool verbose = false,
+    unsigned num_threads = 1, unsigned num_connections = 1) 
 {
     try {
         // 构建连接字符串
@@ -190,72 +761,74 @@ void Reader::insert_files_to_pgdb(
             " password=" + password + " host=" + host +
             " port=" + port;
 
+        if (num_threads > 1 || num_connections > 1) {
+            insert_files_parallel(filelist, table_name, conn_str, verbose,
+                                  std::max(num_threads, 1u),
+                                  std::max(num_connections, 1u));
+            if (verbose) {
+                std::cout << "\nAll files imported successfully into table: " << table_name << std::endl;
+            }
+            return;
+        }
+
         pqxx::connection conn(conn_str);
         if (!conn.is_open()) {
             throw std::runtime_error("Failed to connect to the database!");
         }
 
         pqxx::work txn(conn);
+        std::unique_ptr<pqxx::stream_to> writer;
 
         size_t total_files = filelist.size();
-        bool first_file = true;
+        size_t num_columns = 0;
+
+        std::string line, copy_line;
+        std::vector<std::string_view> fields;
 
         for (size_t current = 0; current < total_files; ++current) {
             const auto& file = filelist[current];
 
             // 显示进度条
-            if (verbose) {
-                float progress = static_cast<float>(current + 1) / total_files;
-                int bar_width = 50;
-                int pos = static_cast<int>(bar_width * progress);
-
-                std::cout << "\rProcessing files: [";
-                for (int i = 0; i < bar_width; ++i) {
-                    if (i < pos)
-                        std::cout << "=";
-                    else if (i == pos)
-                        std::cout << ">";
-                    else
-                        std::cout << " ";
-                }
-                std::cout << "] " << std::setw(3)
-                          << int(progress * 100) << "% ("
-                          << current + 1 << "/" << total_files
-                          << ")";
-                std::cout << std::flush;
+            if (verbose) print_file_progress(current + 1, total_files);
+
+            // 逐行读取并直接写入 COPY，不再整文件读入内存
+            std::ifstream in(file);
+            if (!in.is_open()) {
+                throw std::runtime_error("Cannot open file: " + file);
             }
 
-            auto all_data = read_tsv_file(file);
-            if (all_data.empty()) continue;
+            bool header_line = true;
+            while (std::getline(in, line)) {
+                if (line.empty()) continue; // 跳过空行
+                split_tsv_line(line, fields);
 
-            if (first_file) {
-                // 建表：只用第一个文件的表头
-                const auto& header = all_data[0];
-                std::string create_sql = "CREATE TABLE IF NOT EXISTS " + table_name + " (";
-                for (size_t i = 0; i < header.size(); i++) {
-                    create_sql += "\"" + header[i] + "\" TEXT";
-                    if (i != header.size() - 1) create_sql += ", ";
-                }
-                create_sql += ");";
-                txn.exec(create_sql);
-                first_file = false;
-            }
+                if (header_line) {
+                    header_line = false;
+                    if (writer) continue; // 后续文件的表头直接跳过
+
+                    // 建表：只用第一个文件的表头
+                    txn.exec(create_table_sql(table_name, fields));
 
-            // 插入数据（跳过表头）
-            for (size_t r = 1; r < all_data.size(); r++) {
-                const auto& row = all_data[r];
+                    num_columns = fields.size();
+                    writer = std::make_unique<pqxx::stream_to>(
+                        pqxx::stream_to::raw_table(txn, table_name));
+                    continue;
+                }
 
-                // 使用 txn.esc 拼接 SQL，避免 exec_params 不支持迭代器的问题
-                std::string insert_sql = "INSERT INTO " + table_name + " VALUES (";
-                for (size_t i = 0; i < row.size(); ++i) {
-                    insert_sql += "'" + txn.esc(row[i]) + "'";
-                    if (i != row.size() - 1) insert_sql += ",";
+                if (fields.size() > num_columns) {
+                    throw std::runtime_error(
+                        "Too many columns in " + file + ": " +
+                        std::to_string(fields.size()) + " > " +
+                        std::to_string(num_columns));
                 }
-                insert_sql += ")";
-                txn.exec(insert_sql);
+
+                copy_line.clear();
+                append_copy_row(fields, num_columns, copy_line);
+                writer->write_raw_line(copy_line);
             }
         }
 
+        if (writer) writer->complete();
         txn.commit();
 
         if (verbose) {
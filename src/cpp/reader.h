@@ -1,20 +1,61 @@
 #pragma once
+#include <cstdint>
 #include <string>
 #include <vector>
 
 namespace pmcad {
 
+// 一列字符串，Arrow 风格存储：第 i 个值为 data[offsets[i], offsets[i+1])
+struct TsvColumn {
+    std::vector<int64_t> offsets;   // 长度 num_rows + 1
+    std::vector<uint8_t> data;      // 所有值首尾相接的字节
+    std::vector<uint8_t> validity;  // 有效位图（LSB 在前），行字段不足时该位为 0
+    size_t null_count = 0;
+};
+
+// 稠密数值矩阵：rows × cols，行优先连续存储
+// valid 与 values 同形状，0 表示该单元格缺失或无法完整解析为数值
+template <class T>
+struct TsvMatrix {
+    std::vector<std::string> header;  // has_header 时为第一行
+    std::vector<T> values;
+    std::vector<uint8_t> valid;
+    size_t rows = 0;
+    size_t cols = 0;
+};
+
+// 按列存储的 TSV 表：第一行为列名
+struct TsvTable {
+    std::vector<std::string> names;
+    std::vector<TsvColumn> columns;
+    size_t num_rows = 0;
+};
+
 class Reader {
 public:
     static std::vector<std::vector<std::string> > read_tsv_file(
         const std::string& filename);
+    // 多线程并发读取各文件，按 filelist 顺序合并，只保留第一个文件的表头
+    // num_threads = 0 时使用全部硬件线程
     static std::vector<std::vector<std::string> >
-    read_multi_tsv(const std::vector<std::string>& filelist);
+    read_multi_tsv(const std::vector<std::string>& filelist,
+                   unsigned num_threads = 0);
 
     // 新增功能：带错误处理的读取
     static std::vector<std::vector<std::string> > read_tsv_safe(
         const std::string& filename, bool skip_errors = true);
 
+    // 新增功能：mmap 读取为按列存储的表，每列三块连续缓冲区，不为每个单元格分配内存
+    // 切分规则同 read_tsv_file；字段多于表头时抛出异常
+    static TsvTable read_tsv_columns(const std::string& filename);
+
+    // 新增功能：std::from_chars 单遍解析为稠密矩阵（不经过字符串表）
+    // 列数取最宽的一行；无法解析的单元格在 valid 中标为 0（double 为 NaN，int 为 0）
+    static TsvMatrix<double> read_tsv_matrix_double(
+        const std::string& filename, bool has_header = false);
+    static TsvMatrix<int> read_tsv_matrix_int(
+        const std::string& filename, bool has_header = false);
+
     // 新增功能：读取为特定数据类型
     static std::vector<std::vector<double> > read_tsv_as_double(
         const std::string& filename);
@@ -32,7 +73,8 @@ public:
         const std::string& dbname, const std::string& user,
         const std::string& password,
         const std::string& host,
-        const std::string& port, bool verbose);
+        const std::string& port, bool verbose,
+        unsigned num_threads, unsigned num_connections);
 };
 
 } // namespace pmcad
\ No newline at end of file
@@ -0,0 +1,58 @@
+// src/cpp/sequence_codec.cpp
+#include "sequence_codec.h"
+
+#include <cstdint>
+#include <stdexcept>
+
+namespace pmcad {
+
+void pack_sequence(std::string_view sequence, std::string& out) {
+    std::size_t pos = out.size();
+    out.resize(pos + packed_size(sequence.size()));
+    char* dst = &out[0] + pos;
+
+    std::uint64_t acc = 0;
+    int bits = 0;
+    for (char c : sequence) {
+        unsigned code = static_cast<unsigned char>(c) - 'A' + 1u;
+        if (code - 1u >= 26u)
+            throw std::invalid_argument(std::string("❌ Invalid residue in sequence: '") + c + "'");
+        acc |= static_cast<std::uint64_t>(code) << bits;
+        bits += 5;
+        // 攒满 8 个残基（40 位）后一次写出 5 个字节
+        if (bits == 40) {
+            for (int i = 0; i < 5; ++i) *dst++ = static_cast<char>(acc >> (8 * i));
+            acc = 0;
+            bits = 0;
+        }
+    }
+    for (; bits > 0; bits -= 8, acc >>= 8) *dst++ = static_cast<char>(acc);
+}
+
+std::string pack_sequence(std::string_view sequence) {
+    std::string out;
+    pack_sequence(sequence, out);
+    return out;
+}
+
+std::string unpack_sequence(std::string_view packed) {
+    std::string out;
+    out.reserve(packed.size() * 8 / 5);
+
+    std::uint32_t acc = 0;
+    int bits = 0;
+    for (char b : packed) {
+        acc |= static_cast<std::uint32_t>(static_cast<unsigned char>(b)) << bits;
+        bits += 8;
+        for (; bits >= 5; bits -= 5, acc >>= 5) {
+            unsigned code = acc & 31u;
+            if (code == 0) return out;
+            if (code > 26)
+                throw std::invalid_argument("❌ Corrupt packed sequence");
+            out.push_back(static_cast<char>('A' + code - 1));
+        }
+    }
+    return out;
+}
+
+} // namespace pmcad
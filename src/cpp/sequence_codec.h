@@ -0,0 +1,34 @@
+// src/cpp/sequence_codec.h
+#ifndef PMC_SEQUENCE_CODEC_H
+#define PMC_SEQUENCE_CODEC_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace pmcad {
+
+/**
+ * @brief 氨基酸序列的 5-bit 打包编码（用于 SQ 去重表的 BYTEA 列）。
+ *
+ * 'A'..'Z' 编码为 1..26，0 保留作填充；每 8 个残基占 5 个字节，
+ * 位按 little-endian 顺序排列（第 i 个残基占第 5i..5i+4 位）。
+ * 末尾不足一个字节的位用 0 填充，解码遇到 0 即结束，因此不需要另存长度。
+ * 大小约为原文的 5/8。
+ */
+
+/// 打包序列；含 'A'..'Z' 以外的字符时抛出 std::invalid_argument
+std::string pack_sequence(std::string_view sequence);
+
+/// 把打包结果追加到 out（out 原有内容保留）
+void pack_sequence(std::string_view sequence, std::string& out);
+
+/// 解包；编码 27..31 视为数据损坏，抛出 std::invalid_argument
+std::string unpack_sequence(std::string_view packed);
+
+/// 打包后的字节数
+inline std::size_t packed_size(std::size_t residues) { return (residues * 5 + 7) / 8; }
+
+} // namespace pmcad
+
+#endif // PMC_SEQUENCE_CODEC_H
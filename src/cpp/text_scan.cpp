@@ -0,0 +1,245 @@
+// src/cpp/text_scan.cpp
+#include "text_scan.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#if !defined(PMCAD_DISABLE_SIMD) && defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define PMCAD_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace pmcad {
+
+// ---------------- 标量实现 ----------------
+
+static bool is_space_byte(unsigned char c) {
+    return c == ' ' || static_cast<unsigned char>(c - '\t') <= '\r' - '\t';
+}
+
+static bool is_punct_byte(char c) {
+    switch (c) {
+    case ',': case ';': case ':': case '!': case '?':
+    case '(': case ')': case '[': case ']': case '{': case '}':
+    case '"': case '\'':
+        return true;
+    default:
+        return false;
+    }
+}
+
+static std::size_t find_space_scalar(const char* s, std::size_t n) {
+    std::size_t i = 0;
+    while (i < n && !is_space_byte(s[i])) ++i;
+    return i;
+}
+
+static std::size_t find_non_space_scalar(const char* s, std::size_t n) {
+    std::size_t i = 0;
+    while (i < n && is_space_byte(s[i])) ++i;
+    return i;
+}
+
+static void lower_copy_scalar(const char* in, std::size_t n, char* out) {
+    for (std::size_t i = 0; i < n; ++i) {
+        char c = in[i];
+        out[i] = c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c;
+    }
+}
+
+/// 从 i 开始处理到结尾（SIMD 版本处理完整块后的剩余部分也用它）
+static void blank_punctuation_from(char* s, std::size_t n, std::size_t i) {
+    for (; i < n; ++i) {
+        if (is_punct_byte(s[i]) || (s[i] == '.' && (i + 1 == n || is_space_byte(s[i + 1]))))
+            s[i] = ' ';
+    }
+}
+
+static void blank_punctuation_scalar(char* s, std::size_t n) {
+    blank_punctuation_from(s, n, 0);
+}
+
+#ifdef PMCAD_X86_SIMD
+
+// ---------------- AVX2：每次 32 字节，剩余部分交给标量实现 ----------------
+
+__attribute__((target("avx2"))) static __m256i space_mask_avx2(__m256i x) {
+    // c == ' ' 或 c - '\t' <= 4（无符号，即 \t \n \v \f \r）
+    __m256i d = _mm256_sub_epi8(x, _mm256_set1_epi8('\t'));
+    __m256i ctrl = _mm256_cmpeq_epi8(_mm256_min_epu8(d, _mm256_set1_epi8(4)), d);
+    return _mm256_or_si256(ctrl, _mm256_cmpeq_epi8(x, _mm256_set1_epi8(' ')));
+}
+
+__attribute__((target("avx2"))) static std::size_t find_space_avx2(const char* s, std::size_t n) {
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i));
+        auto m = static_cast<std::uint32_t>(_mm256_movemask_epi8(space_mask_avx2(x)));
+        if (m) return i + __builtin_ctz(m);
+    }
+    return i + find_space_scalar(s + i, n - i);
+}
+
+__attribute__((target("avx2"))) static std::size_t find_non_space_avx2(const char* s, std::size_t n) {
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i));
+        auto m = ~static_cast<std::uint32_t>(_mm256_movemask_epi8(space_mask_avx2(x)));
+        if (m) return i + __builtin_ctz(m);
+    }
+    return i + find_non_space_scalar(s + i, n - i);
+}
+
+__attribute__((target("avx2"))) static void lower_copy_avx2(const char* in, std::size_t n, char* out) {
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        __m256i d = _mm256_sub_epi8(x, _mm256_set1_epi8('A'));
+        __m256i upper = _mm256_cmpeq_epi8(_mm256_min_epu8(d, _mm256_set1_epi8(25)), d);
+        x = _mm256_add_epi8(x, _mm256_and_si256(upper, _mm256_set1_epi8(32)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), x);
+    }
+    lower_copy_scalar(in + i, n - i, out + i);
+}
+
+__attribute__((target("avx2"))) static void blank_punctuation_avx2(char* s, std::size_t n) {
+    static const char PUNCT[] = ",;:!?()[]{}\"'";
+    const __m256i blank = _mm256_set1_epi8(' ');
+    std::size_t i = 0;
+    // 需要读下一个字节，完整块要求 i + 32 < n
+    for (; i + 32 < n; i += 32) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i));
+        __m256i next = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i + 1));
+        __m256i hit = _mm256_and_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8('.')),
+                                       space_mask_avx2(next));
+        for (const char* p = PUNCT; *p; ++p)
+            hit = _mm256_or_si256(hit, _mm256_cmpeq_epi8(x, _mm256_set1_epi8(*p)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(s + i), _mm256_blendv_epi8(x, blank, hit));
+    }
+    blank_punctuation_from(s, n, i);
+}
+
+// ---------------- AVX-512：每次 64 字节，结尾用掩码读写 ----------------
+
+#define PMCAD_AVX512 __attribute__((target("avx512f,avx512bw")))
+
+/// 低 len 位为 1（len <= 64）
+static std::uint64_t low_mask(std::size_t len) {
+    return len >= 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << len) - 1;
+}
+
+PMCAD_AVX512 static __mmask64 space_mask_avx512(__m512i x) {
+    __m512i d = _mm512_sub_epi8(x, _mm512_set1_epi8('\t'));
+    return _mm512_cmple_epu8_mask(d, _mm512_set1_epi8(4)) |
+           _mm512_cmpeq_epi8_mask(x, _mm512_set1_epi8(' '));
+}
+
+PMCAD_AVX512 static std::size_t find_space_avx512(const char* s, std::size_t n) {
+    for (std::size_t i = 0; i < n; i += 64) {
+        __mmask64 valid = low_mask(n - i);
+        __m512i x = _mm512_maskz_loadu_epi8(valid, s + i);
+        std::uint64_t m = space_mask_avx512(x) & valid;
+        if (m) return i + __builtin_ctzll(m);
+    }
+    return n;
+}
+
+PMCAD_AVX512 static std::size_t find_non_space_avx512(const char* s, std::size_t n) {
+    for (std::size_t i = 0; i < n; i += 64) {
+        __mmask64 valid = low_mask(n - i);
+        __m512i x = _mm512_maskz_loadu_epi8(valid, s + i);
+        std::uint64_t m = ~space_mask_avx512(x) & valid;
+        if (m) return i + __builtin_ctzll(m);
+    }
+    return n;
+}
+
+PMCAD_AVX512 static void lower_copy_avx512(const char* in, std::size_t n, char* out) {
+    for (std::size_t i = 0; i < n; i += 64) {
+        __mmask64 valid = low_mask(n - i);
+        __m512i x = _mm512_maskz_loadu_epi8(valid, in + i);
+        __mmask64 upper =
+            _mm512_cmple_epu8_mask(_mm512_sub_epi8(x, _mm512_set1_epi8('A')), _mm512_set1_epi8(25));
+        x = _mm512_mask_add_epi8(x, upper, x, _mm512_set1_epi8(32));
+        _mm512_mask_storeu_epi8(out + i, valid, x);
+    }
+}
+
+PMCAD_AVX512 static void blank_punctuation_avx512(char* s, std::size_t n) {
+    static const char PUNCT[] = ",;:!?()[]{}\"'";
+    const __m512i blank = _mm512_set1_epi8(' ');
+    for (std::size_t i = 0; i < n; i += 64) {
+        __mmask64 valid = low_mask(n - i);
+        __mmask64 next_valid = low_mask(n - i - 1);
+        __m512i x = _mm512_maskz_loadu_epi8(valid, s + i);
+        __m512i next = _mm512_maskz_loadu_epi8(next_valid, s + i + 1);
+        // 结尾之后视为空白：最后一个 '.' 也替换
+        __mmask64 hit = _mm512_cmpeq_epi8_mask(x, _mm512_set1_epi8('.')) &
+                        (space_mask_avx512(next) | ~next_valid);
+        for (const char* p = PUNCT; *p; ++p)
+            hit |= _mm512_cmpeq_epi8_mask(x, _mm512_set1_epi8(*p));
+        _mm512_mask_storeu_epi8(s + i, hit & valid, blank);
+    }
+}
+
+#undef PMCAD_AVX512
+
+#endif // PMCAD_X86_SIMD
+
+// ---------------- 运行时选择 ----------------
+
+namespace {
+
+struct Kernels {
+    const char* level;
+    std::size_t (*find_space)(const char*, std::size_t);
+    std::size_t (*find_non_space)(const char*, std::size_t);
+    void (*lower_copy)(const char*, std::size_t, char*);
+    void (*blank_punctuation)(char*, std::size_t);
+};
+
+const Kernels SCALAR = {"scalar", find_space_scalar, find_non_space_scalar, lower_copy_scalar,
+                        blank_punctuation_scalar};
+
+#ifdef PMCAD_X86_SIMD
+const Kernels AVX2 = {"avx2", find_space_avx2, find_non_space_avx2, lower_copy_avx2,
+                      blank_punctuation_avx2};
+const Kernels AVX512 = {"avx512", find_space_avx512, find_non_space_avx512, lower_copy_avx512,
+                        blank_punctuation_avx512};
+#endif
+
+const Kernels& select_kernels() {
+#ifdef PMCAD_X86_SIMD
+    // PMCAD_SIMD 只能降低级别，不能启用 CPU 不支持的指令
+    const char* env = std::getenv("PMCAD_SIMD");
+    int limit = 2;
+    if (env && std::strcmp(env, "scalar") == 0) limit = 0;
+    else if (env && std::strcmp(env, "avx2") == 0) limit = 1;
+
+    __builtin_cpu_init();
+    if (limit >= 2 && __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw"))
+        return AVX512;
+    if (limit >= 1 && __builtin_cpu_supports("avx2")) return AVX2;
+#endif
+    return SCALAR;
+}
+
+const Kernels& kernels() {
+    static const Kernels& k = select_kernels();
+    return k;
+}
+
+} // namespace
+
+std::size_t find_space(const char* s, std::size_t n) { return kernels().find_space(s, n); }
+
+std::size_t find_non_space(const char* s, std::size_t n) { return kernels().find_non_space(s, n); }
+
+void lower_copy(const char* in, std::size_t n, char* out) { kernels().lower_copy(in, n, out); }
+
+void blank_punctuation(char* s, std::size_t n) { kernels().blank_punctuation(s, n); }
+
+const char* simd_level() { return kernels().level; }
+
+} // namespace pmcad
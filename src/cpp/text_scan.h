@@ -0,0 +1,42 @@
+// src/cpp/text_scan.h
+#ifndef PMC_TEXT_SCAN_H
+#define PMC_TEXT_SCAN_H
+
+#include <cstddef>
+
+namespace pmcad {
+
+/**
+ * 基因名规范化与全文匹配中逐字节扫描的热点循环。
+ *
+ * 每个函数有标量、AVX2 与 AVX-512（AVX512BW）三个实现，首次调用时按 CPU 选择
+ * 最快的一个，结果与标量实现逐字节一致。环境变量 PMCAD_SIMD=scalar / avx2 / avx512
+ * 可把实现限制在不高于指定的级别（用于对比测试）；编译时定义 PMCAD_DISABLE_SIMD
+ * 或在非 x86-64 平台上只有标量实现。
+ *
+ * 空白与 std::regex 的 \s 一致：' ' \t \n \v \f \r。
+ */
+
+/// [s, s + n) 中第一个空白的下标，没有时返回 n
+std::size_t find_space(const char* s, std::size_t n);
+
+/// [s, s + n) 中第一个非空白的下标，没有时返回 n
+std::size_t find_non_space(const char* s, std::size_t n);
+
+/// 复制 n 字节到 out，其中 ASCII 大写字母转为小写（in 与 out 不重叠）
+void lower_copy(const char* in, std::size_t n, char* out);
+
+/**
+ * @brief 原地把全文中的标点替换为空格（逐字节替换，偏移不变）
+ *
+ * , ; : ! ? ( ) [ ] { } " ' 总是替换；'.' 只在句末，即下一个字节（替换前）
+ * 是空白或已到结尾时替换。
+ */
+void blank_punctuation(char* s, std::size_t n);
+
+/// 当前使用的实现："avx512"、"avx2" 或 "scalar"
+const char* simd_level();
+
+} // namespace pmcad
+
+#endif // PMC_TEXT_SCAN_H
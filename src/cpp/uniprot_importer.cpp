@@ -1,392 +1,1646 @@
 // src/cpp/uniprot_importer.cpp
+#include "uniprot_importer.h"
+#include "uniprot_parser.h"
+#include "uniprot_reader.h"
+#include "uniprot_scanner.h"
+#include "pg_binary_copy.h"
+#include "parquet_writer.h"
+#include "sequence_codec.h"
+
 #include <pqxx/pqxx>
-#include <zlib.h>
 #include <iostream>
-#include <sstream>
-#include <regex>
+#include <memory>
 #include <vector>
 #include <string>
 #include <stdexcept>
 #include <iomanip>
 #include <chrono>
-#include <sys/stat.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <algorithm>
+#include <limits>
+#include <cstdint>
 
 namespace pmcad {
 
-static void ensure_table_ft(pqxx::connection& conn, const std::string& table) {
+static std::string make_conn_str(const std::string& dbname,
+                                 const std::string& user,
+                                 const std::string& password,
+                                 const std::string& host,
+                                 const std::string& port) {
+    return "dbname=" + dbname + " user=" + user + " password=" + password +
+           " host=" + host + " port=" + port;
+}
+
+/**
+ * SQ_REF / SEQ 为 SQ 去重模式下的两张表（accession → CRC64 映射、按 CRC64 去重的序列）；
+ * ACC 为规范化模式下的 entry_id ↔ accession 表；
+ * STATE 为增量更新的条目状态表（主 accession → entry_id + 内容哈希）。
+ */
+enum class Section { FT, DR, SQ, SQ_REF, SEQ, ACC, STATE };
+
+struct ColumnDef {
+    const char* name;
+    const char* type;
+};
+
+/**
+ * @brief 各段落目标表的数据列（不含 id）
+ *
+ * normalized（规范化模式）时 FT / DR / SQ 的行以条目的 entry_id 代替 accession，
+ * accession 只出现在 ACC 表中。
+ */
+static std::vector<ColumnDef> section_columns(Section section, bool normalized) {
+    std::vector<ColumnDef> cols;
+    switch (section) {
+    case Section::FT:
+        cols = {{"accession", "TEXT"}, {"feature_type", "TEXT"}, {"start_pos", "INT"},
+                {"end_pos", "INT"}, {"note", "TEXT"}, {"evidence", "TEXT"}};
+        break;
+    case Section::DR:
+        cols = {{"accession", "TEXT"}, {"db_name", "TEXT"}, {"db_id", "TEXT"},
+                {"description", "TEXT"}, {"evidence", "TEXT"}};
+        break;
+    case Section::SQ:
+        cols = {{"accession", "TEXT"}, {"length", "INT"}, {"mol_weight", "INT"},
+                {"crc64", "TEXT"}, {"sequence", "TEXT"}};
+        break;
+    case Section::SQ_REF:
+        cols = {{"accession", "TEXT"}, {"length", "INT"}, {"mol_weight", "INT"},
+                {"crc64", "TEXT"}, {"seq_hash", "BIGINT"}};
+        break;
+    case Section::SEQ:
+        return {{"crc64", "TEXT"}, {"length", "INT"}, {"seq_hash", "BIGINT"},
+                {"sequence", "BYTEA"}};
+    case Section::ACC:
+        return {{"entry_id", "BIGINT"}, {"accession", "TEXT"}, {"position", "INT"}};
+    case Section::STATE:
+        return {{"accession", "TEXT"}, {"entry_id", "BIGINT"}, {"entry_hash", "BIGINT"}};
+    }
+    if (normalized) cols.front() = {"entry_id", "BIGINT"};
+    return cols;
+}
+
+/// COPY 使用的列名
+static std::vector<std::string> column_names(Section section, bool normalized) {
+    std::vector<std::string> names;
+    for (const auto& c : section_columns(section, normalized)) names.push_back(c.name);
+    return names;
+}
+
+/// bulk_load 导入结束后需要建立的索引列
+static std::vector<std::string> index_columns(Section section, bool normalized) {
+    std::string key = normalized ? "entry_id" : "accession";
+    if (section == Section::DR) return {key, "db_id"};
+    if (section == Section::SQ_REF) return {key, "crc64"};
+    if (section == Section::SEQ) return {"crc64"};
+    if (section == Section::ACC) return {"accession", "entry_id"};
+    return {key};
+}
+
+/**
+ * @brief 去重模式下序列的 64 位内容摘要（seq_hash 列，scan::hash_bytes 同时混入长度）。
+ *
+ * CRC64 是线性校验和，UniProtKB 中存在不同序列 CRC64 相同的情况；
+ * 序列以 (crc64, length, seq_hash) 标识，CRC64 碰撞的序列各存一行。
+ */
+static std::int64_t sequence_digest(std::string_view sequence) {
+    return static_cast<std::int64_t>(scan::hash_finish(scan::hash_bytes(0, sequence)));
+}
+
+/**
+ * @brief 创建目标表（已存在则不变）。
+ *
+ * 普通模式带 id SERIAL PRIMARY KEY（SEQ 表以 (crc64, length, seq_hash)、
+ * STATE 表以 accession 为主键）；
+ * bulk_load 模式创建 UNLOGGED 表且不带主键，COPY 时既不写 WAL，
+ * 也没有序列调用和 btree 插入，索引在导入结束后一次性建立。
+ */
+static void ensure_table(pqxx::connection& conn, const std::string& table,
+                         Section section, bool bulk_load, bool normalized) {
+    const char* key = section == Section::SEQ     ? "crc64, length, seq_hash"
+                      : section == Section::STATE ? "accession"
+                                                  : nullptr;
+    std::string columns;
+    for (const auto& c : section_columns(section, normalized)) {
+        if (!columns.empty()) columns += ",";
+        columns += std::string("  ") + c.name + " " + c.type;
+    }
     pqxx::work t(conn);
     t.exec(
-        "CREATE TABLE IF NOT EXISTS " + t.esc(table) + " ("
-        "  id SERIAL PRIMARY KEY,"
-        "  accession TEXT,"
-        "  feature_type TEXT,"
-        "  start_pos INT,"
-        "  end_pos INT,"
-        "  note TEXT,"
-        "  evidence TEXT"
+        std::string(bulk_load ? "CREATE UNLOGGED TABLE" : "CREATE TABLE") +
+        " IF NOT EXISTS " + t.esc(table) + " (" +
+        (bulk_load || key ? "" : "  id SERIAL PRIMARY KEY,") +
+        columns +
+        (!bulk_load && key ? std::string(",  PRIMARY KEY (") + key + ")" : "") +
         ");"
     );
     t.commit();
 }
 
-static void ensure_table_dr(pqxx::connection& conn, const std::string& table) {
+/// 在独立线程中并行执行 tasks，全部结束后重新抛出第一个异常
+static void run_parallel(const std::vector<std::function<void()>>& tasks) {
+    std::vector<std::thread> threads;
+    std::vector<std::exception_ptr> errors(tasks.size());
+    for (std::size_t i = 0; i < tasks.size(); ++i) {
+        threads.emplace_back([&, i] {
+            try {
+                tasks[i]();
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+    for (auto& e : errors)
+        if (e) std::rethrow_exception(e);
+}
+
+/**
+ * @brief bulk_load 导入结束后：表切换为 LOGGED，再并行建立索引。
+ *
+ * SET LOGGED 会重写整张表（连同已有索引一起重建，且是串行的），
+ * 所以先切换、后建索引；每个索引各用一个连接并行构建。
+ */
+static void finish_bulk_tables(const std::string& conn_str,
+                               const std::vector<std::pair<std::string, Section>>& tables,
+                               bool normalized, bool verbose) {
+    std::vector<std::function<void()>> set_logged, build_index;
+    for (const auto& [table, section] : tables) {
+        set_logged.push_back([&conn_str, verbose, table = table] {
+            pqxx::connection conn(conn_str);
+            pqxx::nontransaction t(conn);
+            if (verbose) std::cout << "🔧 SET LOGGED: " << table << "\n" << std::flush;
+            t.exec("ALTER TABLE " + t.esc(table) + " SET LOGGED;");
+        });
+        for (const auto& col : index_columns(section, normalized)) {
+            build_index.push_back([&conn_str, verbose, table = table, col] {
+                pqxx::connection conn(conn_str);
+                pqxx::nontransaction t(conn);
+                std::string index = "idx_" + table + "_" + col;
+                if (verbose) std::cout << "🔧 Building index: " << index << "\n" << std::flush;
+                t.exec("CREATE INDEX IF NOT EXISTS " + t.esc(index) + " ON " +
+                       t.esc(table) + " USING btree (" + col + ");");
+            });
+        }
+    }
+
+    auto start_time = std::chrono::steady_clock::now();
+    run_parallel(set_logged);
+    run_parallel(build_index);
+    auto total_s = std::chrono::duration_cast<std::chrono::seconds>(
+                       std::chrono::steady_clock::now() - start_time).count();
+    if (verbose)
+        std::cout << "✅ Tables logged and indexed (" << total_s << "s elapsed)\n";
+}
+
+/// 一张目标表的写入端（单连接或多连接分区），由 run_import 统一驱动
+class TableSink : public RecordSink {
+public:
+    /// 提交剩余数据（只在解析全部结束后调用一次）
+    virtual void finish() = 0;
+    virtual const std::string& table() const = 0;
+    /// 已写入的行数（含续传前已提交的行）
+    virtual std::size_t written() const = 0;
+    /// 把写入统计累加到 out（可在其它线程中调用）
+    virtual void collect(TableMetrics& out) const = 0;
+    /// 实际写入的各张表（汇报指标、打印结果时逐表列出；组合多张表的 sink 需覆盖）
+    virtual void tables(std::vector<const TableSink*>& out) const { out.push_back(this); }
+};
+
+/**
+ * @brief 规范化模式下的 DR 去重：解析器为一条 DR 行的每个 accession 各输出一条记录，
+ *        只保留条目中第一个 accession 的记录，即每条 DR 行一行。
+ */
+class FirstAccessionFilter {
+public:
+    bool keep(std::string_view accession) {
+        if (!seen_) {
+            seen_ = true;
+            first_.assign(accession.data(), accession.size());
+        }
+        return accession == first_;
+    }
+
+    void end_entry() { seen_ = false; }
+
+private:
+    std::string first_;
+    bool seen_ = false;
+};
+
+/// 断点记录（checkpoint 表中某张表某个分区的一行）
+struct Checkpoint {
+    std::size_t entries = 0;  ///< 已提交的条目数（从文件开头计）
+    std::size_t rows = 0;     ///< 已提交的行数
+    bool finished = false;    ///< 是否已完整导入
+};
+
+/**
+ * @brief 单表写入端基类。
+ *
+ * 每个 sink 持有独立的连接和 COPY 流（COPY 在连接级别互斥，
+ * 多张表同时写入必须各用一个连接），在条目边界按 batch_commit 提交。
+ *
+ * 启用断点记录后，每次提交在同一事务内更新 checkpoint 表：
+ * 数据与断点同时生效，续传时从记录的条目序号之后继续，不重不漏。
+ *
+ * entry_id_base > 0 时为规范化模式：行以 entry_id（entry_id_base + 条目序号）
+ * 代替 accession，DR 每条 DR 行只写一行（见 FirstAccessionFilter）。
+ */
+class PgTableSink : public TableSink {
+public:
+    PgTableSink(const std::string& table, Section section, std::size_t batch_commit,
+                std::int64_t entry_id_base)
+        : table_(table), section_(section), entry_id_base_(entry_id_base),
+          batch_commit_(batch_commit) {}
+
+    void write(const FtRecord& r) final {
+        if (skipping()) return;
+        copy_row(r);
+        row_written(r.accession);
+    }
+
+    void write(const DrRecord& r) final {
+        if (skipping() || (normalized() && !dr_filter_.keep(r.accession))) return;
+        copy_row(r);
+        row_written(r.accession);
+    }
+
+    void write(const SqRecord& r) final {
+        if (skipping()) return;
+        copy_row(r);
+        row_written(r.accession);
+    }
+
+    /// ACC 表：条目的每个 accession 一行，position 0 为主 accession；STATE 表：每个条目一行
+    void write(const EntryRecord& r) final {
+        if (skipping()) return;
+        if (section_ == Section::STATE) {
+            std::string_view primary = r.accessions.substr(0, r.accessions.find(';'));
+            copy_state(primary, r.content_hash);
+            row_written(primary);
+            return;
+        }
+        std::size_t pos = 0;
+        for (int position = 0; pos < r.accessions.size(); ++position) {
+            std::size_t sep = r.accessions.find(';', pos);
+            if (sep == std::string_view::npos) sep = r.accessions.size();
+            std::string_view accession = r.accessions.substr(pos, sep - pos);
+            copy_accession(accession, position);
+            row_written(accession);
+            pos = sep + 1;
+        }
+    }
+
+    void end_entry() final {
+        entry_++;
+        dr_filter_.end_entry();
+        if (pending_ >= batch_commit_) {
+            commit_batch();
+            open_stream();
+        }
+    }
+
+    void finish() override {
+        finished_ = true;
+        commit_batch();
+    }
+
+    const std::string& table() const override { return table_; }
+    std::size_t written() const override { return committed_ + pending_; }
+
+    void collect(TableMetrics& out) const override {
+        out.table = table_;
+        stats_.collect(out);
+    }
+
+    /**
+     * @brief 启用断点记录，并从 from 处续传
+     *
+     * @param first_entry 解析器实际开始送入的条目序号（parse_uniprot_gz 的 skip_entries），
+     *        序号小于 from.entries 的条目在本 sink 中丢弃
+     */
+    void set_checkpoint(const std::string& gz_path, int part, const std::string& layout,
+                        const Checkpoint& from, std::size_t first_entry) {
+        ckpt_gz_path_ = gz_path;
+        ckpt_part_ = part;
+        ckpt_layout_ = layout;
+        resume_from_ = from.entries;
+        committed_ = from.rows;
+        entry_ = first_entry;
+    }
+
+protected:
+    virtual void copy_row(const FtRecord&) {}
+    virtual void copy_row(const DrRecord&) {}
+    virtual void copy_row(const SqRecord&) {}
+    virtual void copy_accession(std::string_view /*accession*/, int /*position*/) {}
+    virtual void copy_state(std::string_view /*accession*/, std::uint64_t /*content_hash*/) {}
+
+    /// 开启事务并进入 COPY 状态
+    virtual void open_stream() = 0;
+    /// 结束 COPY，执行 checkpoint_sql（可能为空）并提交事务
+    virtual void close_stream() = 0;
+
+    /// 本次提交对应的 checkpoint upsert；quote 为当前连接的字面量转义
+    std::string checkpoint_sql(
+        const std::function<std::string(const std::string&)>& quote) const;
+
+    bool normalized() const { return entry_id_base_ > 0; }
+    /// 当前条目的 entry_id（只在规范化模式下使用）
+    std::int64_t entry_id() const {
+        return entry_id_base_ + static_cast<std::int64_t>(entry_);
+    }
+
+    std::string table_;
+    Section section_;
+    CopyStats stats_;
+
+private:
+    bool skipping() const { return entry_ < resume_from_; }
+
+    void row_written(std::string_view accession) {
+        pending_++;
+        stats_.add_row();
+        last_accession_.assign(accession.data(), accession.size());
+    }
+
+    void commit_batch() {
+        auto start = std::chrono::steady_clock::now();
+        close_stream();
+        stats_.add_commit(std::chrono::steady_clock::now() - start);
+        committed_ += pending_;
+        pending_ = 0;
+    }
+
+    std::int64_t entry_id_base_;   // 0 表示非规范化模式
+    std::size_t batch_commit_;
+    std::size_t pending_ = 0;
+    std::size_t committed_ = 0;
+
+    std::size_t entry_ = 0;        // 已结束的条目序号
+    std::size_t resume_from_ = 0;  // 小于该序号的条目已在上次导入中提交
+    bool finished_ = false;
+    std::string last_accession_;
+    std::string ckpt_gz_path_;     // 为空表示不记录断点
+    int ckpt_part_ = 0;
+    std::string ckpt_layout_;
+    FirstAccessionFilter dr_filter_;
+};
+
+static const char* CHECKPOINT_TABLE = "uniprot_import_checkpoint";
+
+static void ensure_checkpoint_table(pqxx::connection& conn) {
     pqxx::work t(conn);
     t.exec(
-        "CREATE TABLE IF NOT EXISTS " + t.esc(table) + " ("
-        "  id SERIAL PRIMARY KEY,"
-        "  accession TEXT,"
-        "  db_name TEXT,"
-        "  db_id TEXT,"
-        "  description TEXT,"
-        "  evidence TEXT"
+        std::string("CREATE TABLE IF NOT EXISTS ") + CHECKPOINT_TABLE + " ("
+        "  gz_path TEXT,"
+        "  table_name TEXT,"
+        "  part INT,"
+        "  layout TEXT,"
+        "  entry_count BIGINT,"
+        "  row_count BIGINT,"
+        "  last_accession TEXT,"
+        "  finished BOOLEAN,"
+        "  updated_at TIMESTAMPTZ DEFAULT now(),"
+        "  PRIMARY KEY (gz_path, table_name, part)"
         ");"
     );
     t.commit();
 }
 
+std::string PgTableSink::checkpoint_sql(
+    const std::function<std::string(const std::string&)>& quote) const {
+    if (ckpt_gz_path_.empty()) return "";
+    return std::string("INSERT INTO ") + CHECKPOINT_TABLE +
+           " (gz_path, table_name, part, layout, entry_count, row_count,"
+           " last_accession, finished, updated_at) VALUES (" +
+           quote(ckpt_gz_path_) + ", " + quote(table_) + ", " +
+           std::to_string(ckpt_part_) + ", " + quote(ckpt_layout_) + ", " +
+           std::to_string(entry_) + ", " + std::to_string(written()) + ", " +
+           quote(last_accession_) + ", " + (finished_ ? "true" : "false") +
+           ", now()) ON CONFLICT (gz_path, table_name, part) DO UPDATE SET"
+           " layout = EXCLUDED.layout, entry_count = EXCLUDED.entry_count,"
+           " row_count = EXCLUDED.row_count, last_accession = EXCLUDED.last_accession,"
+           " finished = EXCLUDED.finished, updated_at = EXCLUDED.updated_at;";
+}
+
 /**
- * @brief 从 gzip 解压流式解析 UniProt db 并导入 PostgreSQL
- * @param verbose 是否打印进度条
+ * @brief 读取上次导入的断点（每个分区一条）。
+ *
+ * 分区方式或连接数与上次不同时，条目到分区的映射会改变，无法续传，直接报错。
+ * UNLOGGED 表在服务端崩溃后会被清空，此时断点失效，从头开始。
  */
-class UniprotImporter {
+static std::vector<Checkpoint> load_checkpoints(pqxx::connection& conn,
+                                                const std::string& gz_path,
+                                                const std::string& table,
+                                                const std::string& layout,
+                                                unsigned parts) {
+    std::vector<Checkpoint> out(parts);
+    pqxx::work t(conn);
+    pqxx::result r = t.exec(
+        std::string("SELECT part, layout, entry_count, row_count, finished FROM ") +
+        CHECKPOINT_TABLE + " WHERE gz_path = " + t.quote(gz_path) +
+        " AND table_name = " + t.quote(table) + ";");
+
+    std::size_t rows = 0;
+    for (const auto& row : r) {
+        int part = row[0].as<int>();
+        std::string prev_layout = row[1].as<std::string>();
+        if (prev_layout != layout || part < 0 || part >= static_cast<int>(parts))
+            throw std::runtime_error(
+                "❌ Cannot resume " + table + ": previous import used layout '" +
+                prev_layout + "', current is '" + layout +
+                "' (num_connections / hash_partition must match)");
+        out[part].entries = row[2].as<std::size_t>();
+        out[part].rows = row[3].as<std::size_t>();
+        out[part].finished = row[4].as<bool>();
+        rows += out[part].rows;
+    }
+
+    if (rows > 0) {
+        std::size_t size = t.exec(
+            "SELECT pg_relation_size(" + t.quote(table) + "::regclass);")
+            .one_field().as<std::size_t>();
+        if (size == 0) {
+            std::cerr << "⚠️  Table " << table << " is empty but has a checkpoint"
+                      << " (UNLOGGED table truncated after a crash?), restarting from the beginning\n";
+            out.assign(parts, Checkpoint());
+        }
+    }
+    return out;
+}
+
+static void clear_checkpoints(pqxx::connection& conn, const std::string& gz_path,
+                              const std::string& table) {
+    pqxx::work t(conn);
+    t.exec(std::string("DELETE FROM ") + CHECKPOINT_TABLE +
+           " WHERE gz_path = " + t.quote(gz_path) +
+           " AND table_name = " + t.quote(table) + ";");
+    t.commit();
+}
+
+/**
+ * @brief 文本 COPY：libpqxx::stream_to
+ *
+ * stream_to 每行调用一次 PQputCopyData，因此每行计为一次 flush。
+ */
+class PgCopySink : public PgTableSink {
 public:
-    static void ft_stream_parse_and_copy(
-        const std::string& gz_path,
-        const std::string& table_name,
-        const std::string& dbname,
-        const std::string& user,
-        const std::string& password,
-        const std::string& host = "localhost",
-        const std::string& port = "5432",
-        std::size_t batch_commit = 200000,
-        bool verbose = true
-    );
-    static void dr_stream_parse_and_copy(
-        const std::string& gz_path,
-        const std::string& table_name,
-        const std::string& dbname,
-        const std::string& user,
-        const std::string& password,
-        const std::string& host = "localhost",
-        const std::string& port = "5432",
-        std::size_t batch_commit = 200000,
-        bool verbose = true
-    );
-    static void sq_stream_parse_and_copy(
-        const std::string& gz_path,
-        const std::string& table_name,
-        const std::string& dbname,
-        const std::string& user,
-        const std::string& password,
-        const std::string& host = "localhost",
-        const std::string& port = "5432",
-        std::size_t batch_commit = 200000,
-        bool verbose = true
-    );
+    PgCopySink(const std::string& conn_str, const std::string& table,
+               Section section, std::size_t batch_commit, std::int64_t entry_id_base)
+        : PgTableSink(table, section, batch_commit, entry_id_base), conn_(conn_str) {
+        if (!conn_.is_open())
+            throw std::runtime_error("❌ Cannot connect to PostgreSQL");
+
+        open_stream();
+    }
+
+protected:
+    void copy_row(const FtRecord& r) override {
+        put(key(r.accession), r.feature_type, r.start_pos, r.end_pos, r.note, r.evidence);
+    }
+
+    void copy_row(const DrRecord& r) override {
+        put(key(r.accession), r.db_name, r.db_id, r.description, r.evidence);
+    }
+
+    void copy_accession(std::string_view accession, int position) override {
+        put(entry_id(), accession, position);
+    }
+
+    void copy_state(std::string_view accession, std::uint64_t content_hash) override {
+        put(accession, entry_id(), static_cast<std::int64_t>(content_hash));
+    }
+
+    void copy_row(const SqRecord& r) override {
+        switch (section_) {
+        case Section::SQ_REF:
+            put(key(r.accession), r.length, r.mol_weight, r.crc64, sequence_digest(r.sequence));
+            break;
+        case Section::SEQ:
+            // 文本 COPY 中 BYTEA 以 "\x" 十六进制形式发送
+            bytes_.clear();
+            pack_sequence(r.sequence, bytes_);
+            hex_.assign("\\x");
+            for (unsigned char c : bytes_) {
+                hex_ += HEX[c >> 4];
+                hex_ += HEX[c & 15];
+            }
+            put(r.crc64, r.length, sequence_digest(r.sequence), hex_);
+            break;
+        default:
+            put(key(r.accession), r.length, r.mol_weight, r.crc64, r.sequence);
+            break;
+        }
+    }
+
+    void open_stream() override {
+        tx_ = std::make_unique<pqxx::work>(conn_);
+        std::string columns;
+        for (const auto& c : column_names(section_, normalized())) {
+            if (!columns.empty()) columns += ", ";
+            columns += tx_->quote_name(c);
+        }
+        writer_ = std::make_unique<pqxx::stream_to>(
+            pqxx::stream_to::raw_table(*tx_, tx_->quote_name(table_), columns));
+    }
+
+    void close_stream() override {
+        if (writer_) { writer_->complete(); writer_.reset(); }
+        if (tx_) {
+            std::string sql = checkpoint_sql([this](const std::string& v) { return tx_->quote(v); });
+            if (!sql.empty()) tx_->exec(sql);
+            tx_->commit();
+            tx_.reset();
+        }
+    }
+
+private:
+    /// 行首的 accession 列；规范化模式下换成 entry_id（以文本发送，服务端转为 BIGINT）
+    std::string_view key(std::string_view accession) {
+        if (!normalized()) return accession;
+        key_ = std::to_string(entry_id());
+        return key_;
+    }
+
+    template <class... T>
+    void put(const T&... values) {
+        auto start = std::chrono::steady_clock::now();
+        writer_->write_values(values...);
+        stats_.add_flush(std::chrono::steady_clock::now() - start);
+    }
+
+    static constexpr char HEX[] = "0123456789abcdef";
+
+    pqxx::connection conn_;
+    std::unique_ptr<pqxx::work> tx_;
+    std::unique_ptr<pqxx::stream_to> writer_;
+    std::string bytes_, hex_;  // SEQ 行的打包序列及其十六进制形式（复用容量）
+    std::string key_;
 };
 
-void UniprotImporter::ft_stream_parse_and_copy(
-    const std::string& gz_path,
-    const std::string& table_name,
-    const std::string& dbname,
-    const std::string& user,
-    const std::string& password,
-    const std::string& host,
-    const std::string& port,
-    std::size_t batch_commit,
-    bool verbose
-) {
-    // ---------- 数据库连接 ----------
-    std::string conn_str =
-        "dbname=" + dbname + " user=" + user + " password=" + password +
-        " host=" + host + " port=" + port;
-    pqxx::connection conn(conn_str);
-    if (!conn.is_open())
-        throw std::runtime_error("❌ Cannot connect to PostgreSQL");
-
-    ensure_table_ft(conn, table_name);
-
-    // ---------- 打开 gzip ----------
-    gzFile gzfile = gzopen(gz_path.c_str(), "rb");
-    if (!gzfile)
-        throw std::runtime_error("❌ Cannot open gzip file: " + gz_path);
-
-    // 获取文件大小用于进度估计
-    struct stat st;
-    size_t total_bytes = 0;
-    if (stat(gz_path.c_str(), &st) == 0)
-        total_bytes = st.st_size;
-
-    const size_t BUF_SIZE = 16384;
-    char buffer[BUF_SIZE];
-    std::string line, accession, f_type, f_start, f_end, f_note, f_evi;
-    bool in_feature = false;
-    std::size_t written = 0;
-    size_t processed_bytes = 0;
-
-    std::regex ac_regex(R"(AC\s+([A-Z0-9]+);)");
-    std::regex ft_regex(R"(^FT\s+(\S+)\s+(\d+)\.\.(\d+))");
-    std::regex note_regex(R"REGEX(/note="([^"]+)")REGEX");
-    std::regex evi_regex(R"REGEX(/evidence="([^"]+)")REGEX");
-
-    std::unique_ptr<pqxx::work> tx;
-    std::unique_ptr<pqxx::stream_to> writer;
-
-    auto open_stream = [&](std::unique_ptr<pqxx::work>& tx,
-                           std::unique_ptr<pqxx::stream_to>& writer) {
-        tx = std::make_unique<pqxx::work>(conn);
-        pqxx::table_path path{table_name};
-        writer = std::make_unique<pqxx::stream_to>(
-            pqxx::stream_to::table(
-                *tx, path,
-                {"accession", "feature_type", "start_pos", "end_pos", "note", "evidence"}
-            )
-        );
-    };
+/**
+ * @brief 二进制 COPY：整数列以 int4 直接发送，服务端无需文本解析。
+ *
+ * FT 的 start_pos / end_pos 在客户端转换为整数（超出 INT 范围时抛出异常，
+ * 与文本 COPY 在服务端报错的行为一致）。
+ */
+class PgBinaryCopySink : public PgTableSink {
+public:
+    PgBinaryCopySink(const std::string& conn_str, const std::string& table,
+                     Section section, std::size_t batch_commit, std::int64_t entry_id_base)
+        : PgTableSink(table, section, batch_commit, entry_id_base), copy_(conn_str) {
+        copy_.set_stats(&stats_);
+        open_stream();
+    }
 
-    auto close_stream = [&](std::unique_ptr<pqxx::work>& tx,
-                            std::unique_ptr<pqxx::stream_to>& writer) {
-        if (writer) { writer->complete(); writer.reset(); }
-        if (tx)     { tx->commit(); tx.reset(); }
-    };
+protected:
+    void copy_row(const FtRecord& r) override {
+        copy_.start_row(6);
+        key(r.accession);
+        copy_.text(r.feature_type);
+        copy_.int4(scan::to_int(r.start_pos));
+        copy_.int4(scan::to_int(r.end_pos));
+        copy_.text(r.note);
+        copy_.text(r.evidence);
+        copy_.end_row();
+    }
 
-    open_stream(tx, writer);
+    void copy_row(const DrRecord& r) override {
+        copy_.start_row(5);
+        key(r.accession);
+        copy_.text(r.db_name);
+        copy_.text(r.db_id);
+        copy_.text(r.description);
+        copy_.text(r.evidence);
+        copy_.end_row();
+    }
 
-    // ---------- 时间统计 ----------
-    auto start_time = std::chrono::steady_clock::now();
+    void copy_row(const SqRecord& r) override {
+        switch (section_) {
+        case Section::SQ_REF:
+            copy_.start_row(5);
+            key(r.accession);
+            copy_.int4(r.length);
+            copy_.int4(r.mol_weight);
+            copy_.text(r.crc64);
+            copy_.int8(sequence_digest(r.sequence));
+            break;
+        case Section::SEQ:
+            // BYTEA 的二进制格式即原始字节
+            bytes_.clear();
+            pack_sequence(r.sequence, bytes_);
+            copy_.start_row(4);
+            copy_.text(r.crc64);
+            copy_.int4(r.length);
+            copy_.int8(sequence_digest(r.sequence));
+            copy_.text(bytes_);
+            break;
+        default:
+            copy_.start_row(5);
+            key(r.accession);
+            copy_.int4(r.length);
+            copy_.int4(r.mol_weight);
+            copy_.text(r.crc64);
+            copy_.text(r.sequence);
+            break;
+        }
+        copy_.end_row();
+    }
 
-    while (gzgets(gzfile, buffer, BUF_SIZE)) {
-        line = buffer;
-        line.erase(std::remove(line.begin(), line.end(), '\n'), line.end());
-        if (!line.empty() && line.back() == '.')
-            line.pop_back();
-        processed_bytes += strlen(buffer);
-
-        if (line.rfind("AC   ", 0) == 0) {
-            std::smatch m;
-            if (std::regex_search(line, m, ac_regex))
-                accession = m[1];
-            continue;
+    void copy_accession(std::string_view accession, int position) override {
+        copy_.start_row(3);
+        copy_.int8(entry_id());
+        copy_.text(accession);
+        copy_.int4(position);
+        copy_.end_row();
+    }
+
+    void copy_state(std::string_view accession, std::uint64_t content_hash) override {
+        copy_.start_row(3);
+        copy_.text(accession);
+        copy_.int8(entry_id());
+        copy_.int8(static_cast<std::int64_t>(content_hash));
+        copy_.end_row();
+    }
+
+    void open_stream() override {
+        copy_.begin(table_, column_names(section_, normalized()));
+    }
+
+    void close_stream() override {
+        if (!copy_.in_copy()) return;
+        copy_.end_copy();
+        std::string sql = checkpoint_sql([this](const std::string& v) { return copy_.quote_literal(v); });
+        if (!sql.empty()) copy_.exec(sql);
+        copy_.exec("COMMIT");
+    }
+
+private:
+    /// 行首的 accession 列；规范化模式下换成 int8 的 entry_id
+    void key(std::string_view accession) {
+        if (normalized())
+            copy_.int8(entry_id());
+        else
+            copy_.text(accession);
+    }
+
+    PgBinaryCopy copy_;
+    std::string bytes_;  // SEQ 行的打包序列（复用容量）
+};
+
+/**
+ * @brief 多连接分区写入：同一张表开 N 个连接，各自独立 COPY + 批量提交。
+ *
+ * 单个 COPY 流受限于一个后端进程的解析 / 写入速度；分到 N 个连接后
+ * 服务端可以并行处理。每个分区有一个写入线程，调用线程只把记录
+ * 拷贝到该分区的 RecordBuffer，攒够 FLUSH_ROWS 行后交给写入线程回放，
+ * 因此一个后端变慢不会阻塞其它分区。
+ *
+ * 分区方式（只取决于条目序号 / accession，续传时映射不变）：
+ *   - 默认按条目序号轮转，一个条目的所有行进入同一分区；
+ *   - hash_partition = true 时按 accession 哈希（scan::hash_bytes，与编译器和标准库无关），
+ *     同一 accession 的行始终进入同一分区（ACC 表按条目的主 accession）。
+ *
+ * 每个条目结束时所有分区都会收到 end_entry，因此各分区 sink 的条目序号
+ * 与全局一致，断点可以按分区分别记录。
+ *
+ * batch_commit 作用于每个分区各自的事务；各分区独立提交，
+ * 中途失败时已提交的批次不会回滚（与单连接时的行为一致）。
+ */
+class PartitionedSink : public TableSink {
+public:
+    /// first_entry：解析器开始送入的条目序号（续传时非 0）；normalized：规范化模式
+    PartitionedSink(std::vector<std::unique_ptr<PgTableSink>> sinks, bool hash_partition,
+                    std::size_t first_entry, bool normalized)
+        : hash_partition_(hash_partition), normalized_(normalized), parts_(sinks.size()),
+          next_(first_entry % sinks.size()) {
+        for (std::size_t i = 0; i < parts_.size(); ++i) {
+            parts_[i].sink = std::move(sinks[i]);
+            parts_[i].written = parts_[i].sink->written();
         }
+        for (auto& p : parts_)
+            p.thread = std::thread([this, &p] { run(p); });
+    }
 
-        if (line.rfind("FT   ", 0) == 0) {
-            std::smatch m;
-            if (std::regex_search(line, m, ft_regex)) {
-                if (in_feature) {
-                    writer->write_values(accession, f_type, f_start, f_end, f_note, f_evi);
-                    written++;
-                    f_type.clear(); f_start.clear(); f_end.clear(); f_note.clear(); f_evi.clear();
-                }
-                f_type  = m[1];
-                f_start = m[2];
-                f_end   = m[3];
-                in_feature = true;
-            } else if (in_feature) {
-                if (std::smatch mn; std::regex_search(line, mn, note_regex)) f_note = mn[1];
-                if (std::smatch me; std::regex_search(line, me, evi_regex))  f_evi  = me[1];
-            }
-            continue;
+    ~PartitionedSink() override {
+        // 异常退出：通知写入线程放弃剩余数据，未提交的批次由各连接回滚
+        if (!joined_) {
+            fail(nullptr);
+            for (auto& p : parts_) p.thread.join();
         }
+    }
 
-        if (line.rfind("//", 0) == 0) {
-            if (in_feature) {
-                writer->write_values(accession, f_type, f_start, f_end, f_note, f_evi);
-                written++;
-                in_feature = false;
-                f_type.clear(); f_start.clear(); f_end.clear(); f_note.clear(); f_evi.clear();
-            }
+    void write(const FtRecord& r) override { route(r.accession).write(r); }
+    void write(const DrRecord& r) override {
+        // 按 accession 哈希时同一 DR 行的各条记录会进入不同分区，须在分区前去重
+        if (normalized_ && !dr_filter_.keep(r.accession)) return;
+        route(r.accession).write(r);
+    }
+    void write(const SqRecord& r) override { route(r.accession).write(r); }
 
-            // ---------- 进度显示 ----------
-            if (verbose && written % 10000 == 0) {
-                double ratio = total_bytes ? (double)processed_bytes / total_bytes : 0.0;
-                auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(
-                                   std::chrono::steady_clock::now() - start_time)
-                                   .count();
-                double rate = elapsed > 0 ? processed_bytes / (1024.0 * 1024.0 * elapsed) : 0.0;
-                double eta = (ratio > 0 && rate > 0)
-                                 ? (total_bytes - processed_bytes) / (rate * 1024 * 1024)
-                                 : 0.0;
-
-                std::cerr << "\r[" << std::setw(6) << std::fixed << std::setprecision(2)
-                          << ratio * 100 << "%] "
-                          << processed_bytes / (1024 * 1024) << "MB / "
-                          << total_bytes / (1024 * 1024) << "MB, "
-                          << "Imported: " << written
-                          << " | Speed: " << std::fixed << std::setprecision(2)
-                          << rate << " MB/s"
-                          << " | ETA: " << std::fixed << std::setprecision(1)
-                          << eta << "s   " << std::flush;
-            }
+    void write(const EntryRecord& r) override {
+        route(r.accessions.substr(0, r.accessions.find(';'))).write(r);
+    }
+
+    void end_entry() override {
+        dr_filter_.end_entry();
+        for (auto& p : parts_) {
+            p.filling.end_entry();
+            if (p.filling.rows() >= FLUSH_ROWS) submit(p);
+        }
+        if (!hash_partition_) next_ = (next_ + 1) % parts_.size();
+    }
 
-            if (written >= batch_commit) {
-                close_stream(tx, writer);
-                open_stream(tx, writer);
-                written = 0;
+    void finish() override {
+        for (auto& p : parts_) {
+            if (p.filling.rows() > 0) submit(p);
+            {
+                std::lock_guard<std::mutex> lk(p.mu);
+                p.closed = true;
             }
+            p.cv.notify_all();
+        }
+        for (auto& p : parts_) p.thread.join();
+        joined_ = true;
+        if (error_) std::rethrow_exception(error_);
+    }
 
-            accession.clear();
-            continue;
+    const std::string& table() const override { return parts_.front().sink->table(); }
+    std::size_t written() const override {
+        std::size_t n = 0;
+        for (const auto& p : parts_) n += p.written.load(std::memory_order_relaxed);
+        return n;
+    }
+
+    void collect(TableMetrics& out) const override {
+        for (const auto& p : parts_) p.sink->collect(out);
+    }
+
+private:
+    static constexpr std::size_t FLUSH_ROWS = 4096;
+    static constexpr std::size_t MAX_QUEUED = 4;
+
+    struct Partition {
+        std::unique_ptr<PgTableSink> sink;
+        RecordBuffer filling;             // 调用线程正在填充的缓冲
+        std::deque<RecordBuffer> queue;   // 待写入
+        std::vector<RecordBuffer> spare;  // 已写完、可复用的缓冲
+        bool closed = false;
+        std::mutex mu;
+        std::condition_variable cv;
+        std::thread thread;
+        std::atomic<std::size_t> written{0};  // 写入线程更新的 sink->written()
+    };
+
+    RecordBuffer& route(std::string_view accession) {
+        std::size_t i = hash_partition_
+                            ? scan::hash_finish(scan::hash_bytes(0, accession)) % parts_.size()
+                            : next_;
+        return parts_[i].filling;
+    }
+
+    /// 把填充中的缓冲交给写入线程（队列满时等待）
+    void submit(Partition& p) {
+        std::unique_lock<std::mutex> lk(p.mu);
+        p.cv.wait(lk, [&] { return p.queue.size() < MAX_QUEUED || failed_.load(); });
+        if (failed_.load()) {
+            lk.unlock();
+            std::lock_guard<std::mutex> elk(error_mu_);
+            if (error_) std::rethrow_exception(error_);
+            throw std::runtime_error("❌ Partitioned COPY aborted");
+        }
+        p.queue.push_back(std::move(p.filling));
+        if (!p.spare.empty()) {
+            p.filling = std::move(p.spare.back());
+            p.spare.pop_back();
+        } else {
+            p.filling = RecordBuffer();
+        }
+        lk.unlock();
+        p.cv.notify_all();
+    }
+
+    /// 写入线程：按提交顺序回放到该分区的 COPY 流
+    void run(Partition& p) {
+        try {
+            for (;;) {
+                RecordBuffer buf;
+                {
+                    std::unique_lock<std::mutex> lk(p.mu);
+                    p.cv.wait(lk, [&] { return !p.queue.empty() || p.closed || failed_.load(); });
+                    if (failed_.load()) return;
+                    if (p.queue.empty()) break;
+                    buf = std::move(p.queue.front());
+                    p.queue.pop_front();
+                }
+                p.cv.notify_all();
+
+                buf.replay(p.sink.get(), p.sink.get(), p.sink.get(), p.sink.get());
+                p.written.store(p.sink->written(), std::memory_order_relaxed);
+                buf.clear();
+
+                std::lock_guard<std::mutex> lk(p.mu);
+                p.spare.push_back(std::move(buf));
+            }
+            p.sink->finish();
+        } catch (...) {
+            fail(std::current_exception());
         }
     }
 
-    if (in_feature) {
-        writer->write_values(accession, f_type, f_start, f_end, f_note, f_evi);
-        written++;
+    void fail(std::exception_ptr e) {
+        {
+            std::lock_guard<std::mutex> lk(error_mu_);
+            if (e && !error_) error_ = e;
+        }
+        failed_.store(true);
+        for (auto& p : parts_) {
+            { std::lock_guard<std::mutex> lk(p.mu); }
+            p.cv.notify_all();
+        }
     }
 
-    close_stream(tx, writer);
-    gzclose(gzfile);
+    bool hash_partition_;
+    bool normalized_;
+    FirstAccessionFilter dr_filter_;
+    std::vector<Partition> parts_;
+    std::size_t next_;
+    bool joined_ = false;
 
-    auto end_time = std::chrono::steady_clock::now();
-    auto total_s = std::chrono::duration_cast<std::chrono::seconds>(end_time - start_time).count();
+    std::atomic<bool> failed_{false};
+    std::mutex error_mu_;
+    std::exception_ptr error_;
+};
 
-    std::cout << "\n✅ Completed import into table: " << table_name
-              << " in " << total_s << "s.\n";
+static std::unique_ptr<PgTableSink> make_table_sink(const std::string& conn_str,
+                                                    const std::string& table,
+                                                    Section section,
+                                                    std::size_t batch_commit,
+                                                    bool binary_copy,
+                                                    std::int64_t entry_id_base) {
+    if (binary_copy)
+        return std::make_unique<PgBinaryCopySink>(conn_str, table, section, batch_commit,
+                                                  entry_id_base);
+    return std::make_unique<PgCopySink>(conn_str, table, section, batch_commit, entry_id_base);
 }
 
-void UniprotImporter::dr_stream_parse_and_copy(
-    const std::string& gz_path,
-    const std::string& table_name,
-    const std::string& dbname,
-    const std::string& user,
-    const std::string& password,
-    const std::string& host,
-    const std::string& port,
-    std::size_t batch_commit,
-    bool verbose
-) {
-    // ---------- 数据库连接 ----------
-    std::string conn_str =
-        "dbname=" + dbname + " user=" + user + " password=" + password +
-        " host=" + host + " port=" + port;
-    pqxx::connection conn(conn_str);
-    if (!conn.is_open())
-        throw std::runtime_error("❌ Cannot connect to PostgreSQL");
-
-    ensure_table_dr(conn, table_name);
-
-    // ---------- 打开 gzip ----------
-    gzFile gzfile = gzopen(gz_path.c_str(), "rb");
-    if (!gzfile)
-        throw std::runtime_error("❌ Cannot open gzip file: " + gz_path);
-
-    struct stat st;
-    size_t total_bytes = 0;
-    if (stat(gz_path.c_str(), &st) == 0)
-        total_bytes = st.st_size;
-
-    const size_t BUF_SIZE = 16384;
-    char buffer[BUF_SIZE];
-    std::string line, accession, db_name, db_id, desc, evidence;
-    size_t processed_bytes = 0, written = 0;
-
-    // 正则表达式
-    std::regex ac_regex(R"(([A-Z0-9]+);)");
-    std::regex dr_regex(R"(^DR\s+(\S+);\s*([^;]+)(?:;\s*([^;]+))?(?:;\s*(.*))?)");
-
-    std::unique_ptr<pqxx::work> tx;
-    std::unique_ptr<pqxx::stream_to> writer;
-
-    auto open_stream = [&](std::unique_ptr<pqxx::work>& tx,
-                           std::unique_ptr<pqxx::stream_to>& writer) {
-        tx = std::make_unique<pqxx::work>(conn);
-        pqxx::table_path path{table_name};
-        writer = std::make_unique<pqxx::stream_to>(
-            pqxx::stream_to::table(
-                *tx, path,
-                {"accession", "db_name", "db_id", "description", "evidence"}
-            )
-        );
+/// 一张表的续传信息：每个分区的断点 + 解析器开始送入的条目序号
+struct ResumePoint {
+    std::string gz_path;
+    std::string layout;
+    std::vector<Checkpoint> parts;
+    std::size_t first_entry = 0;
+};
+
+static std::unique_ptr<TableSink> make_sink(const std::string& conn_str,
+                                            const std::string& table,
+                                            Section section,
+                                            std::size_t batch_commit,
+                                            bool binary_copy,
+                                            unsigned num_connections,
+                                            bool hash_partition,
+                                            std::int64_t entry_id_base,
+                                            const ResumePoint& resume) {
+    if (table.empty()) return nullptr;
+
+    std::vector<std::unique_ptr<PgTableSink>> sinks;
+    for (unsigned i = 0; i < std::max(num_connections, 1u); ++i) {
+        sinks.push_back(make_table_sink(conn_str, table, section, batch_commit, binary_copy,
+                                        entry_id_base));
+        sinks.back()->set_checkpoint(resume.gz_path, static_cast<int>(i), resume.layout,
+                                     resume.parts[i], resume.first_entry);
+    }
+    if (sinks.size() == 1) return std::move(sinks.front());
+    return std::make_unique<PartitionedSink>(std::move(sinks), hash_partition,
+                                             resume.first_entry, entry_id_base > 0);
+}
+
+/**
+ * @brief 序列键 (CRC64, seq_hash) 的开放寻址哈希集合（线性探测，装载率超过 1/2 时扩容）。
+ *
+ * seq_hash 已混入序列长度，两个 64 位值相同才视为同一条序列。每个元素只占
+ * 16 字节的槽位，比 std::unordered_set 省去节点分配，TrEMBL 规模（上亿条不同序列）
+ * 时约 32 字节 / 条。
+ */
+class SequenceKeySet {
+public:
+    /// 插入 (crc64, seq_hash)，已存在时返回 false
+    bool insert(std::uint64_t crc64, std::uint64_t seq_hash) {
+        Key key{crc64, seq_hash};
+        if (key.empty()) {  // (0, 0) 作为空槽标记，单独记录
+            if (has_empty_) return false;
+            has_empty_ = true;
+            return true;
+        }
+        if ((size_ + 1) * 2 > slots_.size()) grow();
+        std::size_t mask = slots_.size() - 1;
+        for (std::size_t i = slot(key, mask);; i = (i + 1) & mask) {
+            if (slots_[i] == key) return false;
+            if (slots_[i].empty()) {
+                slots_[i] = key;
+                size_++;
+                return true;
+            }
+        }
+    }
+
+private:
+    struct Key {
+        std::uint64_t crc64 = 0, seq_hash = 0;
+        bool empty() const { return crc64 == 0 && seq_hash == 0; }
+        bool operator==(const Key& o) const { return crc64 == o.crc64 && seq_hash == o.seq_hash; }
     };
 
-    auto close_stream = [&](std::unique_ptr<pqxx::work>& tx,
-                            std::unique_ptr<pqxx::stream_to>& writer) {
-        if (writer) { writer->complete(); writer.reset(); }
-        if (tx)     { tx->commit(); tx.reset(); }
+    static std::size_t slot(const Key& key, std::size_t mask) {
+        std::uint64_t h = (key.crc64 ^ (key.seq_hash * 0xC2B2AE3D27D4EB4Full)) * 0x9E3779B97F4A7C15ull;
+        return static_cast<std::size_t>(h >> 32) & mask;
+    }
+
+    void grow() {
+        std::vector<Key> old(std::max<std::size_t>(slots_.size() * 2, 1 << 16));
+        old.swap(slots_);
+        std::size_t mask = slots_.size() - 1;
+        for (const Key& key : old) {
+            if (key.empty()) continue;
+            std::size_t i = slot(key, mask);
+            while (!slots_[i].empty()) i = (i + 1) & mask;
+            slots_[i] = key;
+        }
+    }
+
+    std::vector<Key> slots_;
+    std::size_t size_ = 0;
+    bool has_empty_ = false;
+};
+
+/// SQ 头部的 CRC64（16 位大写十六进制）转为整数
+static std::uint64_t parse_crc64(std::string_view crc64) {
+    if (crc64.empty() || crc64.size() > 16)
+        throw std::runtime_error("❌ Invalid CRC64: " + std::string(crc64));
+    std::uint64_t v = 0;
+    for (char c : crc64)
+        v = (v << 4) | static_cast<std::uint64_t>(c <= '9' ? c - '0' : c - 'A' + 10);
+    return v;
+}
+
+/**
+ * @brief SQ 去重写入端：每条 SQ 记录写入 accession → CRC64 映射表，
+ *        序列本身只在某个 CRC64 第一次出现时写入序列表（5-bit 打包为 BYTEA）。
+ *
+ * 两张表各自是完整的 TableSink（可多连接分区，各自记录断点），
+ * 每个条目结束时都收到 end_entry，因此条目序号与断点和普通模式一致。
+ * 去重在调用线程中进行，开始前用 preload 载入序列表中已有的序列键。
+ *
+ * 序列以 (crc64, length, seq_hash) 标识（见 sequence_digest）：CRC64 相同而
+ * 序列不同时按新序列另存一行，两张表按这三列关联。
+ */
+class SequenceDedupSink : public TableSink {
+public:
+    SequenceDedupSink(std::unique_ptr<TableSink> refs, std::unique_ptr<TableSink> seqs)
+        : refs_(std::move(refs)), seqs_(std::move(seqs)) {}
+
+    void write(const SqRecord& r) override {
+        refs_->write(r);
+        auto digest = static_cast<std::uint64_t>(sequence_digest(r.sequence));
+        if (seen_.insert(parse_crc64(r.crc64), digest)) seqs_->write(r);
+    }
+
+    void end_entry() override {
+        refs_->end_entry();
+        seqs_->end_entry();
+    }
+
+    void finish() override {
+        refs_->finish();
+        seqs_->finish();
+    }
+
+    const std::string& table() const override { return refs_->table(); }
+    std::size_t written() const override { return refs_->written(); }
+    void collect(TableMetrics& out) const override { refs_->collect(out); }
+
+    void tables(std::vector<const TableSink*>& out) const override {
+        refs_->tables(out);
+        seqs_->tables(out);
+    }
+
+    /**
+     * @brief 载入序列表中已有的序列键（开始导入前调用）
+     *
+     * 续传时上次已提交的序列不会重复写入；不续传而再次导入到同一张序列表时
+     * 也只追加新出现的序列。用服务端游标分批读取，客户端内存只取决于不同序列的条数。
+     */
+    void preload(pqxx::connection& conn, bool verbose) {
+        pqxx::work t(conn);
+        t.exec("DECLARE seq_keys NO SCROLL CURSOR FOR SELECT crc64, seq_hash FROM " +
+               t.esc(seqs_->table()) + ";");
+        std::size_t n = 0;
+        for (;;) {
+            pqxx::result r = t.exec("FETCH FORWARD 100000 FROM seq_keys;");
+            if (r.empty()) break;
+            for (const auto& row : r)
+                seen_.insert(parse_crc64(row[0].view()),
+                             static_cast<std::uint64_t>(row[1].as<std::int64_t>()));
+            n += r.size();
+        }
+        t.commit();
+        if (verbose) std::cout << "⏩ Loaded " << n << " stored sequence keys\n";
+    }
+
+private:
+    std::unique_ptr<TableSink> refs_;
+    std::unique_ptr<TableSink> seqs_;
+    SequenceKeySet seen_;
+};
+
+// ================= 增量更新 =================
+
+/// 增量更新时各表的暂存表
+static std::string delta_table(const std::string& table) { return table + "_delta"; }
+
+/**
+ * @brief 上一版本的条目状态（主 accession → entry_id + 内容哈希），增量更新时在内存中比对。
+ *
+ * 以主 accession 的 64 位哈希开放寻址（线性探测，装载率超过 1/2 时扩容）；accession
+ * 字符串依次存放在一块连续缓冲区中，探测时比较哈希与 accession 本身，哈希碰撞的
+ * 不同条目各占一个槽。约 100 字节 / 条目。visit 命中时同时标记该条目，
+ * 扫描结束后未被标记的即为新版本中已消失的条目。
+ */
+class EntryStateMap {
+public:
+    struct State {
+        std::uint64_t key = 0;  // 0 表示空槽
+        std::uint64_t hash = 0;
+        std::int64_t entry_id = 0;
+        std::uint64_t accession = 0;  // accessions_ 中的偏移 << 8 | 长度
     };
 
-    open_stream(tx, writer);
+    /// 载入一条状态；同一个 accession 出现两次时抛出 runtime_error
+    void insert(std::string_view accession, std::uint64_t hash, std::int64_t entry_id) {
+        if (accession.size() > 0xff)
+            throw std::runtime_error("❌ Accession too long in entry state table: " +
+                                     std::string(accession));
+        if ((size_ + 1) * 2 > slots_.size()) grow();
+        std::uint64_t k = key(accession);
+        std::size_t mask = slots_.size() - 1;
+        std::size_t i = slot(k, mask);
+        for (; slots_[i].key != 0; i = (i + 1) & mask) {
+            if (slots_[i].key == k && accession_of(slots_[i]) == accession)
+                throw std::runtime_error("❌ Duplicate accession in entry state table: " +
+                                         std::string(accession));
+        }
+        std::uint64_t ref = static_cast<std::uint64_t>(accessions_.size()) << 8 | accession.size();
+        accessions_.append(accession);
+        slots_[i] = {k, hash, entry_id, ref};
+        size_++;
+        max_entry_id_ = std::max(max_entry_id_, entry_id);
+    }
 
-    auto start_time = std::chrono::steady_clock::now();
-    std::vector<std::string> accessions;
-
-    while (gzgets(gzfile, buffer, BUF_SIZE)) {
-        line = buffer;
-        line.erase(std::remove(line.begin(), line.end(), '\n'), line.end());
-        if (!line.empty() && line.back() == '.')
-            line.pop_back();
-        processed_bytes += strlen(buffer);
-
-        // 获取 accession !多AC问题需要处理
-        if (line.rfind("AC   ", 0) == 0) {
-            for (std::sregex_iterator it(line.begin(), line.end(), ac_regex), end; it != end; ++it) {
-                accessions.push_back((*it)[1]);
+    /// 查找并标记；上一版本中没有该条目时返回 nullptr
+    const State* visit(std::string_view accession) {
+        if (slots_.empty()) return nullptr;
+        std::uint64_t k = key(accession);
+        std::size_t mask = slots_.size() - 1;
+        for (std::size_t i = slot(k, mask); slots_[i].key != 0; i = (i + 1) & mask) {
+            if (slots_[i].key == k && accession_of(slots_[i]) == accession) {
+                visited_[i] = true;
+                return &slots_[i];
             }
-            continue;
         }
+        return nullptr;
+    }
 
-        // 解析 DR 行
-        if (line.rfind("DR   ", 0) == 0) {
-            std::smatch m;
-            db_name.clear(); db_id.clear(); desc.clear(); evidence.clear();
+    /// 把未被 visit 过的条目的 entry_id 追加到 out
+    void unvisited(std::vector<std::int64_t>& out) const {
+        for (std::size_t i = 0; i < slots_.size(); ++i)
+            if (slots_[i].key != 0 && !visited_[i]) out.push_back(slots_[i].entry_id);
+    }
 
-            if (std::regex_search(line, m, dr_regex)) {
-                db_name = m[1].matched ? m[1].str() : "";
-                db_id   = m[2].matched ? m[2].str() : "";
-                desc    = m[3].matched ? m[3].str() : "";
-                evidence= m[4].matched ? m[4].str() : "";
-            }
+    std::size_t size() const { return size_; }
+    std::int64_t max_entry_id() const { return max_entry_id_; }
 
-            if (!db_name.empty() && !accessions.empty()) {
-                for (const auto &acc : accessions) {
-                    writer->write_values(acc, db_name, db_id, desc, evidence);
-                    written++;
-                }
-            }
+    /// 从状态表载入（服务端游标分批读取），须在任何 visit 之前调用
+    void load(pqxx::connection& conn, const std::string& table, bool verbose) {
+        pqxx::work t(conn);
+        t.exec("DECLARE entry_state NO SCROLL CURSOR FOR"
+               " SELECT accession, entry_id, entry_hash FROM " + t.esc(table) + ";");
+        for (;;) {
+            pqxx::result r = t.exec("FETCH FORWARD 100000 FROM entry_state;");
+            if (r.empty()) break;
+            for (const auto& row : r)
+                insert(row[0].view(), static_cast<std::uint64_t>(row[2].as<std::int64_t>()),
+                       row[1].as<std::int64_t>());
+        }
+        t.commit();
+        if (verbose) std::cout << "⏩ Loaded " << size_ << " entry states from " << table << "\n";
+    }
 
-            if (written % batch_commit == 0) {
-                close_stream(tx, writer);
-                open_stream(tx, writer);
-            }
+private:
+    static std::uint64_t key(std::string_view accession) {
+        std::uint64_t k = scan::hash_finish(scan::hash_bytes(0, accession));
+        return k == 0 ? 1 : k;
+    }
+
+    static std::size_t slot(std::uint64_t key, std::size_t mask) {
+        return static_cast<std::size_t>(key) & mask;  // 键本身已是打散后的哈希
+    }
+
+    std::string_view accession_of(const State& st) const {
+        return std::string_view(accessions_).substr(st.accession >> 8, st.accession & 0xff);
+    }
+
+    void grow() {
+        std::vector<State> old(std::max<std::size_t>(slots_.size() * 2, 1 << 16));
+        old.swap(slots_);
+        visited_.assign(slots_.size(), false);
+        std::size_t mask = slots_.size() - 1;
+        for (const auto& st : old) {
+            if (st.key == 0) continue;
+            std::size_t i = slot(st.key, mask);
+            while (slots_[i].key != 0) i = (i + 1) & mask;
+            slots_[i] = st;
         }
+    }
 
-        // 新条目时清空 accession
-        if (line.rfind("//", 0) == 0) {
-            accessions.clear();
-            continue;
+    std::vector<State> slots_;
+    std::vector<bool> visited_;
+    std::string accessions_;  // 全部 accession 首尾相接
+    std::size_t size_ = 0;
+    std::int64_t max_entry_id_ = 0;
+};
+
+/**
+ * @brief 增量更新的写入端：按条目缓冲 FT / DR / SQ 记录，条目的 EntryRecord 到达时
+ *        与上一版本的内容哈希比较，只把新增或变化的条目转发给各暂存表的 sink。
+ *
+ * 变化条目的旧 entry_id 记入 stale()，finish() 时再补上已消失的条目，
+ * 由 apply_incremental 删除这些旧行。未变化的条目只转发 end_entry，
+ * 各 sink 的条目序号（即新行的 entry_id）仍与文件中的位置一致。
+ */
+class IncrementalSink : public TableSink {
+public:
+    IncrementalSink(EntryStateMap& previous,
+                    std::unique_ptr<TableSink> ft, std::unique_ptr<TableSink> dr,
+                    std::unique_ptr<TableSink> sq, std::unique_ptr<TableSink> acc,
+                    std::unique_ptr<TableSink> state)
+        : previous_(previous), ft_(std::move(ft)), dr_(std::move(dr)), sq_(std::move(sq)),
+          acc_(std::move(acc)), state_(std::move(state)) {
+        for (auto* s : {ft_.get(), dr_.get(), sq_.get(), acc_.get(), state_.get()})
+            if (s) sinks_.push_back(s);
+    }
+
+    void write(const FtRecord& r) override { buffer_.write(r); }
+    void write(const DrRecord& r) override { buffer_.write(r); }
+    void write(const SqRecord& r) override { buffer_.write(r); }
+
+    void write(const EntryRecord& r) override {
+        const auto* old = previous_.visit(r.accessions.substr(0, r.accessions.find(';')));
+        if (old && old->hash == r.content_hash) {
+            unchanged_++;
+            return;
         }
-        if (line.rfind("ID   ", 0) == 0) {
-            accessions.clear();
-            continue;
+        if (old) {
+            stale_.push_back(old->entry_id);
+            changed_++;
+        } else {
+            added_++;
+        }
+        buffer_.replay(ft_.get(), dr_.get(), sq_.get());
+        acc_->write(r);
+        state_->write(r);
+    }
+
+    void end_entry() override {
+        buffer_.clear();
+        for (auto* s : sinks_) s->end_entry();
+    }
+
+    void finish() override {
+        for (auto* s : sinks_) s->finish();
+        std::size_t before = stale_.size();
+        previous_.unvisited(stale_);
+        removed_ = stale_.size() - before;
+    }
+
+    const std::string& table() const override { return state_->table(); }
+    std::size_t written() const override { return state_->written(); }
+    void collect(TableMetrics& out) const override { state_->collect(out); }
+
+    void tables(std::vector<const TableSink*>& out) const override {
+        for (const auto* s : sinks_) s->tables(out);
+    }
+
+    /// 需要删除旧行的 entry_id（变化与消失的条目）
+    const std::vector<std::int64_t>& stale() const { return stale_; }
+
+    std::size_t added() const { return added_; }
+    std::size_t changed() const { return changed_; }
+    std::size_t unchanged() const { return unchanged_; }
+    std::size_t removed() const { return removed_; }
+
+private:
+    EntryStateMap& previous_;
+    std::unique_ptr<TableSink> ft_, dr_, sq_, acc_, state_;
+    std::vector<TableSink*> sinks_;
+    RecordBuffer buffer_;  // 当前条目的 FT / DR / SQ 记录
+    std::vector<std::int64_t> stale_;
+    std::size_t added_ = 0, changed_ = 0, unchanged_ = 0, removed_ = 0;
+};
+
+/**
+ * @brief 增量更新前的准备：建立正式表（含 entry_id 索引），并重建各表的暂存表
+ *        （UNLOGGED、不带主键，与 bulk_load 的表相同）。
+ *
+ * SEQ 表按 CRC64 在各版本间共享，新序列直接追加，不经过暂存表。
+ */
+static void prepare_incremental(pqxx::connection& conn,
+                                const std::vector<std::pair<std::string, Section>>& targets) {
+    for (const auto& [table, section] : targets) {
+        ensure_table(conn, table, section, false, true);
+        if (section == Section::SEQ) continue;
+        {
+            pqxx::work t(conn);
+            std::string index = "idx_" + table + "_entry_id";
+            t.exec("CREATE INDEX IF NOT EXISTS " + t.esc(index) + " ON " +
+                   t.esc(table) + " USING btree (entry_id);");
+            t.exec("DROP TABLE IF EXISTS " + t.esc(delta_table(table)) + ";");
+            t.commit();
+        }
+        ensure_table(conn, delta_table(table), section, true, true);
+    }
+}
+
+/**
+ * @brief 把暂存表合并进正式表，并删除暂存表。
+ *
+ * 全部在一个事务中完成，失败时正式表保持上一版本不变：
+ * 先从各表删除 stale 中的旧 entry_id（变化与消失的条目），再插入暂存表的全部行；
+ * 状态表按主 accession upsert（同一文件中主 accession 重复时保留最后一个条目）。
+ */
+static void apply_incremental(const std::string& conn_str,
+                              const std::vector<std::pair<std::string, Section>>& targets,
+                              const std::vector<std::int64_t>& stale, bool verbose) {
+    auto start_time = std::chrono::steady_clock::now();
+    pqxx::connection conn(conn_str);
+    pqxx::work t(conn);
+    t.exec("CREATE TEMP TABLE uniprot_stale_entry (entry_id BIGINT) ON COMMIT DROP;");
+    {
+        auto stream = pqxx::stream_to::raw_table(t, "uniprot_stale_entry", "entry_id");
+        for (std::int64_t id : stale) stream.write_values(id);
+        stream.complete();
+    }
+    t.exec("ANALYZE uniprot_stale_entry;");
+
+    for (const auto& [table, section] : targets) {
+        if (section == Section::SEQ) continue;
+        std::string columns;
+        for (const auto& c : column_names(section, true)) {
+            if (!columns.empty()) columns += ", ";
+            columns += c;
+        }
+        std::string delta = delta_table(table);
+        if (verbose) std::cout << "🔧 Merging " << delta << " into " << table << "\n" << std::flush;
+
+        t.exec("DELETE FROM " + t.esc(table) + " AS d USING uniprot_stale_entry AS s"
+               " WHERE d.entry_id = s.entry_id;");
+        if (section == Section::STATE) {
+            t.exec("INSERT INTO " + t.esc(table) + " (" + columns + ")"
+                   " SELECT DISTINCT ON (accession) " + columns + " FROM " + t.esc(delta) +
+                   " ORDER BY accession, entry_id DESC"
+                   " ON CONFLICT (accession) DO UPDATE SET"
+                   " entry_id = EXCLUDED.entry_id, entry_hash = EXCLUDED.entry_hash;");
+        } else {
+            t.exec("INSERT INTO " + t.esc(table) + " (" + columns + ")"
+                   " SELECT " + columns + " FROM " + t.esc(delta) + ";");
+        }
+        t.exec("DROP TABLE " + t.esc(delta) + ";");
+    }
+    t.commit();
+
+    auto total_s = std::chrono::duration_cast<std::chrono::seconds>(
+                       std::chrono::steady_clock::now() - start_time).count();
+    if (verbose)
+        std::cout << "✅ Incremental update applied (" << total_s << "s elapsed)\n";
+}
+
+/// 各段落 Parquet 文件的列，与 PostgreSQL 表的数据列一致；重复度高的字符串列尝试字典编码
+static std::vector<ParquetWriter::Column> parquet_columns(Section section) {
+    using T = ParquetWriter::Type;
+    switch (section) {
+    case Section::FT:
+        return {{"accession", T::STRING, true},
+                {"feature_type", T::STRING, true},
+                {"start_pos", T::INT32},
+                {"end_pos", T::INT32},
+                {"note", T::STRING, true},
+                {"evidence", T::STRING, true}};
+    case Section::DR:
+        return {{"accession", T::STRING, true},
+                {"db_name", T::STRING, true},
+                {"db_id", T::STRING, true},
+                {"description", T::STRING, true},
+                {"evidence", T::STRING, true}};
+    case Section::SQ:
+        return {{"accession", T::STRING},
+                {"length", T::INT32},
+                {"mol_weight", T::INT32},
+                {"crc64", T::STRING},
+                {"sequence", T::STRING}};
+    case Section::SQ_REF:
+    case Section::SEQ:
+    case Section::ACC:
+    case Section::STATE:
+        break;  // 去重 / 规范化 / 增量模式只用于 PostgreSQL
+    }
+    return {};
+}
+
+/**
+ * @brief Parquet 文件写入端：与 COPY 写入端共用 run_import，不连接 PostgreSQL。
+ *
+ * 每写满一个行组计为一次 flush，关闭文件（写 footer）计为一次 commit。
+ * FT 的 start_pos / end_pos 转换为 INT32（与二进制 COPY 相同，超出范围时抛出异常）。
+ */
+class ParquetTableSink : public TableSink {
+public:
+    ParquetTableSink(const std::string& path, Section section,
+                     ParquetWriter::Codec codec, std::size_t row_group_rows)
+        : path_(path), out_(path, parquet_columns(section), codec, row_group_rows) {
+        out_.set_stats(&stats_);
+    }
+
+    void write(const FtRecord& r) override {
+        out_.text(r.accession);
+        out_.text(r.feature_type);
+        out_.int4(scan::to_int(r.start_pos));
+        out_.int4(scan::to_int(r.end_pos));
+        out_.text(r.note);
+        out_.text(r.evidence);
+        end_row();
+    }
+
+    void write(const DrRecord& r) override {
+        out_.text(r.accession);
+        out_.text(r.db_name);
+        out_.text(r.db_id);
+        out_.text(r.description);
+        out_.text(r.evidence);
+        end_row();
+    }
+
+    void write(const SqRecord& r) override {
+        out_.text(r.accession);
+        out_.int4(r.length);
+        out_.int4(r.mol_weight);
+        out_.text(r.crc64);
+        out_.text(r.sequence);
+        end_row();
+    }
+
+    void finish() override {
+        auto start = std::chrono::steady_clock::now();
+        out_.close();
+        stats_.add_commit(std::chrono::steady_clock::now() - start);
+    }
+
+    const std::string& table() const override { return path_; }
+    std::size_t written() const override { return out_.rows(); }
+
+    void collect(TableMetrics& out) const override {
+        out.table = path_;
+        stats_.collect(out);
+    }
+
+private:
+    void end_row() {
+        out_.end_row();
+        stats_.add_row();
+    }
+
+    std::string path_;
+    CopyStats stats_;
+    ParquetWriter out_;
+};
+
+/**
+ * @brief 按固定时间间隔把指标快照交给回调。
+ *
+ * 读取进度由解析线程通过 update_read 更新，写入统计直接读取各 sink 的
+ * 原子计数器，因此即使解析线程正阻塞在 COPY 或提交上也能按时汇报。
+ * 定时汇报在独立线程中进行；切换阶段（set_phase）和 finish() 时在调用线程中
+ * 同步汇报一次。回调之间互斥，不会并发执行。
+ * 定时线程中回调抛出的异常会停止定时汇报，并在 finish() 中重新抛出。
+ */
+class MetricsReporter {
+public:
+    MetricsReporter(MetricsCallback callback, double interval_s)
+        : callback_(std::move(callback)),
+          interval_(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+              std::chrono::duration<double>(std::max(interval_s, 0.01)))),
+          start_(std::chrono::steady_clock::now()) {
+        if (callback_) timer_ = std::thread([this] { run(); });
+    }
+
+    ~MetricsReporter() { stop_timer(); }
+
+    MetricsReporter(const MetricsReporter&) = delete;
+    MetricsReporter& operator=(const MetricsReporter&) = delete;
+
+    void set_sinks(const std::vector<TableSink*>& sinks) {
+        std::lock_guard<std::mutex> lk(mu_);
+        sinks_.clear();
+        for (const auto* s : sinks) s->tables(sinks_);
+    }
+
+    /// sinks 即将销毁：保存它们最后的统计，之后的快照沿用
+    void detach_sinks() {
+        std::lock_guard<std::mutex> lk(mu_);
+        frozen_ = collect_tables();
+        sinks_.clear();
+    }
+
+    void update_read(const ReadProgress& p) {
+        std::lock_guard<std::mutex> lk(mu_);
+        read_ = p;
+    }
+
+    /// 切换阶段并立即汇报一次
+    void set_phase(const char* phase) {
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            phase_ = phase;
         }
+        report();
+    }
 
-        // 进度显示
-        if (verbose && written % 10000 == 0) {
-            double ratio = total_bytes ? (double)processed_bytes / total_bytes : 0.0;
-            auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(
-                               std::chrono::steady_clock::now() - start_time)
-                               .count();
-            double rate = elapsed > 0 ? processed_bytes / (1024.0 * 1024.0 * elapsed) : 0.0;
-            std::cerr << "\r[" << std::setw(6) << std::fixed << std::setprecision(2)
-                      << ratio * 100 << "%] "
-                      << processed_bytes / (1024 * 1024) << "MB / "
-                      << total_bytes / (1024 * 1024) << "MB, Imported: "
-                      << written << " | Speed: " << std::fixed << std::setprecision(2)
-                      << rate << " MB/s" << std::flush;
+    /// 停止定时汇报（之后只有 set_phase / finish 时的同步汇报）
+    void stop_timer() {
+        if (!timer_.joinable()) return;
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            stopping_ = true;
         }
+        cv_.notify_all();
+        timer_.join();
+    }
+
+    /// 导入全部结束：发送 phase = "done" 的最后一次快照
+    void finish() {
+        stop_timer();
+        if (error_) std::rethrow_exception(error_);
+        set_phase("done");
+    }
+
+private:
+    std::vector<TableMetrics> collect_tables() const {
+        if (sinks_.empty()) return frozen_;
+        std::vector<TableMetrics> out(sinks_.size());
+        for (std::size_t i = 0; i < sinks_.size(); ++i) sinks_[i]->collect(out[i]);
+        return out;
     }
 
-    close_stream(tx, writer);
-    gzclose(gzfile);
+    ImportMetrics snapshot() {
+        std::lock_guard<std::mutex> lk(mu_);
+        ImportMetrics m;
+        m.phase = phase_;
+        m.elapsed_seconds = std::chrono::duration<double>(
+                                std::chrono::steady_clock::now() - start_).count();
+        m.compressed_bytes = read_.compressed_bytes;
+        m.total_bytes = read_.total_bytes;
+        m.inflated_bytes = read_.inflated_bytes;
+        m.parsed_bytes = read_.parsed_bytes;
+        m.entries = read_.entries;
+        m.parse_errors = read_.parse_errors;
+        m.tables = collect_tables();
+        return m;
+    }
+
+    void report() {
+        if (!callback_) return;
+        std::lock_guard<std::mutex> lk(callback_mu_);
+        callback_(snapshot());
+    }
+
+    void run() {
+        try {
+            std::unique_lock<std::mutex> lk(mu_);
+            while (!cv_.wait_for(lk, interval_, [&] { return stopping_; })) {
+                lk.unlock();
+                report();
+                lk.lock();
+            }
+        } catch (...) {
+            error_ = std::current_exception();
+        }
+    }
+
+    MetricsCallback callback_;
+    std::chrono::steady_clock::duration interval_;
+    std::chrono::steady_clock::time_point start_;
+
+    std::mutex mu_;           // 保护以下状态
+    std::condition_variable cv_;
+    std::string phase_ = "import";
+    ReadProgress read_;
+    std::vector<const TableSink*> sinks_;
+    std::vector<TableMetrics> frozen_;
+    bool stopping_ = false;
+
+    std::mutex callback_mu_;  // 回调互斥
+    std::exception_ptr error_;
+    std::thread timer_;
+};
+
+/// verbose 时的进度行（百分比、速率、ETA），由 MetricsReporter 按时间间隔调用
+static void print_progress(const ImportMetrics& m) {
+    if (m.phase != "import" && m.phase != "finish") return;
+    std::size_t written = 0;
+    for (const auto& t : m.tables) written += t.rows;
+
+    double ratio = m.total_bytes ? (double)m.compressed_bytes / m.total_bytes : 0.0;
+    double elapsed = m.elapsed_seconds;
+    double rate = elapsed > 0 ? m.parsed_bytes / (1024.0 * 1024.0 * elapsed) : 0.0;
+    double eta = (ratio > 0 && elapsed > 0)
+                     ? elapsed * (1.0 - ratio) / ratio
+                     : 0.0;
+
+    std::cerr << "\r[" << std::setw(6) << std::fixed << std::setprecision(2)
+              << ratio * 100 << "%] "
+              << m.compressed_bytes / (1024 * 1024) << "MB / "
+              << m.total_bytes / (1024 * 1024) << "MB, "
+              << "Imported: " << written
+              << " | Speed: " << std::fixed << std::setprecision(2)
+              << rate << " MB/s"
+              << " | ETA: " << std::fixed << std::setprecision(1)
+              << eta << "s";
+    if (m.parse_errors > 0) std::cerr << " | Parse errors: " << m.parse_errors;
+    std::cerr << "   " << std::flush;
+}
+
+/// verbose 进度行与用户回调共用同一个定时汇报（都不需要时返回空回调，不启动定时线程）
+static MetricsCallback metrics_callback(bool verbose, const MetricsCallback& on_metrics) {
+    if (!verbose && !on_metrics) return nullptr;
+    return [verbose, on_metrics](const ImportMetrics& m) {
+        if (verbose) print_progress(m);
+        if (on_metrics) on_metrics(m);
+    };
+}
+
+/**
+ * @brief 解压并解析 gz_path，所有 sink 共享同一次解压。
+ *
+ * num_threads > 1 时使用多线程解压/解析流水线（见 parse_uniprot_gz）；
+ * 单连接时 COPY 写入在调用线程中进行，多连接时由各分区的写入线程进行。
+ * 每处理一块（约 4MB）向 reporter 更新一次读取进度。
+ * acc（可为空）接收每个条目的 EntryRecord，即规范化模式下的 ACC 表。
+ * 同一个 sink 可以同时作为多个参数传入（如增量模式的 IncrementalSink）。
+ */
+static void run_import(const std::string& gz_path,
+                       TableSink* ft, TableSink* dr, TableSink* sq, TableSink* acc,
+                       unsigned num_threads, std::size_t skip_entries,
+                       MetricsReporter& reporter) {
+    std::vector<TableSink*> sinks;
+    for (auto* s : {ft, dr, sq, acc})
+        if (s && std::find(sinks.begin(), sinks.end(), s) == sinks.end()) sinks.push_back(s);
+    reporter.set_sinks(sinks);
+
+    auto start_time = std::chrono::steady_clock::now();
+
+    try {
+        parse_uniprot_gz(gz_path, ft, dr, sq, num_threads,
+                         [&](const ReadProgress& p) { reporter.update_read(p); },
+                         skip_entries, acc);
+        reporter.set_phase("finish");
+        for (auto* s : sinks) s->finish();
+    } catch (...) {
+        reporter.detach_sinks();
+        throw;
+    }
+    reporter.detach_sinks();
+    reporter.stop_timer();
 
     auto end_time = std::chrono::steady_clock::now();
     auto total_s = std::chrono::duration_cast<std::chrono::seconds>(end_time - start_time).count();
 
-    std::cout << "\n✅ Completed DR import into table: " << table_name
-              << " in " << total_s << "s.\n";
+    std::vector<const TableSink*> tables;
+    for (const auto* s : sinks) s->tables(tables);
+    std::cout << "\n";
+    for (const auto* s : tables) {
+        std::cout << "✅ Completed import into table: " << s->table()
+                  << " (" << s->written() << " rows, "
+                  << total_s << "s elapsed)\n";
+    }
 }
 
-void UniprotImporter::sq_stream_parse_and_copy(
+void UniprotImporter::ft_stream_parse_and_copy(
     const std::string& gz_path,
     const std::string& table_name,
     const std::string& dbname,
@@ -395,160 +1649,293 @@ void UniprotImporter::sq_stream_parse_and_copy(
     const std::string& host,
     const std::string& port,
     std::size_t batch_commit,
-    bool verbose
+    bool verbose,
+    unsigned num_threads,
+    bool binary_copy,
+    unsigned num_connections,
+    bool hash_partition,
+    bool bulk_load,
+    bool resume,
+    const MetricsCallback& on_metrics,
+    double metrics_interval,
+    const std::string& accession_table,
+    std::int64_t entry_id_base
 ) {
-    // ---------- 数据库连接 ----------
-    std::string conn_str =
-        "dbname=" + dbname + " user=" + user + " password=" + password +
-        " host=" + host + " port=" + port;
-    pqxx::connection conn(conn_str);
-    if (!conn.is_open())
-        throw std::runtime_error("❌ Cannot connect to PostgreSQL");
-
-    // ---------- 建表 ----------
-    {
-        pqxx::work t(conn);
-        t.exec(
-            "CREATE TABLE IF NOT EXISTS " + t.esc(table_name) + " ("
-            "  id SERIAL PRIMARY KEY,"
-            "  accession TEXT,"
-            "  length INT,"
-            "  mol_weight INT,"
-            "  crc64 TEXT,"
-            "  sequence TEXT"
-            ");"
-        );
-        t.commit();
-    }
-
-    // ---------- 打开 gzip ----------
-    gzFile gzfile = gzopen(gz_path.c_str(), "rb");
-    if (!gzfile)
-        throw std::runtime_error("❌ Cannot open gzip file: " + gz_path);
-
-    // 获取文件大小，用于进度估计
-    struct stat st;
-    size_t total_bytes = 0;
-    if (stat(gz_path.c_str(), &st) == 0)
-        total_bytes = st.st_size;
-
-    const size_t BUF_SIZE = 16384;
-    char buffer[BUF_SIZE];
-    std::string line, accession, seq, crc64;
-    int length = 0, mw = 0;
-    bool in_seq = false;
-
-    std::regex ac_regex(R"(AC\s+([A-Z0-9]+);)");
-    std::regex sq_header_regex(R"(SQ\s+SEQUENCE\s+(\d+)\s+AA;\s+(\d+)\s+MW;\s+([A-F0-9]+)\s+CRC64;)");
-    std::regex seq_line_regex(R"(^\s{5}([A-Z\s]+))");
-
-    std::unique_ptr<pqxx::work> tx;
-    std::unique_ptr<pqxx::stream_to> writer;
-
-    auto open_stream = [&](std::unique_ptr<pqxx::work>& tx,
-                           std::unique_ptr<pqxx::stream_to>& writer) {
-        tx = std::make_unique<pqxx::work>(conn);
-        pqxx::table_path path{table_name};
-        writer = std::make_unique<pqxx::stream_to>(
-            pqxx::stream_to::table(*tx, path,
-                {"accession", "length", "mol_weight", "crc64", "sequence"})
-        );
-    };
-
-    auto close_stream = [&](std::unique_ptr<pqxx::work>& tx,
-                            std::unique_ptr<pqxx::stream_to>& writer) {
-        if (writer) { writer->complete(); writer.reset(); }
-        if (tx)     { tx->commit(); tx.reset(); }
-    };
+    multi_stream_parse_and_copy(gz_path, table_name, "", "", dbname, user,
+                                password, host, port, batch_commit, verbose,
+                                num_threads, binary_copy, num_connections,
+                                hash_partition, bulk_load, resume, on_metrics,
+                                metrics_interval, false, accession_table, entry_id_base);
+}
 
-    open_stream(tx, writer);
+void UniprotImporter::dr_stream_parse_and_copy(
+    const std::string& gz_path,
+    const std::string& table_name,
+    const std::string& dbname,
+    const std::string& user,
+    const std::string& password,
+    const std::string& host,
+    const std::string& port,
+    std::size_t batch_commit,
+    bool verbose,
+    unsigned num_threads,
+    bool binary_copy,
+    unsigned num_connections,
+    bool hash_partition,
+    bool bulk_load,
+    bool resume,
+    const MetricsCallback& on_metrics,
+    double metrics_interval,
+    const std::string& accession_table,
+    std::int64_t entry_id_base
+) {
+    multi_stream_parse_and_copy(gz_path, "", table_name, "", dbname, user,
+                                password, host, port, batch_commit, verbose,
+                                num_threads, binary_copy, num_connections,
+                                hash_partition, bulk_load, resume, on_metrics,
+                                metrics_interval, false, accession_table, entry_id_base);
+}
 
-    size_t written = 0;
-    size_t processed_bytes = 0;
-    auto start_time = std::chrono::steady_clock::now();
+void UniprotImporter::sq_stream_parse_and_copy(
+    const std::string& gz_path,
+    const std::string& table_name,
+    const std::string& dbname,
+    const std::string& user,
+    const std::string& password,
+    const std::string& host,
+    const std::string& port,
+    std::size_t batch_commit,
+    bool verbose,
+    unsigned num_threads,
+    bool binary_copy,
+    unsigned num_connections,
+    bool hash_partition,
+    bool bulk_load,
+    bool resume,
+    const MetricsCallback& on_metrics,
+    double metrics_interval,
+    bool dedup_sequences,
+    const std::string& accession_table,
+    std::int64_t entry_id_base
+) {
+    multi_stream_parse_and_copy(gz_path, "", "", table_name, dbname, user,
+                                password, host, port, batch_commit, verbose,
+                                num_threads, binary_copy, num_connections,
+                                hash_partition, bulk_load, resume, on_metrics,
+                                metrics_interval, dedup_sequences, accession_table,
+                                entry_id_base);
+}
 
-    // ---------- 主解析循环 ----------
-    while (gzgets(gzfile, buffer, BUF_SIZE)) {
-        line = buffer;
-        line.erase(std::remove(line.begin(), line.end(), '\n'), line.end());
-        processed_bytes += strlen(buffer);
-
-        // 捕获 accession
-        if (line.rfind("AC   ", 0) == 0) {
-            std::smatch m;
-            if (std::regex_search(line, m, ac_regex))
-                accession = m[1];
-            continue;
+void UniprotImporter::multi_stream_parse_and_copy(
+    const std::string& gz_path,
+    const std::string& ft_table,
+    const std::string& dr_table,
+    const std::string& sq_table,
+    const std::string& dbname,
+    const std::string& user,
+    const std::string& password,
+    const std::string& host,
+    const std::string& port,
+    std::size_t batch_commit,
+    bool verbose,
+    unsigned num_threads,
+    bool binary_copy,
+    unsigned num_connections,
+    bool hash_partition,
+    bool bulk_load,
+    bool resume,
+    const MetricsCallback& on_metrics,
+    double metrics_interval,
+    bool dedup_sequences,
+    const std::string& accession_table,
+    std::int64_t entry_id_base,
+    const std::string& state_table
+) {
+    if (ft_table.empty() && dr_table.empty() && sq_table.empty())
+        throw std::invalid_argument("❌ At least one of ft_table / dr_table / sq_table is required");
+    bool normalized = !accession_table.empty();
+    if (normalized && entry_id_base < 1)
+        throw std::invalid_argument("❌ entry_id_base must be at least 1");
+    bool incremental = !state_table.empty();
+    if (incremental && !normalized)
+        throw std::invalid_argument("❌ Incremental update requires accession_table (normalized mode)");
+    if (incremental && (bulk_load || resume))
+        throw std::invalid_argument("❌ Incremental update cannot be combined with bulk_load or resume");
+    // 传给各 sink 的 entry_id 起点，0 表示非规范化模式
+    std::int64_t id_base = normalized ? entry_id_base : 0;
+
+    std::string conn_str = make_conn_str(dbname, user, password, host, port);
+    unsigned parts = std::max(num_connections, 1u);
+    std::string layout = parts == 1 ? "single"
+                                    : (hash_partition ? "hash/" : "entry/") + std::to_string(parts);
+
+    // ---------- 建表、读取断点（只在一个连接上执行一次） ----------
+    std::vector<std::pair<std::string, Section>> tables;
+    if (!ft_table.empty()) tables.emplace_back(ft_table, Section::FT);
+    if (!dr_table.empty()) tables.emplace_back(dr_table, Section::DR);
+    if (!sq_table.empty()) {
+        if (dedup_sequences) {
+            tables.emplace_back(sq_table, Section::SQ_REF);
+            tables.emplace_back(sq_table + "_seq", Section::SEQ);
+        } else {
+            tables.emplace_back(sq_table, Section::SQ);
         }
+    }
+    if (normalized) tables.emplace_back(accession_table, Section::ACC);
+
+    // 增量模式：tables 换成各表的暂存表（SEQ 表除外），targets 为最终合并进的正式表；
+    // 新条目的 entry_id 接在上一版本之后，与未变化条目保留的 entry_id 不冲突
+    std::vector<std::pair<std::string, Section>> targets;
+    EntryStateMap previous;
+    if (incremental) {
+        targets = tables;
+        targets.emplace_back(state_table, Section::STATE);
+        pqxx::connection ddl(conn_str);
+        if (!ddl.is_open())
+            throw std::runtime_error("❌ Cannot connect to PostgreSQL");
+        prepare_incremental(ddl, targets);
+        previous.load(ddl, state_table, verbose);
+        id_base = std::max(entry_id_base, previous.max_entry_id() + 1);
+        tables.clear();
+        for (const auto& [table, section] : targets)
+            tables.emplace_back(section == Section::SEQ ? table : delta_table(table), section);
+    }
 
-        // SQ header
-        if (line.rfind("SQ   ", 0) == 0) {
-            std::smatch m;
-            if (std::regex_search(line, m, sq_header_regex)) {
-                length = std::stoi(m[1]);
-                mw = std::stoi(m[2]);
-                crc64 = m[3];
-                seq.clear();
-                in_seq = true;
+    std::vector<ResumePoint> points(tables.size());
+    {
+        pqxx::connection ddl(conn_str);
+        if (!ddl.is_open())
+            throw std::runtime_error("❌ Cannot connect to PostgreSQL");
+        ensure_checkpoint_table(ddl);
+        for (std::size_t i = 0; i < tables.size(); ++i) {
+            const auto& [table, section] = tables[i];
+            ensure_table(ddl, table, section, bulk_load, normalized);
+            points[i].gz_path = gz_path;
+            points[i].layout = layout;
+            if (resume) {
+                points[i].parts = load_checkpoints(ddl, gz_path, table, layout, parts);
+            } else {
+                clear_checkpoints(ddl, gz_path, table);
+                points[i].parts.assign(parts, Checkpoint());
             }
-            continue;
         }
+    }
 
-        // 读取序列行
-        if (in_seq && line.rfind("     ", 0) == 0) {
-            std::smatch m;
-            if (std::regex_search(line, m, seq_line_regex)) {
-                std::string part = m[1];
-                part.erase(std::remove(part.begin(), part.end(), ' '), part.end());
-                seq += part;
-            }
+    // 所有未完成分区中最小的断点，即解析器需要开始送入的条目
+    std::size_t first_entry = std::numeric_limits<std::size_t>::max();
+    std::vector<std::size_t> pending_tables;
+    for (std::size_t i = 0; i < tables.size(); ++i) {
+        const auto& cps = points[i].parts;
+        if (std::all_of(cps.begin(), cps.end(), [](const Checkpoint& c) { return c.finished; })) {
+            std::cout << "✅ Already imported, skipping table: " << tables[i].first << "\n";
             continue;
         }
+        pending_tables.push_back(i);
+        for (const auto& c : cps) first_entry = std::min(first_entry, c.entries);
+    }
+    // 去重模式的两张表要一起写入：其中一张已完成时仍创建其 sink（只更新断点）
+    if (dedup_sequences && !sq_table.empty()) {
+        auto is_seq = [](const auto& t) { return t.second == Section::SEQ; };
+        std::size_t seq = std::find_if(tables.begin(), tables.end(), is_seq) - tables.begin();
+        std::size_t ref = seq - 1;
+        bool has_ref = std::count(pending_tables.begin(), pending_tables.end(), ref) > 0;
+        bool has_seq = std::count(pending_tables.begin(), pending_tables.end(), seq) > 0;
+        if (has_ref != has_seq) pending_tables.push_back(has_ref ? seq : ref);
+    }
 
-        // 条目结束
-        if (line.rfind("//", 0) == 0) {
-            if (in_seq && !accession.empty()) {
-                writer->write_values(accession, length, mw, crc64, seq);
-                written++;
-            }
-            in_seq = false;
-            accession.clear();
-            seq.clear();
-            crc64.clear();
-            continue;
+    MetricsReporter reporter(metrics_callback(verbose, on_metrics), metrics_interval);
+
+    if (!pending_tables.empty()) {
+        if (first_entry > 0)
+            std::cout << "⏩ Resuming from entry " << first_entry << "\n";
+
+        // ---------- 数据库连接：每张表 num_connections 个连接 ----------
+        std::unique_ptr<TableSink> sinks[3];
+        std::unique_ptr<TableSink> refs, seqs, accs, states;
+        for (std::size_t i : pending_tables) {
+            const auto& [table, section] = tables[i];
+            points[i].first_entry = first_entry;
+            auto sink = make_sink(conn_str, table, section, batch_commit, binary_copy,
+                                  num_connections, hash_partition, id_base, points[i]);
+            if (section == Section::ACC)
+                accs = std::move(sink);
+            else if (section == Section::STATE)
+                states = std::move(sink);
+            else if (section == Section::SQ_REF)
+                refs = std::move(sink);
+            else if (section == Section::SEQ)
+                seqs = std::move(sink);
+            else
+                sinks[static_cast<int>(section)] = std::move(sink);
         }
-
-        // 定期提交批次
-        if (written % batch_commit == 0 && written > 0) {
-            close_stream(tx, writer);
-            open_stream(tx, writer);
+        if (refs) {
+            auto dedup = std::make_unique<SequenceDedupSink>(std::move(refs), std::move(seqs));
+            pqxx::connection conn(conn_str);
+            dedup->preload(conn, verbose);
+            sinks[2] = std::move(dedup);
         }
 
-        // ---------- 实时进度 ----------
-        if (verbose && written % 1000 == 0 && written > 0) {
-            double ratio = total_bytes ? (double)processed_bytes / total_bytes : 0.0;
-            auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(
-                               std::chrono::steady_clock::now() - start_time).count();
-            double rate = elapsed > 0 ? processed_bytes / (1024.0 * 1024.0 * elapsed) : 0.0;
-            std::cerr << "\r[" << std::setw(6) << std::fixed << std::setprecision(2)
-                      << ratio * 100 << "%] "
-                      << processed_bytes / (1024 * 1024) << "MB / "
-                      << total_bytes / (1024 * 1024) << "MB, "
-                      << "Imported: " << written
-                      << " | Speed: " << std::fixed << std::setprecision(2)
-                      << rate << " MB/s" << std::flush;
+        if (incremental) {
+            bool want[3] = {!ft_table.empty(), !dr_table.empty(), !sq_table.empty()};
+            auto inc = std::make_unique<IncrementalSink>(
+                previous, std::move(sinks[0]), std::move(sinks[1]), std::move(sinks[2]),
+                std::move(accs), std::move(states));
+            run_import(gz_path, want[0] ? inc.get() : nullptr, want[1] ? inc.get() : nullptr,
+                       want[2] ? inc.get() : nullptr, inc.get(), num_threads, 0, reporter);
+            if (verbose)
+                std::cout << "🔁 Entries: " << inc->added() << " new, " << inc->changed()
+                          << " changed, " << inc->unchanged() << " unchanged, "
+                          << inc->removed() << " removed\n";
+            std::vector<std::int64_t> stale = inc->stale();
+            inc.reset();  // 先释放 COPY 连接
+
+            reporter.set_phase("merge");
+            apply_incremental(conn_str, targets, stale, verbose);
+            pqxx::connection ddl(conn_str);
+            for (const auto& [table, section] : tables) clear_checkpoints(ddl, gz_path, table);
+        } else {
+            run_import(gz_path, sinks[0].get(), sinks[1].get(), sinks[2].get(), accs.get(),
+                       num_threads, first_entry, reporter);
         }
     }
 
-    close_stream(tx, writer);
-    gzclose(gzfile);
+    // COPY 连接已在上面释放，再做 SET LOGGED（需要表级排他锁）
+    if (bulk_load) {
+        reporter.set_phase("index");
+        finish_bulk_tables(conn_str, tables, normalized, verbose);
+    }
+    reporter.finish();
+}
 
-    auto end_time = std::chrono::steady_clock::now();
-    auto total_s = std::chrono::duration_cast<std::chrono::seconds>(end_time - start_time).count();
+void UniprotImporter::multi_stream_parse_to_parquet(
+    const std::string& gz_path,
+    const std::string& ft_path,
+    const std::string& dr_path,
+    const std::string& sq_path,
+    bool verbose,
+    unsigned num_threads,
+    const std::string& compression,
+    std::size_t row_group_rows,
+    const MetricsCallback& on_metrics,
+    double metrics_interval
+) {
+    if (ft_path.empty() && dr_path.empty() && sq_path.empty())
+        throw std::invalid_argument("❌ At least one of ft_path / dr_path / sq_path is required");
+    ParquetWriter::Codec codec = ParquetWriter::parse_codec(compression);
 
-    std::cout << "\n✅ Completed SQ import into table: " << table_name
-              << " (" << written << " sequences, "
-              << total_s << "s elapsed)\n";
+    MetricsReporter reporter(metrics_callback(verbose, on_metrics), metrics_interval);
+    {
+        std::unique_ptr<TableSink> sinks[3];
+        const std::string* paths[3] = {&ft_path, &dr_path, &sq_path};
+        for (int i = 0; i < 3; ++i) {
+            if (paths[i]->empty()) continue;
+            sinks[i] = std::make_unique<ParquetTableSink>(*paths[i], static_cast<Section>(i),
+                                                          codec, row_group_rows);
+        }
+        run_import(gz_path, sinks[0].get(), sinks[1].get(), sinks[2].get(), nullptr,
+                   num_threads, 0, reporter);
+    }
+    reporter.finish();
 }
 
-} // namespace pmcad
\ No newline at end of file
+} // namespace pmcad
@@ -2,17 +2,31 @@
 #ifndef PMC_UNIPROT_IMPORTER_H
 #define PMC_UNIPROT_IMPORTER_H
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
+#include "import_metrics.h"
+
 namespace pmcad {
 
 /**
  * @class UniprotImporter
  * @brief 边解压边解析 UniProt .dat.gz，并以 COPY 模式写入 PostgreSQL。
  *
- * 通过 libpqxx::stream_to 实现高速流式导入，内存占用恒定。
+ * 通过 libpqxx::stream_to 实现高速流式导入，内存占用恒定；
+ * 也可通过 binary_copy 选择基于 libpq 的二进制 COPY（见 PgBinaryCopy），
+ * 通过 num_connections 把每张表分到多个连接并行 COPY；
+ * bulk_load 模式下先导入无主键的 UNLOGGED 表，结束后再建索引；
+ * 每次提交都记录断点，中断后可通过 resume 续传。
+ *
+ * 可选参数 verbose 用于打印进度条（百分比、速率、ETA），按时间间隔刷新；
+ * on_metrics 回调可获得结构化的指标（解压 / 解析字节数、各表行数、
+ * COPY 发送与提交耗时、解析错误数）。各导入函数共用的参数只在
+ * ft_stream_parse_and_copy 处说明。
  *
- * 可选参数 verbose 用于打印进度条（百分比、速率、ETA）。
+ * multi_stream_parse_to_parquet 使用同一套解析流程，但把结果写成 Parquet 文件，
+ * 不需要 PostgreSQL（见 ParquetWriter）。
  */
 class UniprotImporter {
 public:
@@ -31,6 +45,24 @@ public:
      * @param port 数据库端口号（默认 "5432"）
      * @param batch_commit 每次提交事务的记录数（默认 200,000）
      * @param verbose 是否打印实时进度（默认 true）
+     * @param num_threads 解压/解析线程数（默认 1；>1 时启用多线程流水线，
+     *        BGZF 文件可并行解压，普通 gzip 只并行解析）
+     * @param binary_copy 是否使用二进制 COPY（默认 false；INT 列直接以 int4 发送，
+     *        降低服务端解析开销）
+     * @param num_connections 每张表的连接 / COPY 流数（默认 1；>1 时各连接由独立线程写入，
+     *        batch_commit 分别作用于每个连接）
+     * @param hash_partition 多连接时按 accession 哈希分区（默认 false，按条目轮转）
+     * @param bulk_load 批量导入模式（默认 false）：建 UNLOGGED 表且不带 id 主键，
+     *        导入结束后 SET LOGGED 并并行建立 accession（DR 另加 db_id）索引
+     * @param resume 是否从上次中断处续传（默认 false）。每次批量提交时都会在同一事务内
+     *        记录断点（uniprot_import_checkpoint 表：已提交条目数、行数、最后一个 accession）；
+     *        续传要求 num_connections / hash_partition 与上次一致
+     * @param on_metrics 指标回调（可为空），每隔 metrics_interval 秒及每次切换阶段时
+     *        收到一份 ImportMetrics 快照，最后一次 phase 为 "done"（见 import_metrics.h）
+     * @param metrics_interval 汇报间隔（秒，默认 1.0；verbose 进度行也按此间隔刷新）
+     * @param accession_table 规范化模式的 entry_id ↔ accession 表名（默认空，不启用，
+     *        见 multi_stream_parse_and_copy）
+     * @param entry_id_base 规范化模式下第一个条目的 entry_id（默认 1）
      *
      * 表结构自动创建：
      *   id SERIAL PRIMARY KEY,
@@ -50,7 +82,17 @@ public:
         const std::string& host = "localhost",
         const std::string& port = "5432",
         std::size_t batch_commit = 200000,
-        bool verbose = true);
+        bool verbose = true,
+        unsigned num_threads = 1,
+        bool binary_copy = false,
+        unsigned num_connections = 1,
+        bool hash_partition = false,
+        bool bulk_load = false,
+        bool resume = false,
+        const MetricsCallback& on_metrics = nullptr,
+        double metrics_interval = 1.0,
+        const std::string& accession_table = "",
+        std::int64_t entry_id_base = 1);
 
     /**
      * @brief 从 UniProt .dat.gz 文件流式解析 DR (Database cross-reference) 段落并导入 PostgreSQL
@@ -85,6 +127,9 @@ public:
      * @param port 数据库端口号（默认 "5432"）
      * @param batch_commit 每次提交事务的记录数（默认 200,000）
      * @param verbose 是否打印实时进度（默认 true）
+     * @param num_threads, binary_copy, num_connections, hash_partition, bulk_load, resume,
+     *        on_metrics, metrics_interval 同 ft_stream_parse_and_copy
+     * @param accession_table, entry_id_base 同 ft_stream_parse_and_copy
      */
     static void dr_stream_parse_and_copy(
         const std::string& gz_path,
@@ -95,7 +140,17 @@ public:
         const std::string& host = "localhost",
         const std::string& port = "5432",
         std::size_t batch_commit = 200000,
-        bool verbose = true);
+        bool verbose = true,
+        unsigned num_threads = 1,
+        bool binary_copy = false,
+        unsigned num_connections = 1,
+        bool hash_partition = false,
+        bool bulk_load = false,
+        bool resume = false,
+        const MetricsCallback& on_metrics = nullptr,
+        double metrics_interval = 1.0,
+        const std::string& accession_table = "",
+        std::int64_t entry_id_base = 1);
     
     /**
      * @brief 从 UniProt .dat.gz 文件流式解析 SQ (Sequence) 段落并导入 PostgreSQL
@@ -132,6 +187,10 @@ public:
      * @param port 数据库端口号（默认 "5432"）
      * @param batch_commit 每次提交事务的记录数（默认 20,000）
      * @param verbose 是否打印实时进度（默认 true）
+     * @param num_threads, binary_copy, num_connections, hash_partition, bulk_load, resume,
+     *        on_metrics, metrics_interval 同 ft_stream_parse_and_copy
+     * @param dedup_sequences 序列去重模式（默认 false，见 multi_stream_parse_and_copy）
+     * @param accession_table, entry_id_base 同 ft_stream_parse_and_copy
      */
      static void sq_stream_parse_and_copy(
         const std::string& gz_path,
@@ -142,7 +201,129 @@ public:
         const std::string& host = "localhost",
         const std::string& port = "5432",
         std::size_t batch_commit = 20000,
-        bool verbose = true);
+        bool verbose = true,
+        unsigned num_threads = 1,
+        bool binary_copy = false,
+        unsigned num_connections = 1,
+        bool hash_partition = false,
+        bool bulk_load = false,
+        bool resume = false,
+        const MetricsCallback& on_metrics = nullptr,
+        double metrics_interval = 1.0,
+        bool dedup_sequences = false,
+        const std::string& accession_table = "",
+        std::int64_t entry_id_base = 1);
+
+    /**
+     * @brief 单次解压同时导入 FT / DR / SQ 三个段落
+     *
+     * 只解压、解析一遍 .dat.gz，三个段落分别通过各自的连接和 COPY 流
+     * 同时写入三张表；解析规则与上面三个独立函数完全一致。
+     * 表名传空字符串表示跳过该段落（至少指定一个）。
+     *
+     * @param gz_path 输入 gzip 文件路径 (.dat.gz)
+     * @param ft_table FT 目标表名（建议 *_ft，空则跳过）
+     * @param dr_table DR 目标表名（建议 *_dr，空则跳过）
+     * @param sq_table SQ 目标表名（建议 *_sq，空则跳过）
+     * @param dbname 数据库名
+     * @param user 数据库用户名
+     * @param password 数据库密码
+     * @param host 数据库主机地址（默认 "localhost"）
+     * @param port 数据库端口号（默认 "5432"）
+     * @param batch_commit 每张表每次提交事务的记录数（默认 200,000）
+     * @param verbose 是否打印实时进度（默认 true）
+     * @param num_threads, binary_copy, num_connections, hash_partition, bulk_load, resume,
+     *        on_metrics, metrics_interval 同 ft_stream_parse_and_copy
+     * @param dedup_sequences SQ 序列去重模式（默认 false）。TrEMBL 中大量条目的序列相同，
+     *        开启后 SQ 写入两张表：
+     *          sq_table：accession, length, mol_weight, crc64, seq_hash（不含序列）
+     *          sq_table + "_seq"：crc64, length, seq_hash, sequence BYTEA（每条不同序列
+     *            只存一次，5-bit 打包，见 sequence_codec.h；普通模式下
+     *            (crc64, length, seq_hash) 为主键）
+     *        seq_hash 为序列的 64 位摘要：CRC64 是线性校验和，不同序列可能碰撞，
+     *        因此以 (crc64, length, seq_hash) 标识序列，碰撞的序列各存一行，两表按这三列关联。
+     *        导入前载入 _seq 表中已有的序列键，再次导入或续传都不会重复写入；
+     *        客户端为每条不同序列保留约 32 字节。
+     *        文本 COPY 以十六进制发送 BYTEA，建议配合 binary_copy 使用
+     * @param accession_table 规范化模式（默认空，不启用）：每个条目分配一个 entry_id，
+     *        accession_table（entry_id BIGINT, accession TEXT, position INT）中每个条目的
+     *        每个 accession 一行（position 0 为主 accession，次要 accession 依次编号）；
+     *        FT / DR / SQ 表以 entry_id BIGINT 代替 accession 列，DR 每条 DR 行只写一行
+     *        （不再按 accession 个数重复）。bulk_load 时各表改为对 entry_id 建索引，
+     *        accession_table 对 accession、entry_id 建索引
+     * @param entry_id_base 第一个条目的 entry_id（默认 1）；entry_id = entry_id_base + 条目在
+     *        文件中的序号，续传时保持不变。多个文件导入同一组表时需错开
+     * @param state_table 增量更新模式（默认空，不启用；须同时指定 accession_table）：
+     *        state_table（accession TEXT PRIMARY KEY, entry_id BIGINT, entry_hash BIGINT）
+     *        记录每个条目的主 accession 及整个条目文本的 64 位内容哈希。导入新版本时：
+     *          - 载入 state_table 到内存（约 100 字节 / 条目），解析时逐条目比较哈希；
+     *          - 只有新增或内容变化的条目写入各表的 *_delta 暂存表（UNLOGGED），
+     *            新条目的 entry_id 接在 state_table 中最大的 entry_id 之后；
+     *          - 解析结束后在一个事务中删除变化条目与已消失条目的旧行，
+     *            插入暂存表的全部行，upsert state_table，随后删除暂存表。
+     *        未变化的条目保留原有的 entry_id 和行。第一次使用时 state_table 为空，
+     *        等同于完整导入。各表对 entry_id 建索引。去重模式的 _seq 表不经过暂存表，
+     *        新序列在解析过程中直接提交，不在合并事务内（导入失败时可能留下无人引用的序列）；
+     *        最后一个引用它的条目变化或删除后，序列也不会从 _seq 表中清除。
+     *        不能与 bulk_load / resume 同时使用
+     */
+    static void multi_stream_parse_and_copy(
+        const std::string& gz_path,
+        const std::string& ft_table,
+        const std::string& dr_table,
+        const std::string& sq_table,
+        const std::string& dbname,
+        const std::string& user,
+        const std::string& password,
+        const std::string& host = "localhost",
+        const std::string& port = "5432",
+        std::size_t batch_commit = 200000,
+        bool verbose = true,
+        unsigned num_threads = 1,
+        bool binary_copy = false,
+        unsigned num_connections = 1,
+        bool hash_partition = false,
+        bool bulk_load = false,
+        bool resume = false,
+        const MetricsCallback& on_metrics = nullptr,
+        double metrics_interval = 1.0,
+        bool dedup_sequences = false,
+        const std::string& accession_table = "",
+        std::int64_t entry_id_base = 1,
+        const std::string& state_table = "");
+
+    /**
+     * @brief 单次解压把 FT / DR / SQ 三个段落写成 Parquet 文件（不连接 PostgreSQL）
+     *
+     * 解析流程与 multi_stream_parse_and_copy 完全相同，只是写入端换成 ParquetWriter；
+     * 列名与类型与对应的数据库表一致（不含 id，INT 列为 INT32，其余为 UTF8 字符串）。
+     * accession / db_name / feature_type / evidence 等重复度高的列使用字典编码，
+     * 某个行组里几乎不重复的列自动退回 PLAIN 编码。
+     * 路径传空字符串表示跳过该段落（至少指定一个）。
+     *
+     * @param gz_path 输入 gzip 文件路径 (.dat.gz)
+     * @param ft_path FT 输出文件（建议 *_ft.parquet，空则跳过）
+     * @param dr_path DR 输出文件（建议 *_dr.parquet，空则跳过）
+     * @param sq_path SQ 输出文件（建议 *_sq.parquet，空则跳过）
+     * @param verbose 是否打印实时进度（默认 true）
+     * @param num_threads 解压/解析线程数（默认 1，含义同 ft_stream_parse_and_copy）
+     * @param compression 页压缩方式："none"（默认）或 "gzip"
+     * @param row_group_rows 每个行组的最大行数（默认 1,048,576；
+     *        缓存超过 128MB 时提前写出，SQ 这类大行不会占用过多内存）
+     * @param on_metrics 指标回调（可为空）；每个行组计为一次 flush，写 footer 计为一次 commit
+     * @param metrics_interval 汇报间隔（秒，默认 1.0）
+     */
+    static void multi_stream_parse_to_parquet(
+        const std::string& gz_path,
+        const std::string& ft_path,
+        const std::string& dr_path,
+        const std::string& sq_path,
+        bool verbose = true,
+        unsigned num_threads = 1,
+        const std::string& compression = "none",
+        std::size_t row_group_rows = 1 << 20,
+        const MetricsCallback& on_metrics = nullptr,
+        double metrics_interval = 1.0);
 };
 
 } // namespace pmcad
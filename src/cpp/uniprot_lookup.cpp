@@ -0,0 +1,218 @@
+// src/cpp/uniprot_lookup.cpp
+#include "uniprot_lookup.h"
+
+#include <pqxx/pqxx>
+#include <algorithm>
+#include <stdexcept>
+
+namespace pmcad {
+
+static const char* LOOKUP_STATEMENT = "pmcad_lookup";
+
+/// keys 转为 PostgreSQL 数组字面量 {"k1","k2"}（元素内的 '"' 与 '\' 转义）
+static std::string array_literal(
+    const std::vector<std::pair<std::string,
+                                std::promise<std::shared_ptr<const LookupRows>>>>& batch) {
+    std::string out = "{";
+    for (const auto& item : batch) {
+        if (out.size() > 1) out += ',';
+        out += '"';
+        for (char c : item.first) {
+            if (c == '"' || c == '\\') out += '\\';
+            out += c;
+        }
+        out += '"';
+    }
+    out += '}';
+    return out;
+}
+
+/// 工作线程断线重连时使用
+static std::unique_ptr<pqxx::connection> open_connection(const std::string& conn_str,
+                                                         const std::string& sql) {
+    auto conn = std::make_unique<pqxx::connection>(conn_str);
+    if (!conn->is_open())
+        throw std::runtime_error("❌ Cannot connect to PostgreSQL");
+    conn->prepare(LOOKUP_STATEMENT, sql);
+    return conn;
+}
+
+UniprotLookup::UniprotLookup(const std::string& dbname,
+                             const std::string& user,
+                             const std::string& password,
+                             const std::string& host,
+                             const std::string& port,
+                             const std::string& table,
+                             const std::string& key_column,
+                             const std::vector<std::string>& columns,
+                             unsigned pool_size,
+                             std::size_t max_batch,
+                             double batch_window,
+                             std::size_t cache_size)
+    : conn_str_("dbname=" + dbname + " user=" + user + " password=" + password +
+                " host=" + host + " port=" + port),
+      max_batch_(std::max<std::size_t>(max_batch, 1)),
+      window_(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+          std::chrono::duration<double>(std::max(batch_window, 0.0)))),
+      cache_size_(cache_size) {
+    if (columns.empty())
+        throw std::invalid_argument("❌ At least one lookup column is required");
+
+    // 先建立全部连接，连接或预编译失败时在构造时报错
+    auto first = std::make_unique<pqxx::connection>(conn_str_);
+    if (!first->is_open())
+        throw std::runtime_error("❌ Cannot connect to PostgreSQL");
+    std::string select = first->quote_name(key_column);
+    for (const auto& c : columns) select += ", " + first->quote_name(c);
+    sql_ = "SELECT " + select + " FROM " + first->quote_name(table) + " WHERE " +
+           first->quote_name(key_column) + " = ANY($1::text[])";
+    first->prepare(LOOKUP_STATEMENT, sql_);
+    conns_.push_back(std::move(first));
+    while (conns_.size() < std::max(pool_size, 1u))
+        conns_.push_back(open_connection(conn_str_, sql_));
+
+    for (std::size_t i = 0; i < conns_.size(); ++i)
+        workers_.emplace_back([this, i] { run(i); });
+}
+
+UniprotLookup::~UniprotLookup() {
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    for (auto& th : workers_) th.join();
+}
+
+std::vector<LookupRows> UniprotLookup::lookup(const std::vector<std::string>& keys) {
+    std::vector<Value> values(keys.size());
+    std::vector<std::shared_future<Value>> waiting(keys.size());
+    bool queued = false;
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            const std::string& key = keys[i];
+            stats_.requests++;
+            if (auto it = cache_.find(key); it != cache_.end()) {
+                lru_.splice(lru_.begin(), lru_, it->second);
+                values[i] = it->second->second;
+                stats_.cache_hits++;
+            } else if (auto fl = inflight_.find(key); fl != inflight_.end()) {
+                waiting[i] = fl->second;
+                stats_.coalesced++;
+            } else {
+                std::promise<Value> promise;
+                waiting[i] = promise.get_future().share();
+                inflight_.emplace(key, waiting[i]);
+                queue_.emplace_back(key, std::move(promise));
+                queued = true;
+            }
+        }
+    }
+    if (queued) cv_.notify_one();
+
+    std::vector<LookupRows> out(keys.size());
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        if (!values[i]) values[i] = waiting[i].get();  // 查询失败时在此重新抛出
+        out[i] = *values[i];
+    }
+    return out;
+}
+
+LookupStats UniprotLookup::stats() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return stats_;
+}
+
+void UniprotLookup::clear_cache() {
+    std::lock_guard<std::mutex> lk(mu_);
+    cache_.clear();
+    lru_.clear();
+}
+
+void UniprotLookup::cache_put(const std::string& key, const Value& value) {
+    if (cache_size_ == 0) return;
+    if (auto it = cache_.find(key); it != cache_.end()) {
+        it->second->second = value;
+        lru_.splice(lru_.begin(), lru_, it->second);
+        return;
+    }
+    lru_.emplace_front(key, value);
+    cache_.emplace(key, lru_.begin());
+    if (lru_.size() > cache_size_) {
+        cache_.erase(lru_.back().first);
+        lru_.pop_back();
+    }
+}
+
+void UniprotLookup::run(std::size_t worker) {
+    for (;;) {
+        std::vector<std::pair<std::string, std::promise<Value>>> batch;
+        {
+            std::unique_lock<std::mutex> lk(mu_);
+            cv_.wait(lk, [&] { return stopping_ || !queue_.empty(); });
+            if (queue_.empty()) return;  // stopping_ 且已处理完
+            // 攒批：第一个 key 到达后再等 batch_window，期间到达的 key 合并成一次查询
+            if (!stopping_ && queue_.size() < max_batch_)
+                cv_.wait_for(lk, window_,
+                             [&] { return stopping_ || queue_.size() >= max_batch_; });
+            std::size_t n = std::min(queue_.size(), max_batch_);
+            for (std::size_t i = 0; i < n; ++i) {
+                batch.push_back(std::move(queue_.front()));
+                queue_.pop_front();
+            }
+            if (!queue_.empty()) cv_.notify_one();  // 剩余的 key 交给其它空闲连接
+        }
+        if (batch.empty()) continue;
+
+        try {
+            if (!conns_[worker]) conns_[worker] = open_connection(conn_str_, sql_);
+            run_batch(*conns_[worker], batch);
+        } catch (...) {
+            // 连接断开时丢弃，下一批重新连接
+            if (conns_[worker] && !conns_[worker]->is_open()) conns_[worker].reset();
+            std::exception_ptr error = std::current_exception();
+            {
+                std::lock_guard<std::mutex> lk(mu_);
+                for (const auto& item : batch) inflight_.erase(item.first);
+            }
+            for (auto& item : batch) item.second.set_exception(error);
+        }
+    }
+}
+
+void UniprotLookup::run_batch(pqxx::connection& conn,
+                              std::vector<std::pair<std::string, std::promise<Value>>>& batch) {
+    std::unordered_map<std::string, LookupRows> found;
+    {
+        pqxx::nontransaction t(conn);
+        pqxx::result r = t.exec_prepared(LOOKUP_STATEMENT, array_literal(batch));
+        for (const auto& row : r) {
+            std::vector<std::string> values;
+            values.reserve(row.size() - 1);
+            for (std::size_t c = 1; c < row.size(); ++c)
+                values.emplace_back(row[static_cast<int>(c)].is_null()
+                                        ? std::string()
+                                        : std::string(row[static_cast<int>(c)].view()));
+            found[std::string(row[0].view())].push_back(std::move(values));
+        }
+    }
+
+    std::vector<Value> values;
+    values.reserve(batch.size());
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        stats_.queries++;
+        stats_.queried_keys += batch.size();
+        for (const auto& item : batch) {
+            auto it = found.find(item.first);
+            values.push_back(std::make_shared<const LookupRows>(
+                it == found.end() ? LookupRows() : std::move(it->second)));
+            cache_put(item.first, values.back());
+            inflight_.erase(item.first);
+        }
+    }
+    for (std::size_t i = 0; i < batch.size(); ++i) batch[i].second.set_value(values[i]);
+}
+
+} // namespace pmcad
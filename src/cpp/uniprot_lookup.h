@@ -0,0 +1,118 @@
+// src/cpp/uniprot_lookup.h
+#ifndef PMC_UNIPROT_LOOKUP_H
+#define PMC_UNIPROT_LOOKUP_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace pqxx {
+class connection;
+}
+
+namespace pmcad {
+
+/// 一个 key 对应的全部行；每行按 columns 的顺序，NULL 为空字符串
+using LookupRows = std::vector<std::vector<std::string>>;
+
+/// UniprotLookup 的累计计数
+struct LookupStats {
+    std::size_t requests = 0;      ///< lookup 请求的 key 总数
+    std::size_t cache_hits = 0;    ///< 直接由缓存返回的 key 数
+    std::size_t coalesced = 0;     ///< 与正在查询的相同 key 合并、未再次查询的 key 数
+    std::size_t queries = 0;       ///< 发往数据库的查询次数（每批一次）
+    std::size_t queried_keys = 0;  ///< 各批查询的 key 总数
+};
+
+/**
+ * @class UniprotLookup
+ * @brief 按 key（默认 accession）查询导入后的 FT / DR / SQ 等表，供多线程并发调用。
+ *
+ * 持有 pool_size 个连接，每个连接一个工作线程。各线程调用 lookup 时，
+ * 未命中缓存的 key 进入共享队列；工作线程取到第一个 key 后再等待 batch_window 秒
+ * （或攒满 max_batch 个），把这一批 key 合并成一次预编译查询
+ *   SELECT key_column, columns... FROM table WHERE key_column = ANY($1::text[])
+ * 并发的小查询因此合并为少量往返。同一个 key 正在查询时，其它调用直接等待同一结果。
+ *
+ * 查询结果（包括没有任何行的 key）放入容量为 cache_size 个 key 的 LRU 缓存，
+ * cache_size = 0 时不缓存。key_column 须为文本列。
+ *
+ * 用法：
+ *   UniprotLookup dr("db", "user", "pw", "localhost", "5432", "uniprot_dr",
+ *                    "accession", {"db_name", "db_id"});
+ *   std::vector<LookupRows> rows = dr.lookup({"P04637", "Q9Y6K9"});
+ */
+class UniprotLookup {
+public:
+    UniprotLookup(const std::string& dbname,
+                  const std::string& user,
+                  const std::string& password,
+                  const std::string& host,
+                  const std::string& port,
+                  const std::string& table,
+                  const std::string& key_column,
+                  const std::vector<std::string>& columns,
+                  unsigned pool_size = 4,
+                  std::size_t max_batch = 1000,
+                  double batch_window = 0.002,
+                  std::size_t cache_size = 100000);
+
+    /// 处理完已排队的 key 后停止工作线程
+    ~UniprotLookup();
+
+    UniprotLookup(const UniprotLookup&) = delete;
+    UniprotLookup& operator=(const UniprotLookup&) = delete;
+
+    /**
+     * @brief 查询一组 key（阻塞直到全部返回，可在多个线程中同时调用）
+     * @return 与 keys 一一对应的行；查询失败时抛出数据库异常
+     */
+    std::vector<LookupRows> lookup(const std::vector<std::string>& keys);
+
+    LookupStats stats() const;
+
+    /// 清空缓存（表被重新导入后调用）
+    void clear_cache();
+
+private:
+    using Value = std::shared_ptr<const LookupRows>;
+
+    /// 工作线程：conns_[worker] 断开时重新连接
+    void run(std::size_t worker);
+    void run_batch(pqxx::connection& conn,
+                   std::vector<std::pair<std::string, std::promise<Value>>>& batch);
+    /// 放入缓存并淘汰最久未使用的 key（调用方持有 mu_）
+    void cache_put(const std::string& key, const Value& value);
+
+    std::string conn_str_;
+    std::string sql_;
+    std::size_t max_batch_;
+    std::chrono::steady_clock::duration window_;
+    std::size_t cache_size_;
+
+    mutable std::mutex mu_;  // 保护以下状态
+    std::condition_variable cv_;
+    std::deque<std::pair<std::string, std::promise<Value>>> queue_;
+    std::unordered_map<std::string, std::shared_future<Value>> inflight_;
+    std::list<std::pair<std::string, Value>> lru_;  // 最近使用的在前
+    std::unordered_map<std::string, std::list<std::pair<std::string, Value>>::iterator> cache_;
+    LookupStats stats_;
+    bool stopping_ = false;
+
+    std::vector<std::unique_ptr<pqxx::connection>> conns_;
+    std::vector<std::thread> workers_;
+};
+
+} // namespace pmcad
+
+#endif // PMC_UNIPROT_LOOKUP_H
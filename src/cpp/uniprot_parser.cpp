@@ -0,0 +1,261 @@
+// src/cpp/uniprot_parser.cpp
+#include "uniprot_parser.h"
+#include "uniprot_scanner.h"
+
+#include <algorithm>
+
+namespace pmcad {
+
+using scan::starts_with;
+
+UniprotEntryParser::UniprotEntryParser(RecordSink* ft_sink,
+                                       RecordSink* dr_sink,
+                                       RecordSink* sq_sink,
+                                       RecordSink* entry_sink)
+    : ft_sink_(ft_sink), dr_sink_(dr_sink), sq_sink_(sq_sink),
+      entry_sink_(entry_sink) {}
+
+void UniprotEntryParser::feed_line(std::string_view line) {
+    if (!line.empty() && line.back() == '\n') line.remove_suffix(1);
+
+    // SQ 使用原始行；FT / DR 去掉行尾 '.'
+    if (sq_sink_) feed_sq(line);
+    if (ft_sink_ || dr_sink_) {
+        std::string_view stripped = line;
+        if (!stripped.empty() && stripped.back() == '.') stripped.remove_suffix(1);
+        if (ft_sink_) feed_ft(stripped);
+        if (dr_sink_) feed_dr(stripped);
+    }
+    if (entry_sink_) feed_entry(line);
+
+    if (starts_with(line, "//")) {
+        entries_++;
+        RecordSink* sinks[] = {ft_sink_, dr_sink_, sq_sink_, entry_sink_};
+        for (int i = 0; i < 4; ++i) {
+            if (!sinks[i]) continue;
+            // 同一个 sink 可能接收多个段落，只通知一次
+            if (std::find(sinks, sinks + i, sinks[i]) != sinks + i) continue;
+            sinks[i]->end_entry();
+        }
+    }
+}
+
+void UniprotEntryParser::finish() {
+    if (ft_sink_ && in_feature_) {
+        emit_ft();
+        in_feature_ = false;
+    }
+}
+
+void UniprotEntryParser::emit_ft() {
+    FtRecord r;
+    r.accession = ft_accession_;
+    r.feature_type = f_type_;
+    r.start_pos = f_start_;
+    r.end_pos = f_end_;
+    r.note = f_note_;
+    r.evidence = f_evi_;
+    ft_sink_->write(r);
+}
+
+void UniprotEntryParser::feed_ft(std::string_view line) {
+    if (starts_with(line, "AC   ")) {
+        std::string_view acc;
+        if (scan::first_accession(line, acc))
+            ft_accession_.assign(acc.data(), acc.size());
+        else
+            parse_errors_++;
+        return;
+    }
+
+    if (starts_with(line, "FT   ")) {
+        scan::FtHeader h;
+        if (scan::ft_header(line, h)) {
+            if (in_feature_) {
+                emit_ft();
+                f_note_.clear(); f_evi_.clear();
+            }
+            f_type_.assign(h.feature_type.data(), h.feature_type.size());
+            f_start_.assign(h.start_pos.data(), h.start_pos.size());
+            f_end_.assign(h.end_pos.data(), h.end_pos.size());
+            in_feature_ = true;
+        } else if (line.size() > 5 && line[5] != ' ') {
+            // 以特征名开头却不符合 "名称 起点..终点" 的行（如 "<1..10"），整条特征被跳过
+            parse_errors_++;
+        } else if (in_feature_) {
+            std::string_view v;
+            if (scan::quoted_qualifier(line, "/note=\"", v))     f_note_.assign(v.data(), v.size());
+            if (scan::quoted_qualifier(line, "/evidence=\"", v)) f_evi_.assign(v.data(), v.size());
+        }
+        return;
+    }
+
+    if (starts_with(line, "//")) {
+        if (in_feature_) {
+            emit_ft();
+            in_feature_ = false;
+            f_type_.clear(); f_start_.clear(); f_end_.clear();
+            f_note_.clear(); f_evi_.clear();
+        }
+        ft_accession_.clear();
+    }
+}
+
+void UniprotEntryParser::feed_dr(std::string_view line) {
+    // 收集条目内所有 AC 行中的 accession
+    if (starts_with(line, "AC   ")) {
+        std::string_view acc;
+        for (std::size_t pos = 0;
+             (pos = scan::next_accession(line, pos, acc)) != std::string_view::npos;) {
+            dr_acc_buf_.append(acc.data(), acc.size());
+            dr_acc_ends_.push_back(dr_acc_buf_.size());
+        }
+        return;
+    }
+
+    if (starts_with(line, "DR   ")) {
+        scan::DrFields f;
+        if (!scan::dr_line(line, f)) {
+            parse_errors_++;
+            return;
+        }
+
+        DrRecord r;
+        r.db_name = f.db_name;
+        r.db_id = f.db_id;
+        r.description = f.description;
+        r.evidence = f.evidence;
+
+        std::size_t begin = 0;
+        for (std::size_t end : dr_acc_ends_) {
+            r.accession = std::string_view(dr_acc_buf_).substr(begin, end - begin);
+            dr_sink_->write(r);
+            begin = end;
+        }
+        return;
+    }
+
+    // 新条目时清空 accession
+    if (starts_with(line, "//") || starts_with(line, "ID   ")) {
+        dr_acc_buf_.clear();
+        dr_acc_ends_.clear();
+    }
+}
+
+void UniprotEntryParser::feed_sq(std::string_view line) {
+    if (starts_with(line, "AC   ")) {
+        std::string_view acc;
+        if (scan::first_accession(line, acc))
+            sq_accession_.assign(acc.data(), acc.size());
+        else if (!ft_sink_)
+            parse_errors_++;  // FT 启用时已在 feed_ft 中计数
+        return;
+    }
+
+    if (starts_with(line, "SQ   ")) {
+        scan::SqHeader h;
+        if (scan::sq_header(line, h)) {
+            length_ = scan::to_int(h.length);
+            mw_ = scan::to_int(h.mol_weight);
+            crc64_.assign(h.crc64.data(), h.crc64.size());
+            seq_.clear();
+            // 按头部声明的长度一次预留，逐行追加时不再扩容（上限防止异常头部占用过多内存）
+            if (length_ > 0) seq_.reserve(std::min<std::size_t>(length_, 1 << 20));
+            in_seq_ = true;
+        } else {
+            parse_errors_++;
+        }
+        return;
+    }
+
+    if (in_seq_ && starts_with(line, "     ")) {
+        std::string_view residues;
+        if (scan::seq_line(line, residues)) {
+            // 逐段追加，跳过分组空格
+            std::size_t pos = 0;
+            while (pos < residues.size()) {
+                std::size_t sp = residues.find(' ', pos);
+                if (sp == std::string_view::npos) sp = residues.size();
+                seq_.append(residues.data() + pos, sp - pos);
+                pos = sp + 1;
+            }
+        }
+        return;
+    }
+
+    if (starts_with(line, "//")) {
+        if (in_seq_ && !sq_accession_.empty()) {
+            SqRecord r;
+            r.accession = sq_accession_;
+            r.length = length_;
+            r.mol_weight = mw_;
+            r.crc64 = crc64_;
+            r.sequence = seq_;
+            sq_sink_->write(r);
+        }
+        in_seq_ = false;
+        sq_accession_.clear();
+        seq_.clear();
+        crc64_.clear();
+    }
+}
+
+void UniprotEntryParser::feed_entry(std::string_view line) {
+    entry_hash_ = scan::hash_bytes(entry_hash_, line);
+
+    if (starts_with(line, "ID   ")) {
+        std::string_view rest = line.substr(5);
+        std::size_t i = 0;
+        while (i < rest.size() && scan::is_space(rest[i])) ++i;
+        std::size_t j = i;
+        while (j < rest.size() && !scan::is_space(rest[j])) ++j;
+        entry_name_.assign(rest.data() + i, j - i);
+        return;
+    }
+
+    if (starts_with(line, "AC   ")) {
+        std::string_view acc;
+        for (std::size_t pos = 0;
+             (pos = scan::next_accession(line, pos, acc)) != std::string_view::npos;) {
+            if (!entry_accs_.empty()) entry_accs_ += ';';
+            entry_accs_.append(acc.data(), acc.size());
+        }
+        return;
+    }
+
+    if (starts_with(line, "OS   ")) {
+        std::string_view v = line.substr(5);
+        while (!v.empty() && scan::is_space(v.back())) v.remove_suffix(1);
+        if (!organism_.empty()) organism_ += ' ';
+        organism_.append(v.data(), v.size());
+        return;
+    }
+
+    if (starts_with(line, "OX   ")) {
+        std::string_view digits;
+        if (scan::taxon_id(line, digits))
+            taxon_id_ = scan::to_int(digits);
+        else
+            parse_errors_++;
+        return;
+    }
+
+    if (starts_with(line, "//")) {
+        if (!organism_.empty() && organism_.back() == '.') organism_.pop_back();
+        EntryRecord r;
+        r.name = entry_name_;
+        r.accessions = entry_accs_;
+        r.organism = organism_;
+        r.taxon_id = taxon_id_;
+        r.content_hash = scan::hash_finish(entry_hash_);
+        entry_sink_->write(r);
+
+        entry_name_.clear();
+        entry_accs_.clear();
+        organism_.clear();
+        taxon_id_ = 0;
+        entry_hash_ = 0;
+    }
+}
+
+} // namespace pmcad
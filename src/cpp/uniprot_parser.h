@@ -0,0 +1,142 @@
+// src/cpp/uniprot_parser.h
+#ifndef PMC_UNIPROT_PARSER_H
+#define PMC_UNIPROT_PARSER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace pmcad {
+
+/**
+ * @brief 一条 Feature (FT) 记录。
+ *
+ * 所有字段均为视图，仅在 RecordSink::write 回调期间有效。
+ * start_pos / end_pos 保持原始文本，由下游决定是否转换为整数。
+ */
+struct FtRecord {
+    std::string_view accession;
+    std::string_view feature_type;
+    std::string_view start_pos;
+    std::string_view end_pos;
+    std::string_view note;
+    std::string_view evidence;
+};
+
+/// 一条 Database cross-reference (DR) 记录，字段含义同 DR 表结构。
+struct DrRecord {
+    std::string_view accession;
+    std::string_view db_name;
+    std::string_view db_id;
+    std::string_view description;
+    std::string_view evidence;
+};
+
+/// 一条完整的 Sequence (SQ) 记录（每个条目至多一条）。
+struct SqRecord {
+    std::string_view accession;
+    int length = 0;
+    int mol_weight = 0;
+    std::string_view crc64;
+    std::string_view sequence;
+};
+
+/// 一个条目的概要信息（每个条目一条，在 "//" 行输出）
+struct EntryRecord {
+    std::string_view name;        ///< ID 行的条目名（如 "P53_HUMAN"）
+    std::string_view accessions;  ///< 所有 AC 行的 accession，按出现顺序以 ';' 连接
+    std::string_view organism;    ///< OS 行（多行以空格拼接，去掉结尾 '.'）
+    int taxon_id = 0;             ///< OX 行的 NCBI_TaxID（缺失时为 0）
+    std::uint64_t content_hash = 0;  ///< 条目全部行（ID 至 "//"）的内容哈希，用于增量更新
+};
+
+/**
+ * @class RecordSink
+ * @brief 解析结果的接收端（PostgreSQL COPY、文件、测试桩等）。
+ *
+ * 每个 sink 通常只对应一张表，只需重写对应段落的 write。
+ */
+class RecordSink {
+public:
+    virtual ~RecordSink() = default;
+
+    virtual void write(const FtRecord&) {}
+    virtual void write(const DrRecord&) {}
+    virtual void write(const SqRecord&) {}
+    virtual void write(const EntryRecord&) {}
+
+    /// 每个条目结束（"//" 行）后调用，可在此按批次提交
+    virtual void end_entry() {}
+};
+
+/**
+ * @class UniprotEntryParser
+ * @brief 逐行解析 UniProt 文本格式，一次输入同时产出 FT / DR / SQ 三类记录。
+ *
+ * 三个段落的解析规则与原先独立的三个导入函数完全一致：
+ *   - FT：只取条目中最后一行 AC 的第一个 accession；
+ *   - DR：收集所有 AC 行中的 accession，每个 accession 写一行；
+ *   - SQ：同 FT 取 accession，"//" 时输出整条序列；
+ *   - 条目（entry_sink）："//" 时输出 ID / AC / OS / OX 的概要及整个条目文本的
+ *     内容哈希（scan::hash_bytes），在该条目的 SQ 之后、end_entry 之前。
+ *
+ * 传入 nullptr 的 sink 对应段落不解析。
+ * 行匹配由 uniprot_scanner.h 中的手写扫描器完成，不使用 std::regex。
+ */
+class UniprotEntryParser {
+public:
+    UniprotEntryParser(RecordSink* ft_sink, RecordSink* dr_sink,
+                       RecordSink* sq_sink, RecordSink* entry_sink = nullptr);
+
+    /// 输入一行（不含行尾换行符），视图只需在本次调用期间有效
+    void feed_line(std::string_view line);
+
+    /// 输入结束，输出最后一个未以 "//" 结尾的 Feature
+    void finish();
+
+    /// 已处理完成的条目数（"//" 行数）
+    std::size_t entries() const { return entries_; }
+
+    /// 无法解析而被跳过的行数（已启用段落中格式不符的 AC / FT 特征头 / DR / SQ / OX 行）
+    std::size_t parse_errors() const { return parse_errors_; }
+
+private:
+    void feed_ft(std::string_view line);
+    void feed_dr(std::string_view line);
+    void feed_sq(std::string_view line);
+    void feed_entry(std::string_view line);
+    void emit_ft();
+
+    RecordSink* ft_sink_;
+    RecordSink* dr_sink_;
+    RecordSink* sq_sink_;
+    RecordSink* entry_sink_;
+    std::size_t entries_ = 0;
+    std::size_t parse_errors_ = 0;
+
+    // 以下状态跨行保存，使用 std::string 复用容量，稳定后不再分配内存
+
+    // ---------- FT 状态 ----------
+    std::string ft_accession_, f_type_, f_start_, f_end_, f_note_, f_evi_;
+    bool in_feature_ = false;
+
+    // ---------- DR 状态：所有 accession 连续存放在 dr_acc_buf_ 中 ----------
+    std::string dr_acc_buf_;
+    std::vector<std::size_t> dr_acc_ends_;
+
+    // ---------- SQ 状态 ----------
+    std::string sq_accession_, seq_, crc64_;
+    int length_ = 0, mw_ = 0;
+    bool in_seq_ = false;
+
+    // ---------- 条目状态 ----------
+    std::string entry_name_, entry_accs_, organism_;
+    int taxon_id_ = 0;
+    std::uint64_t entry_hash_ = 0;
+};
+
+} // namespace pmcad
+
+#endif // PMC_UNIPROT_PARSER_H
@@ -0,0 +1,704 @@
+// src/cpp/uniprot_reader.cpp
+#include "uniprot_reader.h"
+#include "uniprot_scanner.h"
+
+#include <zlib.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <sys/stat.h>
+
+namespace pmcad {
+
+// ================= RecordBuffer =================
+
+RecordBuffer::Span RecordBuffer::keep(std::string_view s) {
+    Span sp{arena_.size(), s.size()};
+    arena_.append(s.data(), s.size());
+    return sp;
+}
+
+void RecordBuffer::write(const FtRecord& r) {
+    ft_.push_back({{keep(r.accession), keep(r.feature_type), keep(r.start_pos),
+                    keep(r.end_pos), keep(r.note), keep(r.evidence)}});
+}
+
+void RecordBuffer::write(const DrRecord& r) {
+    dr_.push_back({{keep(r.accession), keep(r.db_name), keep(r.db_id),
+                    keep(r.description), keep(r.evidence)}});
+}
+
+void RecordBuffer::write(const SqRecord& r) {
+    sq_.push_back({keep(r.accession), keep(r.crc64), keep(r.sequence),
+                   r.length, r.mol_weight});
+}
+
+void RecordBuffer::write(const EntryRecord& r) {
+    en_.push_back({keep(r.name), keep(r.accessions), keep(r.organism), r.taxon_id,
+                   r.content_hash});
+}
+
+void RecordBuffer::end_entry() {
+    entries_.push_back({ft_.size(), dr_.size(), sq_.size(), en_.size()});
+}
+
+void RecordBuffer::replay(RecordSink* ft_sink, RecordSink* dr_sink,
+                          RecordSink* sq_sink, RecordSink* entry_sink) const {
+    std::size_t fi = 0, di = 0, si = 0, ei = 0;
+    auto flush_until = [&](std::size_t fe, std::size_t de, std::size_t se,
+                           std::size_t ee) {
+        for (; fi < fe; ++fi) {
+            const auto& x = ft_[fi];
+            FtRecord r;
+            r.accession = view(x.f[0]);
+            r.feature_type = view(x.f[1]);
+            r.start_pos = view(x.f[2]);
+            r.end_pos = view(x.f[3]);
+            r.note = view(x.f[4]);
+            r.evidence = view(x.f[5]);
+            if (ft_sink) ft_sink->write(r);
+        }
+        for (; di < de; ++di) {
+            const auto& x = dr_[di];
+            DrRecord r;
+            r.accession = view(x.f[0]);
+            r.db_name = view(x.f[1]);
+            r.db_id = view(x.f[2]);
+            r.description = view(x.f[3]);
+            r.evidence = view(x.f[4]);
+            if (dr_sink) dr_sink->write(r);
+        }
+        for (; si < se; ++si) {
+            const auto& x = sq_[si];
+            SqRecord r;
+            r.accession = view(x.accession);
+            r.length = x.length;
+            r.mol_weight = x.mol_weight;
+            r.crc64 = view(x.crc64);
+            r.sequence = view(x.sequence);
+            if (sq_sink) sq_sink->write(r);
+        }
+        for (; ei < ee; ++ei) {
+            const auto& x = en_[ei];
+            EntryRecord r;
+            r.name = view(x.name);
+            r.accessions = view(x.accessions);
+            r.organism = view(x.organism);
+            r.taxon_id = x.taxon_id;
+            r.content_hash = x.content_hash;
+            if (entry_sink) entry_sink->write(r);
+        }
+    };
+
+    RecordSink* sinks[] = {ft_sink, dr_sink, sq_sink, entry_sink};
+    for (const auto& e : entries_) {
+        flush_until(e.ft_end, e.dr_end, e.sq_end, e.en_end);
+        for (int i = 0; i < 4; ++i) {
+            if (!sinks[i]) continue;
+            if (std::find(sinks, sinks + i, sinks[i]) != sinks + i) continue;
+            sinks[i]->end_entry();
+        }
+    }
+    flush_until(ft_.size(), dr_.size(), sq_.size(), en_.size());
+}
+
+void RecordBuffer::clear() {
+    arena_.clear();
+    ft_.clear();
+    dr_.clear();
+    sq_.clear();
+    en_.clear();
+    entries_.clear();
+}
+
+// ================= 工具函数 =================
+
+static std::size_t file_size(const std::string& path) {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 ? static_cast<std::size_t>(st.st_size) : 0;
+}
+
+/// 把 text 中的行依次送入 parser（最后一行可以没有换行符）
+static void feed_lines(UniprotEntryParser& parser, std::string_view text) {
+    std::size_t pos = 0;
+    while (pos < text.size()) {
+        std::size_t nl = text.find('\n', pos);
+        if (nl == std::string_view::npos) {
+            parser.feed_line(text.substr(pos));
+            break;
+        }
+        parser.feed_line(text.substr(pos, nl - pos));
+        pos = nl + 1;
+    }
+}
+
+/**
+ * @brief 跳过 text 中的前 remaining 个条目结束行（"//"），不做解析
+ *
+ * text 从行首开始；返回跳过部分的结束位置，remaining 减去实际跳过的条目数。
+ */
+static std::size_t skip_entry_lines(std::string_view text, std::size_t& remaining) {
+    std::size_t pos = 0;
+    while (remaining > 0 && pos < text.size()) {
+        std::size_t nl = text.find('\n', pos);
+        std::size_t end = nl == std::string_view::npos ? text.size() : nl + 1;
+        if (scan::starts_with(text.substr(pos, end - pos), "//")) remaining--;
+        pos = end;
+    }
+    return pos;
+}
+
+/**
+ * @brief 查找块内第一个和最后一个完整的条目结束行（"//"）
+ *
+ * 块首的位置 0 不算行首（可能是上一块被截断的行），
+ * 因此 [0, head_end) 和 [tail_start, end) 都交给写入线程拼接解析。
+ * 没有完整的结束行时 head_end = tail_start = npos。
+ */
+static void find_entry_bounds(std::string_view text, std::size_t& head_end,
+                              std::size_t& tail_start) {
+    constexpr auto npos = std::string_view::npos;
+    head_end = tail_start = npos;
+
+    std::size_t p = text.find("\n//");
+    if (p == npos) return;
+    std::size_t nl = text.find('\n', p + 1);
+    if (nl == npos) return;
+    head_end = nl + 1;
+
+    for (std::size_t q = text.rfind("\n//"); q != npos && q >= p;
+         q = q == 0 ? npos : text.rfind("\n//", q - 1)) {
+        nl = text.find('\n', q + 1);
+        if (nl != npos) {
+            tail_start = nl + 1;
+            return;
+        }
+    }
+}
+
+// ================= BGZF =================
+
+/// 解析 p 处的 BGZF 块头，返回整块长度（BSIZE + 1）；不是 BGZF 块时返回 0
+static std::size_t bgzf_block_size(const unsigned char* p, std::size_t avail,
+                                   std::size_t* header_len = nullptr) {
+    if (avail < 12) return 0;
+    if (p[0] != 0x1f || p[1] != 0x8b || p[2] != 8 || p[3] != 4) return 0;
+    std::size_t xlen = p[10] | (p[11] << 8);
+    if (avail < 12 + xlen) return 0;
+
+    for (std::size_t off = 12; off + 4 <= 12 + xlen;) {
+        std::size_t slen = p[off + 2] | (p[off + 3] << 8);
+        if (p[off] == 'B' && p[off + 1] == 'C' && slen == 2 &&
+            off + 6 <= 12 + xlen) {
+            if (header_len) *header_len = 12 + xlen;
+            return (p[off + 4] | (p[off + 5] << 8)) + 1;
+        }
+        off += 4 + slen;
+    }
+    return 0;
+}
+
+bool is_bgzf(const std::string& gz_path) {
+    std::FILE* f = std::fopen(gz_path.c_str(), "rb");
+    if (!f) return false;
+    unsigned char head[64];
+    std::size_t n = std::fread(head, 1, sizeof(head), f);
+    std::fclose(f);
+    return bgzf_block_size(head, n) != 0;
+}
+
+/// 解压若干个连续、完整的 BGZF 块，追加到 out
+static void inflate_bgzf_blocks(std::string_view comp, std::string& out) {
+    z_stream zs{};
+    if (inflateInit2(&zs, -MAX_WBITS) != Z_OK)
+        throw std::runtime_error("❌ inflateInit2 failed");
+
+    std::size_t off = 0;
+    while (off < comp.size()) {
+        const auto* p = reinterpret_cast<const unsigned char*>(comp.data()) + off;
+        std::size_t header_len = 0;
+        std::size_t bsize = bgzf_block_size(p, comp.size() - off, &header_len);
+        if (bsize == 0 || bsize < header_len + 8 || off + bsize > comp.size()) {
+            inflateEnd(&zs);
+            throw std::runtime_error("❌ Corrupted BGZF block");
+        }
+
+        const unsigned char* tail = p + bsize - 4;
+        std::size_t isize = tail[0] | (tail[1] << 8) | (tail[2] << 16) |
+                            (static_cast<std::size_t>(tail[3]) << 24);
+        std::size_t old = out.size();
+        out.resize(old + isize);
+
+        inflateReset(&zs);
+        zs.next_in = const_cast<Bytef*>(p + header_len);
+        zs.avail_in = static_cast<uInt>(bsize - header_len - 8);
+        zs.next_out = reinterpret_cast<Bytef*>(&out[old]);
+        zs.avail_out = static_cast<uInt>(isize);
+        int ret = inflate(&zs, Z_FINISH);
+        if (ret != Z_STREAM_END || zs.avail_out != 0) {
+            inflateEnd(&zs);
+            throw std::runtime_error("❌ Failed to inflate BGZF block");
+        }
+        off += bsize;
+    }
+    inflateEnd(&zs);
+}
+
+// ================= 单线程 =================
+
+static void parse_sequential(
+    const std::string& gz_path, UniprotEntryParser& parser,
+    const std::function<void(const ReadProgress&)>& on_progress,
+    std::size_t skip_entries) {
+    gzFile gzfile = gzopen(gz_path.c_str(), "rb");
+    if (!gzfile)
+        throw std::runtime_error("❌ Cannot open gzip file: " + gz_path);
+    // sink 抛出异常（COPY 失败、流式读取提前结束等）时也要关闭文件
+    std::unique_ptr<gzFile_s, int (*)(gzFile)> closer(gzfile, gzclose);
+    gzbuffer(gzfile, 1 << 20);
+
+    ReadProgress progress;
+    progress.total_bytes = file_size(gz_path);
+
+    const std::size_t BUF_SIZE = 4 << 20;
+    std::vector<char> buffer(BUF_SIZE);
+    std::size_t have = 0;
+    std::size_t skip_left = skip_entries;
+
+    while (true) {
+        // 单行超过缓冲区时扩容
+        if (have == buffer.size()) buffer.resize(buffer.size() * 2);
+
+        int n = gzread(gzfile, buffer.data() + have,
+                       static_cast<unsigned>(buffer.size() - have));
+        if (n < 0)
+            throw std::runtime_error("❌ Failed to decompress gzip file: " + gz_path);
+        if (n == 0) break;
+        have += n;
+        progress.inflated_bytes += n;
+
+        std::string_view text(buffer.data(), have);
+        std::size_t last_nl = text.rfind('\n');
+        if (last_nl == std::string_view::npos) continue;
+
+        std::string_view lines = text.substr(0, last_nl + 1);
+        if (skip_left > 0) lines.remove_prefix(skip_entry_lines(lines, skip_left));
+        feed_lines(parser, lines);
+        std::size_t rest = have - last_nl - 1;
+        std::memmove(buffer.data(), buffer.data() + last_nl + 1, rest);
+        have = rest;
+
+        progress.parsed_bytes += last_nl + 1;
+        progress.compressed_bytes = static_cast<std::size_t>(gzoffset(gzfile));
+        progress.entries = skip_entries - skip_left + parser.entries();
+        progress.parse_errors = parser.parse_errors();
+        if (on_progress) on_progress(progress);
+    }
+
+    std::string_view last(buffer.data(), have);
+    if (skip_left > 0) last.remove_prefix(skip_entry_lines(last, skip_left));
+    feed_lines(parser, last);
+    parser.finish();
+    closer.reset();
+
+    progress.parsed_bytes += have;
+    progress.compressed_bytes = progress.total_bytes;
+    progress.entries = skip_entries - skip_left + parser.entries();
+    progress.parse_errors = parser.parse_errors();
+    if (on_progress) on_progress(progress);
+}
+
+// ================= 多线程流水线 =================
+
+namespace {
+
+/**
+ * @brief 丢弃前 skip 个条目的记录，之后原样转发给 target。
+ *
+ * 多线程流水线中条目的全局序号只有在调用线程按顺序回放时才确定，
+ * 因此断点续传的跳过放在回放之后的这一层完成。
+ */
+class EntrySkipper : public RecordSink {
+public:
+    EntrySkipper(RecordSink* target, std::size_t skip)
+        : target_(target), remaining_(skip) {}
+
+    void write(const FtRecord& r) override { if (!remaining_) target_->write(r); }
+    void write(const DrRecord& r) override { if (!remaining_) target_->write(r); }
+    void write(const SqRecord& r) override { if (!remaining_) target_->write(r); }
+    void write(const EntryRecord& r) override { if (!remaining_) target_->write(r); }
+
+    void end_entry() override {
+        if (remaining_) remaining_--;
+        else target_->end_entry();
+    }
+
+private:
+    RecordSink* target_;
+    std::size_t remaining_;
+};
+
+struct Task {
+    std::size_t seq = 0;
+    std::string data;     ///< 普通 gzip：解压后的文本；BGZF：若干完整的压缩块
+    bool compressed = false;
+    std::size_t compressed_end = 0;
+};
+
+struct ParsedChunk {
+    std::string text;
+    std::size_t head_end = std::string::npos;
+    std::size_t tail_start = std::string::npos;
+    RecordBuffer records;
+    std::size_t compressed_end = 0;
+    std::size_t parse_errors = 0;
+};
+
+class ParsePipeline {
+public:
+    ParsePipeline(const std::string& gz_path, RecordSink* ft_sink,
+                  RecordSink* dr_sink, RecordSink* sq_sink,
+                  RecordSink* entry_sink, unsigned num_threads,
+                  const std::function<void(const ReadProgress&)>& on_progress)
+        : gz_path_(gz_path), ft_sink_(ft_sink), dr_sink_(dr_sink),
+          sq_sink_(sq_sink), entry_sink_(entry_sink), num_threads_(num_threads),
+          max_in_flight_(num_threads * 2 + 2), on_progress_(on_progress),
+          bgzf_(is_bgzf(gz_path)) {}
+
+    void run();
+
+private:
+    void read_plain();
+    void read_bgzf();
+    void worker();
+    bool push_task(Task&& t);
+    void fail(std::exception_ptr e);
+    void consume(ParsedChunk& chunk, UniprotEntryParser& parser,
+                 std::string& carry);
+
+    std::string gz_path_;
+    RecordSink* ft_sink_;
+    RecordSink* dr_sink_;
+    RecordSink* sq_sink_;
+    RecordSink* entry_sink_;
+    unsigned num_threads_;
+    std::size_t max_in_flight_;
+    std::function<void(const ReadProgress&)> on_progress_;
+    bool bgzf_;
+
+    std::mutex mu_;
+    std::condition_variable tasks_cv_, results_cv_, slots_cv_;
+    std::deque<Task> tasks_;
+    std::map<std::size_t, ParsedChunk> results_;
+    std::size_t pushed_ = 0;
+    std::size_t in_flight_ = 0;
+    bool reader_done_ = false;
+    bool aborted_ = false;
+    std::exception_ptr error_;
+    ReadProgress progress_;
+    std::atomic<std::size_t> inflated_{0}; // 读取线程 / 工作线程累加的解压字节
+};
+
+void ParsePipeline::fail(std::exception_ptr e) {
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        if (!error_) error_ = e;
+        aborted_ = true;
+    }
+    tasks_cv_.notify_all();
+    results_cv_.notify_all();
+    slots_cv_.notify_all();
+}
+
+bool ParsePipeline::push_task(Task&& t) {
+    std::unique_lock<std::mutex> lk(mu_);
+    slots_cv_.wait(lk, [&] { return aborted_ || in_flight_ < max_in_flight_; });
+    if (aborted_) return false;
+    t.seq = pushed_++;
+    in_flight_++;
+    tasks_.push_back(std::move(t));
+    lk.unlock();
+    tasks_cv_.notify_one();
+    return true;
+}
+
+void ParsePipeline::read_plain() {
+    gzFile gzfile = gzopen(gz_path_.c_str(), "rb");
+    if (!gzfile)
+        throw std::runtime_error("❌ Cannot open gzip file: " + gz_path_);
+    gzbuffer(gzfile, 1 << 20);
+
+    const std::size_t CHUNK_SIZE = 4 << 20;
+    while (true) {
+        Task t;
+        t.data.resize(CHUNK_SIZE);
+        int n = gzread(gzfile, &t.data[0], static_cast<unsigned>(CHUNK_SIZE));
+        if (n < 0) {
+            gzclose(gzfile);
+            throw std::runtime_error("❌ Failed to decompress gzip file: " + gz_path_);
+        }
+        if (n == 0) break;
+        t.data.resize(n);
+        inflated_ += static_cast<std::size_t>(n);
+        t.compressed_end = static_cast<std::size_t>(gzoffset(gzfile));
+        if (!push_task(std::move(t))) break;
+    }
+    gzclose(gzfile);
+}
+
+void ParsePipeline::read_bgzf() {
+    std::FILE* f = std::fopen(gz_path_.c_str(), "rb");
+    if (!f)
+        throw std::runtime_error("❌ Cannot open gzip file: " + gz_path_);
+
+    // 每个任务约 1MB 压缩数据（BGZF 单块不超过 64KB）
+    const std::size_t TASK_SIZE = 1 << 20;
+    std::size_t offset = 0;
+    Task t;
+    t.compressed = true;
+    unsigned char head[12];
+
+    while (true) {
+        std::size_t n = std::fread(head, 1, sizeof(head), f);
+        if (n == 0) break;
+        if (n < sizeof(head)) {
+            std::fclose(f);
+            throw std::runtime_error("❌ Truncated BGZF file: " + gz_path_);
+        }
+
+        std::size_t xlen = head[10] | (head[11] << 8);
+        std::size_t start = t.data.size();
+        t.data.append(reinterpret_cast<const char*>(head), sizeof(head));
+        t.data.resize(start + sizeof(head) + xlen);
+        if (std::fread(&t.data[start + sizeof(head)], 1, xlen, f) != xlen) {
+            std::fclose(f);
+            throw std::runtime_error("❌ Truncated BGZF file: " + gz_path_);
+        }
+
+        const auto* p = reinterpret_cast<const unsigned char*>(t.data.data()) + start;
+        std::size_t bsize = bgzf_block_size(p, sizeof(head) + xlen);
+        if (bsize < sizeof(head) + xlen) {
+            std::fclose(f);
+            throw std::runtime_error("❌ Not a BGZF block at offset " +
+                                     std::to_string(offset) + ": " + gz_path_);
+        }
+
+        std::size_t rest = bsize - sizeof(head) - xlen;
+        t.data.resize(start + bsize);
+        if (std::fread(&t.data[start + sizeof(head) + xlen], 1, rest, f) != rest) {
+            std::fclose(f);
+            throw std::runtime_error("❌ Truncated BGZF file: " + gz_path_);
+        }
+        offset += bsize;
+
+        if (t.data.size() >= TASK_SIZE) {
+            t.compressed_end = offset;
+            if (!push_task(std::move(t))) break;
+            t = Task();
+            t.compressed = true;
+        }
+    }
+    std::fclose(f);
+
+    if (!t.data.empty()) {
+        t.compressed_end = offset;
+        push_task(std::move(t));
+    }
+}
+
+void ParsePipeline::worker() {
+    RecordBuffer buffer;
+    UniprotEntryParser parser(ft_sink_ ? &buffer : nullptr,
+                              dr_sink_ ? &buffer : nullptr,
+                              sq_sink_ ? &buffer : nullptr,
+                              entry_sink_ ? &buffer : nullptr);
+    while (true) {
+        Task t;
+        {
+            std::unique_lock<std::mutex> lk(mu_);
+            tasks_cv_.wait(lk, [&] { return aborted_ || !tasks_.empty() || reader_done_; });
+            if (aborted_ || tasks_.empty()) return;
+            t = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+
+        ParsedChunk chunk;
+        chunk.compressed_end = t.compressed_end;
+        if (t.compressed) {
+            inflate_bgzf_blocks(t.data, chunk.text);
+            inflated_ += chunk.text.size();
+        } else {
+            chunk.text = std::move(t.data);
+        }
+
+        // 块内完整条目在本线程解析；块首尾的残缺部分留给写入线程
+        find_entry_bounds(chunk.text, chunk.head_end, chunk.tail_start);
+        std::size_t errors_before = parser.parse_errors();
+        if (chunk.head_end != std::string::npos && chunk.tail_start > chunk.head_end)
+            feed_lines(parser, std::string_view(chunk.text).substr(
+                                   chunk.head_end, chunk.tail_start - chunk.head_end));
+        chunk.parse_errors = parser.parse_errors() - errors_before;
+        chunk.records = std::move(buffer);
+        buffer.clear();
+
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            results_.emplace(t.seq, std::move(chunk));
+        }
+        results_cv_.notify_all();
+    }
+}
+
+void ParsePipeline::consume(ParsedChunk& chunk, UniprotEntryParser& parser,
+                            std::string& carry) {
+    std::string_view text(chunk.text);
+    if (chunk.head_end == std::string::npos) {
+        // 块内没有条目边界：整块并入残缺条目
+        carry.append(text.data(), text.size());
+    } else {
+        carry.append(text.data(), chunk.head_end);
+        feed_lines(parser, carry);
+        carry.clear();
+        chunk.records.replay(ft_sink_, dr_sink_, sq_sink_, entry_sink_);
+        carry.assign(text.substr(chunk.tail_start));
+        progress_.entries += chunk.records.entries();
+        progress_.parse_errors += chunk.parse_errors;
+    }
+
+    progress_.parsed_bytes += text.size();
+    progress_.compressed_bytes = chunk.compressed_end;
+    if (on_progress_) {
+        ReadProgress p = progress_;
+        p.inflated_bytes = inflated_.load();
+        p.entries += parser.entries();
+        p.parse_errors += parser.parse_errors();
+        on_progress_(p);
+    }
+}
+
+void ParsePipeline::run() {
+    progress_.total_bytes = file_size(gz_path_);
+
+    std::thread reader([this] {
+        try {
+            if (bgzf_) read_bgzf(); else read_plain();
+        } catch (...) {
+            fail(std::current_exception());
+        }
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            reader_done_ = true;
+        }
+        tasks_cv_.notify_all();
+        results_cv_.notify_all();
+    });
+
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < num_threads_; ++i) {
+        workers.emplace_back([this] {
+            try {
+                worker();
+            } catch (...) {
+                fail(std::current_exception());
+            }
+        });
+    }
+
+    // ---------- 写入：调用线程按顺序回放 ----------
+    UniprotEntryParser parser(ft_sink_, dr_sink_, sq_sink_, entry_sink_);
+    std::string carry;
+    try {
+        for (std::size_t next = 0;; ++next) {
+            ParsedChunk chunk;
+            {
+                std::unique_lock<std::mutex> lk(mu_);
+                results_cv_.wait(lk, [&] {
+                    return aborted_ || results_.count(next) ||
+                           (reader_done_ && next == pushed_);
+                });
+                if (aborted_) break;
+                auto it = results_.find(next);
+                if (it == results_.end()) break; // 全部完成
+                chunk = std::move(it->second);
+                results_.erase(it);
+            }
+
+            consume(chunk, parser, carry);
+
+            {
+                std::lock_guard<std::mutex> lk(mu_);
+                in_flight_--;
+            }
+            slots_cv_.notify_one();
+        }
+    } catch (...) {
+        fail(std::current_exception());
+    }
+
+    reader.join();
+    for (auto& w : workers) w.join();
+    if (error_) std::rethrow_exception(error_);
+
+    feed_lines(parser, carry);
+    parser.finish();
+
+    progress_.compressed_bytes = progress_.total_bytes;
+    progress_.inflated_bytes = inflated_.load();
+    progress_.entries += parser.entries();
+    progress_.parse_errors += parser.parse_errors();
+    if (on_progress_) on_progress_(progress_);
+}
+
+} // namespace
+
+void parse_uniprot_gz(
+    const std::string& gz_path,
+    RecordSink* ft_sink,
+    RecordSink* dr_sink,
+    RecordSink* sq_sink,
+    unsigned num_threads,
+    const std::function<void(const ReadProgress&)>& on_progress,
+    std::size_t skip_entries,
+    RecordSink* entry_sink) {
+    if (num_threads <= 1) {
+        UniprotEntryParser parser(ft_sink, dr_sink, sq_sink, entry_sink);
+        parse_sequential(gz_path, parser, on_progress, skip_entries);
+        return;
+    }
+
+    if (skip_entries > 0) {
+        // 同一个 sink 可能接收多个段落，共用一个 skipper 以保证每条目只计数一次
+        std::vector<std::unique_ptr<EntrySkipper>> skippers;
+        std::map<RecordSink*, EntrySkipper*> wrapped;
+        auto wrap = [&](RecordSink* s) -> RecordSink* {
+            if (!s) return nullptr;
+            auto it = wrapped.find(s);
+            if (it != wrapped.end()) return it->second;
+            skippers.push_back(std::make_unique<EntrySkipper>(s, skip_entries));
+            return wrapped[s] = skippers.back().get();
+        };
+        RecordSink* ft = wrap(ft_sink);
+        RecordSink* dr = wrap(dr_sink);
+        RecordSink* sq = wrap(sq_sink);
+        RecordSink* en = wrap(entry_sink);
+        ParsePipeline pipeline(gz_path, ft, dr, sq, en, num_threads, on_progress);
+        pipeline.run();
+        return;
+    }
+
+    ParsePipeline pipeline(gz_path, ft_sink, dr_sink, sq_sink, entry_sink,
+                           num_threads, on_progress);
+    pipeline.run();
+}
+
+} // namespace pmcad
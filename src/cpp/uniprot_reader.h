@@ -0,0 +1,109 @@
+// src/cpp/uniprot_reader.h
+#ifndef PMC_UNIPROT_READER_H
+#define PMC_UNIPROT_READER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "uniprot_parser.h"
+
+namespace pmcad {
+
+/**
+ * @class RecordBuffer
+ * @brief 缓存解析结果的 RecordSink，供工作线程先解析、写入线程再按顺序回放。
+ *
+ * 所有字段拷贝到同一块 arena 中，只记录偏移，避免逐字段分配。
+ */
+class RecordBuffer : public RecordSink {
+public:
+    void write(const FtRecord& r) override;
+    void write(const DrRecord& r) override;
+    void write(const SqRecord& r) override;
+    void write(const EntryRecord& r) override;
+    void end_entry() override;
+
+    /// 把记录写入真正的 sinks，每个条目结束时调用其 end_entry；每个段落内保持原始顺序，
+    /// 条目内按 FT、DR、SQ、EntryRecord 分组
+    void replay(RecordSink* ft_sink, RecordSink* dr_sink,
+                RecordSink* sq_sink, RecordSink* entry_sink = nullptr) const;
+
+    std::size_t entries() const { return entries_.size(); }
+    /// 缓存的记录总数（FT + DR + SQ + 条目概要）
+    std::size_t rows() const { return ft_.size() + dr_.size() + sq_.size() + en_.size(); }
+    void clear();
+
+private:
+    struct Span { std::size_t off, len; };
+    struct Ft { Span f[6]; };
+    struct Dr { Span f[5]; };
+    struct Sq { Span accession, crc64, sequence; int length, mol_weight; };
+    struct En { Span name, accessions, organism; int taxon_id; std::uint64_t content_hash; };
+    struct Entry { std::size_t ft_end, dr_end, sq_end, en_end; };
+
+    Span keep(std::string_view s);
+    std::string_view view(const Span& s) const {
+        return std::string_view(arena_.data() + s.off, s.len);
+    }
+
+    std::string arena_;
+    std::vector<Ft> ft_;
+    std::vector<Dr> dr_;
+    std::vector<Sq> sq_;
+    std::vector<En> en_;
+    std::vector<Entry> entries_;
+};
+
+/// 读取进度（在调用线程中回调）
+struct ReadProgress {
+    std::size_t compressed_bytes = 0; ///< 已读取的压缩字节
+    std::size_t total_bytes = 0;      ///< 压缩文件总大小
+    std::size_t inflated_bytes = 0;   ///< 已解压的字节（多线程时可超前于 parsed_bytes）
+    std::size_t parsed_bytes = 0;     ///< 已解析并送入 sinks 的字节
+    std::size_t entries = 0;          ///< 已完成的条目数
+    std::size_t parse_errors = 0;     ///< 无法解析而被跳过的行数
+};
+
+/// 判断文件是否为 BGZF（每个 gzip member 带 "BC" 扩展字段，记录块大小）
+bool is_bgzf(const std::string& gz_path);
+
+/**
+ * @brief 解压并解析 UniProt .dat.gz，记录写入给定 sinks（nullptr 表示跳过该段落）
+ *
+ * num_threads <= 1：在调用线程中边解压边解析。
+ *
+ * num_threads > 1：多线程流水线：
+ *   - 读取线程：普通 gzip 只能顺序解压（inflate 本身无法并行），
+ *     按 4MB 切块；BGZF 文件按块组切分压缩数据，由工作线程并行解压；
+ *   - 工作线程：解析每块中完整的条目（以 "//" 行为界）到 RecordBuffer；
+ *   - 调用线程：按块顺序回放记录到 sinks，并拼接块首尾残缺的条目
+ *     在本线程直接解析。因此 sinks 只会在调用线程中被访问。
+ *
+ * 顺序保证只针对每个段落：各 sink 收到的 FT / DR / SQ 记录、EntryRecord 以及
+ * end_entry 的先后与单线程完全相同，与线程数和是否为 BGZF 无关。同一个 sink
+ * 订阅多个段落时，条目内不同段落之间的交错顺序不做保证（回放时按
+ * FT、DR、SQ、EntryRecord 分组），条目边界仍然一致。
+ *
+ * @param on_progress 每处理一块后调用（可为空）
+ * @param skip_entries 跳过文件开头的条目数（断点续传）：这些条目的记录和
+ *        end_entry 都不会送到 sinks。单线程时只扫描 "//" 行、不解析；
+ *        多线程时仍并行解析，只是不回放
+ * @param entry_sink 接收每个条目的 EntryRecord（ID / AC / OS / OX 概要，可为空）
+ */
+void parse_uniprot_gz(
+    const std::string& gz_path,
+    RecordSink* ft_sink,
+    RecordSink* dr_sink,
+    RecordSink* sq_sink,
+    unsigned num_threads = 1,
+    const std::function<void(const ReadProgress&)>& on_progress = nullptr,
+    std::size_t skip_entries = 0,
+    RecordSink* entry_sink = nullptr);
+
+} // namespace pmcad
+
+#endif // PMC_UNIPROT_READER_H
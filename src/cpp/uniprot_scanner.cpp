@@ -0,0 +1,262 @@
+// src/cpp/uniprot_scanner.cpp
+#include "uniprot_scanner.h"
+
+#include <charconv>
+#include <stdexcept>
+
+namespace pmcad {
+namespace scan {
+
+static constexpr std::size_t npos = std::string_view::npos;
+
+static bool is_acc_char(char c) {
+    return (c >= 'A' && c <= 'Z') || is_digit(c);
+}
+
+static bool is_hex_upper(char c) {
+    return (c >= 'A' && c <= 'F') || is_digit(c);
+}
+
+/// 从 i 开始跳过空白，返回第一个非空白位置
+static std::size_t skip_space(std::string_view s, std::size_t i) {
+    while (i < s.size() && is_space(s[i])) ++i;
+    return i;
+}
+
+/// 从 i 开始匹配 pred+，返回结束位置（没有匹配时返回 i 本身）
+template <class Pred>
+static std::size_t span_of(std::string_view s, std::size_t i, Pred pred) {
+    while (i < s.size() && pred(s[i])) ++i;
+    return i;
+}
+
+bool first_accession(std::string_view line, std::string_view& accession) {
+    for (std::size_t at = line.find("AC"); at != npos; at = line.find("AC", at + 1)) {
+        std::size_t i = skip_space(line, at + 2);
+        if (i == at + 2) continue;
+        std::size_t j = span_of(line, i, is_acc_char);
+        if (j == i || j >= line.size() || line[j] != ';') continue;
+        accession = line.substr(i, j - i);
+        return true;
+    }
+    return false;
+}
+
+std::size_t next_accession(std::string_view line, std::size_t pos,
+                           std::string_view& accession) {
+    std::size_t i = pos;
+    while (i < line.size()) {
+        if (!is_acc_char(line[i])) {
+            ++i;
+            continue;
+        }
+        std::size_t j = span_of(line, i, is_acc_char);
+        if (j < line.size() && line[j] == ';') {
+            accession = line.substr(i, j - i);
+            return j + 1;
+        }
+        i = j;
+    }
+    return npos;
+}
+
+bool ft_header(std::string_view line, FtHeader& out) {
+    if (!starts_with(line, "FT")) return false;
+
+    std::size_t i = skip_space(line, 2);
+    if (i == 2) return false;
+
+    std::size_t type_end = span_of(line, i, [](char c) { return !is_space(c); });
+    if (type_end == i) return false;
+
+    std::size_t a = skip_space(line, type_end);
+    if (a == type_end) return false;
+
+    std::size_t a_end = span_of(line, a, is_digit);
+    if (a_end == a || line.substr(a_end, 2) != "..") return false;
+
+    std::size_t b = a_end + 2;
+    std::size_t b_end = span_of(line, b, is_digit);
+    if (b_end == b) return false;
+
+    out.feature_type = line.substr(i, type_end - i);
+    out.start_pos = line.substr(a, a_end - a);
+    out.end_pos = line.substr(b, b_end - b);
+    return true;
+}
+
+bool quoted_qualifier(std::string_view line, std::string_view prefix,
+                      std::string_view& value) {
+    for (std::size_t at = line.find(prefix); at != npos;
+         at = line.find(prefix, at + 1)) {
+        std::size_t i = at + prefix.size();
+        std::size_t q = line.find('"', i);
+        if (q == npos || q == i) continue;
+        value = line.substr(i, q - i);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief \s*([^;]+) —— 回溯语义：[^;] 也能匹配空白，
+ * 因此空白后紧跟 ';' 或行尾时，捕获退回为最后一个空白字符。
+ */
+static bool field_after_semicolon(std::string_view s, std::size_t a,
+                                  std::size_t& start, std::size_t& end) {
+    std::size_t b = skip_space(s, a);
+    std::size_t c = span_of(s, b, [](char ch) { return ch != ';'; });
+    if (c > b) {
+        start = b;
+        end = c;
+        return true;
+    }
+    if (b > a) {
+        start = b - 1;
+        end = b;
+        return true;
+    }
+    return false;
+}
+
+bool dr_line(std::string_view line, DrFields& out) {
+    if (!starts_with(line, "DR")) return false;
+
+    std::size_t s1 = skip_space(line, 2);
+    if (s1 == 2) return false;
+    std::size_t run_end = span_of(line, s1, [](char c) { return !is_space(c); });
+
+    // (\S+); 贪婪：从最右边的 ';' 开始尝试，直到后面的字段能够匹配
+    for (std::size_t p = run_end; p-- > s1 + 1;) {
+        if (line[p] != ';') continue;
+
+        std::size_t id_start, id_end;
+        if (!field_after_semicolon(line, p + 1, id_start, id_end)) continue;
+
+        out.db_name = line.substr(s1, p - s1);
+        out.db_id = line.substr(id_start, id_end - id_start);
+        out.description = {};
+        out.evidence = {};
+
+        std::size_t pos = id_end;
+        std::size_t d_start, d_end;
+        if (pos < line.size() && line[pos] == ';' &&
+            field_after_semicolon(line, pos + 1, d_start, d_end)) {
+            out.description = line.substr(d_start, d_end - d_start);
+            pos = d_end;
+        }
+
+        if (pos < line.size() && line[pos] == ';') {
+            // ;\s*(.*) —— '.' 不匹配 '\r' / '\n'
+            std::size_t e = skip_space(line, pos + 1);
+            std::size_t e_end = span_of(line, e, [](char c) { return c != '\r' && c != '\n'; });
+            out.evidence = line.substr(e, e_end - e);
+        }
+        return true;
+    }
+    return false;
+}
+
+/// 在 at 处匹配 "SQ\s+SEQUENCE\s+(\d+)\s+AA;\s+(\d+)\s+MW;\s+([A-F0-9]+)\s+CRC64;"
+static bool sq_header_at(std::string_view s, std::size_t at, SqHeader& out) {
+    std::size_t i = at + 2;
+    auto spaces = [&]() {
+        std::size_t j = skip_space(s, i);
+        bool ok = j > i;
+        i = j;
+        return ok;
+    };
+    auto literal = [&](std::string_view lit) {
+        if (s.substr(i, lit.size()) != lit) return false;
+        i += lit.size();
+        return true;
+    };
+    auto group = [&](auto pred, std::string_view& g) {
+        std::size_t j = span_of(s, i, pred);
+        if (j == i) return false;
+        g = s.substr(i, j - i);
+        i = j;
+        return true;
+    };
+
+    SqHeader h;
+    if (!spaces() || !literal("SEQUENCE") || !spaces()) return false;
+    if (!group(is_digit, h.length) || !spaces() || !literal("AA;") || !spaces()) return false;
+    if (!group(is_digit, h.mol_weight) || !spaces() || !literal("MW;") || !spaces()) return false;
+    if (!group(is_hex_upper, h.crc64) || !spaces() || !literal("CRC64;")) return false;
+    out = h;
+    return true;
+}
+
+bool sq_header(std::string_view line, SqHeader& out) {
+    for (std::size_t at = line.find("SQ"); at != npos; at = line.find("SQ", at + 1)) {
+        if (sq_header_at(line, at, out)) return true;
+    }
+    return false;
+}
+
+bool seq_line(std::string_view line, std::string_view& residues) {
+    if (line.size() < 5) return false;
+    for (std::size_t i = 0; i < 5; ++i)
+        if (!is_space(line[i])) return false;
+
+    std::size_t end = span_of(line, 5, [](char c) {
+        return (c >= 'A' && c <= 'Z') || is_space(c);
+    });
+    if (end == 5) return false;
+    residues = line.substr(5, end - 5);
+    return true;
+}
+
+bool taxon_id(std::string_view line, std::string_view& digits) {
+    static const std::string_view key = "NCBI_TaxID=";
+    std::size_t at = line.find(key);
+    if (at == npos) return false;
+    std::size_t i = at + key.size();
+    std::size_t j = span_of(line, i, is_digit);
+    if (j == i) return false;
+    digits = line.substr(i, j - i);
+    return true;
+}
+
+int to_int(std::string_view digits) {
+    int value = 0;
+    auto [ptr, ec] = std::from_chars(digits.data(), digits.data() + digits.size(), value);
+    if (ec == std::errc::result_out_of_range)
+        throw std::out_of_range("stoi");
+    if (ec != std::errc() || ptr == digits.data())
+        throw std::invalid_argument("stoi");
+    return value;
+}
+
+static constexpr std::uint64_t HASH_MUL = 0x9E3779B97F4A7C15ull;
+
+static std::uint64_t hash_mix(std::uint64_t h, std::uint64_t word) {
+    h = (h ^ word) * HASH_MUL;
+    return h ^ (h >> 32);
+}
+
+std::uint64_t hash_bytes(std::uint64_t h, std::string_view bytes) {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(bytes.data());
+    std::size_t n = bytes.size();
+    for (; n >= 8; n -= 8, p += 8) {
+        std::uint64_t word = 0;
+        for (int i = 0; i < 8; ++i) word |= static_cast<std::uint64_t>(p[i]) << (8 * i);
+        h = hash_mix(h, word);
+    }
+    std::uint64_t tail = 0;
+    for (std::size_t i = 0; i < n; ++i) tail |= static_cast<std::uint64_t>(p[i]) << (8 * i);
+    h = hash_mix(h, tail);
+    return hash_mix(h, bytes.size());
+}
+
+std::uint64_t hash_finish(std::uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ull;
+    return h ^ (h >> 33);
+}
+
+} // namespace scan
+} // namespace pmcad
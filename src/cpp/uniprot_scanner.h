@@ -0,0 +1,98 @@
+// src/cpp/uniprot_scanner.h
+#ifndef PMC_UNIPROT_SCANNER_H
+#define PMC_UNIPROT_SCANNER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace pmcad {
+
+/**
+ * @brief UniProt 文本行的手写扫描器（替代 std::regex）。
+ *
+ * 每个函数都对应原先导入器中的一条正则，匹配与捕获结果与
+ * std::regex（ECMAScript，"C" locale）完全一致，包括回溯产生的边界情况。
+ * 所有输出均为输入行的视图，不做任何内存分配。
+ */
+namespace scan {
+
+/// ECMAScript "\s"：' ', '\t', '\n', '\v', '\f', '\r'
+inline bool is_space(char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+inline bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+inline bool starts_with(std::string_view s, std::string_view prefix) {
+    return s.substr(0, prefix.size()) == prefix;
+}
+
+/// AC\s+([A-Z0-9]+);  —— 行内第一个匹配
+bool first_accession(std::string_view line, std::string_view& accession);
+
+/**
+ * @brief ([A-Z0-9]+);  —— 逐个匹配（等价于 sregex_iterator）
+ * @return 本次匹配结束后的位置，作为下次调用的 pos；无匹配时返回 npos
+ */
+std::size_t next_accession(std::string_view line, std::size_t pos,
+                           std::string_view& accession);
+
+struct FtHeader {
+    std::string_view feature_type;
+    std::string_view start_pos;
+    std::string_view end_pos;
+};
+
+/// ^FT\s+(\S+)\s+(\d+)\.\.(\d+)
+bool ft_header(std::string_view line, FtHeader& out);
+
+/**
+ * @brief /key="([^"]+)"  —— prefix 为 `/note="` 或 `/evidence="`
+ */
+bool quoted_qualifier(std::string_view line, std::string_view prefix,
+                      std::string_view& value);
+
+struct DrFields {
+    std::string_view db_name;
+    std::string_view db_id;
+    std::string_view description; ///< 未匹配时为空
+    std::string_view evidence;    ///< 未匹配时为空
+};
+
+/// ^DR\s+(\S+);\s*([^;]+)(?:;\s*([^;]+))?(?:;\s*(.*))?
+bool dr_line(std::string_view line, DrFields& out);
+
+struct SqHeader {
+    std::string_view length;
+    std::string_view mol_weight;
+    std::string_view crc64;
+};
+
+/// SQ\s+SEQUENCE\s+(\d+)\s+AA;\s+(\d+)\s+MW;\s+([A-F0-9]+)\s+CRC64;
+bool sq_header(std::string_view line, SqHeader& out);
+
+/// ^\s{5}([A-Z\s]+)  —— 返回捕获部分（仍包含空格）
+bool seq_line(std::string_view line, std::string_view& residues);
+
+/// OX 行中的 NCBI_TaxID=(\d+)
+bool taxon_id(std::string_view line, std::string_view& digits);
+
+/// 与 std::stoi 相同的整数解析（溢出时抛出 std::out_of_range）
+int to_int(std::string_view digits);
+
+/**
+ * @brief 把 bytes 混入 64 位内容哈希 h（每 8 字节一次乘法）
+ *
+ * 按字节组装，结果与平台字节序无关，可以存入数据库跨版本比较；不是密码学哈希。
+ * 逐段调用时段长也参与混合，"ab" + "c" 与 "a" + "bc" 结果不同。
+ */
+std::uint64_t hash_bytes(std::uint64_t h, std::string_view bytes);
+
+/// 哈希的最终打散（murmur3 fmix64），逐段 hash_bytes 之后调用一次
+std::uint64_t hash_finish(std::uint64_t h);
+
+} // namespace scan
+} // namespace pmcad
+
+#endif // PMC_UNIPROT_SCANNER_H
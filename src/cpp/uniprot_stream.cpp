@@ -0,0 +1,252 @@
+// src/cpp/uniprot_stream.cpp
+#include "uniprot_stream.h"
+#include "uniprot_scanner.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace pmcad {
+
+namespace {
+
+/// close() 之后由 push 抛出，用来从 sink 中止 parse_uniprot_gz
+struct StreamClosed {};
+
+BatchTable make_table(std::vector<std::string> strings, std::vector<std::string> ints) {
+    BatchTable t;
+    t.strings.resize(strings.size());
+    for (auto& c : t.strings) c.offsets.push_back(0);
+    t.ints.resize(ints.size());
+    t.string_names = std::move(strings);
+    t.int_names = std::move(ints);
+    return t;
+}
+
+void append(TsvColumn& col, std::string_view v) {
+    col.data.insert(col.data.end(), v.begin(), v.end());
+    col.offsets.push_back(static_cast<std::int64_t>(col.data.size()));
+}
+
+/// 回退到前 rows 行（丢弃被过滤条目已写入的记录）
+void truncate(BatchTable& t, std::size_t rows) {
+    if (t.entry.size() == rows) return;
+    t.entry.resize(rows);
+    for (auto& c : t.strings) {
+        c.offsets.resize(rows + 1);
+        c.data.resize(static_cast<std::size_t>(c.offsets.back()));
+    }
+    for (auto& c : t.ints) c.resize(rows);
+}
+
+} // namespace
+
+/**
+ * @brief 把解析结果按列追加到当前批次，每满 batch_entries 个条目交给 UniprotStream。
+ *
+ * 条目的 EntryRecord 在该条目的 FT / DR / SQ 之后才到达，
+ * 因此过滤在 end_entry 时进行：不保留的条目把各表回退到条目开始时的行数。
+ */
+class UniprotStream::BatchSink : public RecordSink {
+public:
+    explicit BatchSink(UniprotStream& owner) : owner_(owner) { reset(); }
+
+    void write(const FtRecord& r) override {
+        BatchTable& t = batch_.ft;
+        t.entry.push_back(static_cast<std::int64_t>(entry_));
+        append(t.strings[0], r.accession);
+        append(t.strings[1], r.feature_type);
+        append(t.strings[2], r.note);
+        append(t.strings[3], r.evidence);
+        t.ints[0].push_back(scan::to_int(r.start_pos));
+        t.ints[1].push_back(scan::to_int(r.end_pos));
+    }
+
+    void write(const DrRecord& r) override {
+        BatchTable& t = batch_.dr;
+        t.entry.push_back(static_cast<std::int64_t>(entry_));
+        append(t.strings[0], r.accession);
+        append(t.strings[1], r.db_name);
+        append(t.strings[2], r.db_id);
+        append(t.strings[3], r.description);
+        append(t.strings[4], r.evidence);
+    }
+
+    void write(const SqRecord& r) override {
+        BatchTable& t = batch_.sq;
+        t.entry.push_back(static_cast<std::int64_t>(entry_));
+        append(t.strings[0], r.accession);
+        append(t.strings[1], r.crc64);
+        append(t.strings[2], r.sequence);
+        t.ints[0].push_back(r.length);
+        t.ints[1].push_back(r.mol_weight);
+    }
+
+    void write(const EntryRecord& r) override {
+        keep_ = owner_.taxon_ids_.empty() || owner_.taxon_ids_.count(r.taxon_id);
+        if (!keep_ || !owner_.want_entries_) return;
+
+        BatchTable& t = batch_.entries;
+        t.entry.push_back(static_cast<std::int64_t>(entry_));
+        append(t.strings[0], r.name);
+        append(t.strings[1], r.organism);
+        t.ints[0].push_back(r.taxon_id);
+
+        BatchTable& a = batch_.accessions;
+        std::size_t pos = 0;
+        while (pos < r.accessions.size()) {
+            std::size_t sep = r.accessions.find(';', pos);
+            if (sep == std::string_view::npos) sep = r.accessions.size();
+            a.entry.push_back(static_cast<std::int64_t>(entry_));
+            append(a.strings[0], r.accessions.substr(pos, sep - pos));
+            pos = sep + 1;
+        }
+    }
+
+    void end_entry() override {
+        if (!keep_) {
+            BatchTable* tables[] = {&batch_.entries, &batch_.accessions,
+                                    &batch_.ft, &batch_.dr, &batch_.sq};
+            for (int i = 0; i < 5; ++i) truncate(*tables[i], marks_[i]);
+        }
+        keep_ = true;
+        entry_++;
+        if (++batch_.num_entries >= owner_.batch_entries_) flush();
+        mark();
+    }
+
+    /// 解析结束：文件末尾缺少 "//" 的条目没有 OX，启用过滤时丢弃其记录，否则照常交出
+    void finish() {
+        if (!owner_.taxon_ids_.empty()) {
+            BatchTable* tables[] = {&batch_.ft, &batch_.dr, &batch_.sq};
+            for (int i = 0; i < 3; ++i) truncate(*tables[i], marks_[i + 2]);
+        }
+        flush();
+    }
+
+private:
+    /// 交出当前批次（为空时跳过）
+    void flush() {
+        if (batch_.num_entries == 0 && batch_.ft.num_rows() == 0 &&
+            batch_.dr.num_rows() == 0 && batch_.sq.num_rows() == 0)
+            return;
+        owner_.push(std::move(batch_));
+        reset();
+    }
+
+    void reset() {
+        batch_ = UniprotBatch();
+        batch_.first_entry = entry_;
+        batch_.entries = make_table({"name", "organism"}, {"taxon_id"});
+        batch_.accessions = make_table({"accession"}, {});
+        batch_.ft = make_table({"accession", "feature_type", "note", "evidence"},
+                               {"start_pos", "end_pos"});
+        batch_.dr = make_table({"accession", "db_name", "db_id", "description", "evidence"}, {});
+        batch_.sq = make_table({"accession", "crc64", "sequence"}, {"length", "mol_weight"});
+        mark();
+    }
+
+    void mark() {
+        marks_[0] = batch_.entries.num_rows();
+        marks_[1] = batch_.accessions.num_rows();
+        marks_[2] = batch_.ft.num_rows();
+        marks_[3] = batch_.dr.num_rows();
+        marks_[4] = batch_.sq.num_rows();
+    }
+
+    UniprotStream& owner_;
+    UniprotBatch batch_;
+    std::size_t entry_ = 0;   ///< 当前条目的序号
+    std::size_t marks_[5];    ///< 当前条目开始时各表的行数
+    bool keep_ = true;
+};
+
+UniprotStream::UniprotStream(const std::string& gz_path,
+                             bool entries, bool ft, bool dr, bool sq,
+                             unsigned num_threads, std::size_t batch_entries,
+                             const std::vector<int>& taxon_ids,
+                             std::size_t max_batches)
+    : want_entries_(entries), want_ft_(ft), want_dr_(dr), want_sq_(sq),
+      batch_entries_(std::max<std::size_t>(batch_entries, 1)),
+      taxon_ids_(taxon_ids.begin(), taxon_ids.end()),
+      max_batches_(std::max<std::size_t>(max_batches, 1)) {
+    if (!entries && !ft && !dr && !sq)
+        throw std::invalid_argument("❌ At least one of entries / ft / dr / sq is required");
+    thread_ = std::thread([this, gz_path, num_threads] { run(gz_path, num_threads); });
+}
+
+UniprotStream::~UniprotStream() { close(); }
+
+void UniprotStream::run(const std::string& gz_path, unsigned num_threads) {
+    try {
+        BatchSink sink(*this);
+        // taxon 过滤需要 OX，即使不输出 entries 表也要解析条目概要
+        bool need_entry = want_entries_ || !taxon_ids_.empty();
+        parse_uniprot_gz(gz_path,
+                         want_ft_ ? &sink : nullptr,
+                         want_dr_ ? &sink : nullptr,
+                         want_sq_ ? &sink : nullptr,
+                         num_threads,
+                         [this](const ReadProgress& p) {
+                             std::lock_guard<std::mutex> lk(mu_);
+                             progress_ = p;
+                         },
+                         0,
+                         need_entry ? &sink : nullptr);
+        sink.finish();
+    } catch (const StreamClosed&) {
+    } catch (...) {
+        std::lock_guard<std::mutex> lk(mu_);
+        error_ = std::current_exception();
+    }
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        done_ = true;
+    }
+    ready_cv_.notify_all();
+}
+
+void UniprotStream::push(UniprotBatch&& batch) {
+    std::unique_lock<std::mutex> lk(mu_);
+    space_cv_.wait(lk, [&] { return closed_ || queue_.size() < max_batches_; });
+    if (closed_) throw StreamClosed();
+    queue_.push_back(std::move(batch));
+    lk.unlock();
+    ready_cv_.notify_one();
+}
+
+bool UniprotStream::next(UniprotBatch& out) {
+    std::unique_lock<std::mutex> lk(mu_);
+    ready_cv_.wait(lk, [&] { return closed_ || done_ || !queue_.empty(); });
+    if (!queue_.empty()) {
+        out = std::move(queue_.front());
+        queue_.pop_front();
+        lk.unlock();
+        space_cv_.notify_one();
+        return true;
+    }
+    // 已取出的批次都先交给调用方，最后再报告错误（只报告一次）
+    if (error_) {
+        std::exception_ptr e = error_;
+        error_ = nullptr;
+        std::rethrow_exception(e);
+    }
+    return false;
+}
+
+void UniprotStream::close() {
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        closed_ = true;
+        queue_.clear();
+    }
+    space_cv_.notify_all();
+    ready_cv_.notify_all();
+    if (thread_.joinable()) thread_.join();
+}
+
+ReadProgress UniprotStream::progress() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return progress_;
+}
+
+} // namespace pmcad
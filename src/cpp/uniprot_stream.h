@@ -0,0 +1,122 @@
+// src/cpp/uniprot_stream.h
+#ifndef PMC_UNIPROT_STREAM_H
+#define PMC_UNIPROT_STREAM_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "reader.h"
+#include "uniprot_reader.h"
+
+namespace pmcad {
+
+/**
+ * @brief 一批记录中的一张表，按列存储。
+ *
+ * 字符串列使用 TsvColumn 的 Arrow 布局（值均不为空，validity 留空），整数列为 int32；
+ * entry 为每行所属条目的序号（从文件开头计，含被过滤掉的条目），
+ * 用来把 FT / DR / SQ 的行关联到 entries 表。
+ */
+struct BatchTable {
+    std::vector<std::int64_t> entry;
+    std::vector<std::string> string_names;
+    std::vector<TsvColumn> strings;
+    std::vector<std::string> int_names;
+    std::vector<std::vector<std::int32_t>> ints;
+
+    std::size_t num_rows() const { return entry.size(); }
+};
+
+/// 流式读取的一批结果，包含连续若干个条目的全部记录
+struct UniprotBatch {
+    std::size_t first_entry = 0;  ///< 本批第一个条目的序号
+    std::size_t num_entries = 0;  ///< 本批扫描过的条目数（含被过滤掉的）
+    BatchTable entries;           ///< entry, name, organism, taxon_id
+    BatchTable accessions;        ///< entry, accession（每个条目的每个 accession 一行）
+    BatchTable ft;                ///< entry, 列同 FT 表（start_pos / end_pos 为 int32）
+    BatchTable dr;                ///< entry, 列同 DR 表
+    BatchTable sq;                ///< entry, 列同 SQ 表
+};
+
+/**
+ * @class UniprotStream
+ * @brief 按批次拉取 UniProt .dat.gz 的解析结果，不经过数据库、不一次性物化整个文件。
+ *
+ * 后台线程调用 parse_uniprot_gz（num_threads > 1 时使用多线程流水线），
+ * 每 batch_entries 个条目打包成一个 UniprotBatch 放入有界队列（最多 max_batches 个），
+ * 调用方消费跟不上时解析自动暂停，内存占用与文件大小无关。
+ *
+ * taxon_ids 非空时只保留 OX 行 NCBI_TaxID 在其中的条目，
+ * 其它条目的记录在打包阶段即被丢弃。
+ *
+ * 用法：
+ *   UniprotStream stream(path, true, false, true, false);
+ *   UniprotBatch batch;
+ *   while (stream.next(batch)) { ... }
+ */
+class UniprotStream {
+public:
+    UniprotStream(const std::string& gz_path,
+                  bool entries, bool ft, bool dr, bool sq,
+                  unsigned num_threads = 1,
+                  std::size_t batch_entries = 10000,
+                  const std::vector<int>& taxon_ids = {},
+                  std::size_t max_batches = 4);
+
+    /// 停止后台解析并等待其退出
+    ~UniprotStream();
+
+    UniprotStream(const UniprotStream&) = delete;
+    UniprotStream& operator=(const UniprotStream&) = delete;
+
+    /**
+     * @brief 取出下一批（阻塞直到有数据）
+     * @return 全部读完时返回 false；后台解析抛出的异常在此重新抛出
+     */
+    bool next(UniprotBatch& out);
+
+    /// 提前结束：丢弃未取出的批次，停止后台解析（可重复调用）
+    void close();
+
+    /// 最近一次的读取进度
+    ReadProgress progress() const;
+
+    /// 构造时请求的段落
+    bool want_entries() const { return want_entries_; }
+    bool want_ft() const { return want_ft_; }
+    bool want_dr() const { return want_dr_; }
+    bool want_sq() const { return want_sq_; }
+
+private:
+    class BatchSink;
+
+    void run(const std::string& gz_path, unsigned num_threads);
+    /// 后台线程交出一批；已 close() 时抛出异常中止解析
+    void push(UniprotBatch&& batch);
+
+    bool want_entries_, want_ft_, want_dr_, want_sq_;
+    std::size_t batch_entries_;
+    std::unordered_set<int> taxon_ids_;
+    std::size_t max_batches_;
+
+    mutable std::mutex mu_;
+    std::condition_variable ready_cv_, space_cv_;
+    std::deque<UniprotBatch> queue_;
+    ReadProgress progress_;
+    bool done_ = false;
+    bool closed_ = false;
+    std::exception_ptr error_;
+    std::thread thread_;
+};
+
+} // namespace pmcad
+
+#endif // PMC_UNIPROT_STREAM_H
@@ -1,10 +1,18 @@
 from typing import List, Union, Dict
 import pandas as pd
 from ._core import read_multi_tsv
+from ._core import read_tsv_columns as _read_tsv_columns
+from ._core import read_tsv_matrix_double as _read_tsv_matrix_double
+from ._core import read_tsv_matrix_int as _read_tsv_matrix_int
 from ._core import find_files as _find_files
 from ._core import match_reference as _match_reference
+from ._core import GeneMatchIndex
 from ._core import insert_files_to_pgdb as _insert_files_to_pgdb
 from ._core import UniprotImporter
+from ._core import UniprotStream
+from ._core import UniprotLookup
+from ._core import OntologyGraph
+from ._core import unpack_sequence
 import os
 import subprocess
 import time
@@ -13,10 +21,13 @@ import signal
 import gzip
 
 
-def read_tsv_files(filelist: List[str]) -> pd.DataFrame:
-    """Read multiple TSV files and return a single DataFrame"""
+def read_tsv_files(filelist: List[str], num_threads: int = 0) -> pd.DataFrame:
+    """Read multiple TSV files and return a single DataFrame
+
+    num_threads: 并行读取的线程数（默认 0，使用全部 CPU 核心）
+    """
     # 调用 read_multi_tsv 读取所有文件的数据
-    data = read_multi_tsv(filelist)  # 假设返回的是一个合并后的数据列表
+    data = read_multi_tsv(filelist, num_threads)  # 假设返回的是一个合并后的数据列表
 
     # 如果数据非空，使用第一行作为列名
     if data:
@@ -26,6 +37,94 @@ def read_tsv_files(filelist: List[str]) -> pd.DataFrame:
         return pd.DataFrame()  # 如果没有数据，返回一个空 DataFrame
 
 
+def read_tsv_columnar(filename: str) -> pd.DataFrame:
+    """
+    以 mmap + 按列存储的方式读取单个 TSV，返回 DataFrame。
+
+    C++ 端每列只有 offsets / data / validity 三块连续缓冲区（Arrow 布局），
+    安装了 pyarrow 时直接包装为 Arrow 字符串列（零拷贝，不为每个单元格创建 Python 对象）；
+    否则退回为 object 列。行字段不足时对应单元格为缺失值。
+
+    参数:
+        filename (str): TSV 文件路径（第一行为列名）
+
+    返回:
+        pd.DataFrame
+    """
+    table = _read_tsv_columns(filename)
+    n = table["num_rows"]
+
+    series = {}
+    for i, col in enumerate(table["columns"]):
+        series[i] = _string_series(col, n)
+
+    df = pd.DataFrame(series)
+    df.columns = table["names"]
+    return df
+
+
+def _string_series(col: dict, n: int) -> pd.Series:
+    """
+    把 C++ 端 Arrow 布局的字符串列（offsets / data，可选 validity / null_count）转换为 Series。
+    安装了 pyarrow 时零拷贝包装为 Arrow 字符串列，否则退回为 object 列。
+    """
+    validity = col.get("validity")
+    try:
+        import pyarrow as pa
+
+        use_arrow = hasattr(pd, "ArrowDtype")
+    except ImportError:
+        use_arrow = False
+
+    if use_arrow:
+        arr = pa.LargeStringArray.from_buffers(
+            n,
+            pa.py_buffer(col["offsets"]),
+            pa.py_buffer(col["data"]),
+            pa.py_buffer(validity) if validity is not None else None,
+            null_count=col.get("null_count", 0),
+        )
+        return pd.Series(arr, dtype=pd.ArrowDtype(pa.large_string()))
+
+    raw = col["data"].tobytes()
+    off = col["offsets"].tolist()
+    return pd.Series(
+        [
+            raw[off[r] : off[r + 1]].decode("utf-8")
+            if validity is None or validity[r >> 3] >> (r & 7) & 1
+            else None
+            for r in range(n)
+        ],
+        dtype=object,
+    )
+
+
+def read_tsv_matrix(filename: str, dtype: str = "float", has_header: bool = False):
+    """
+    把纯数值 TSV 读取为稠密 numpy 矩阵（C++ 端 mmap + std::from_chars 单遍解析）。
+
+    与 read_tsv_as_double / read_tsv_as_int 不同，无法解析的单元格不会被静默写成 0，
+    而是在 valid 中标为 False（values 中 float 为 NaN，int 为 0）。
+    列数取最宽的一行，字段不足的行其余单元格同样标为无效。
+
+    参数:
+        filename (str): TSV 文件路径
+        dtype (str): "float"（float64）或 "int"（int32）
+        has_header (bool): 第一行是否为列名
+
+    返回:
+        (values, valid, header): values 与 valid 均为 (rows, cols) 的 numpy 数组（零拷贝），
+        header 为列名列表（has_header=False 时为空）
+    """
+    if dtype == "float":
+        out = _read_tsv_matrix_double(filename, has_header)
+    elif dtype == "int":
+        out = _read_tsv_matrix_int(filename, has_header)
+    else:
+        raise ValueError(f"dtype must be 'float' or 'int', got {dtype!r}")
+    return out["values"], out["valid"], out["header"]
+
+
 def create_dict(
     x: List[str], y: List[str], splitx_by: Union[List[str], str] = []
 ) -> dict:
@@ -80,6 +179,26 @@ def create_dict(
 def match_reference(
     query: List[str], reference: Dict[str, List[str]], verbose: bool = False
 ) -> Dict[str, List[str]]:
+    """
+    一次性匹配：每次调用都会重新构建参考索引。
+    每个查询对应的 value 列表按字典序排列且不含重复。
+    对同一份参考字典分批匹配时，请改用 GeneMatchIndex：
+
+        index = GeneMatchIndex(reference)
+        for batch in batches:
+            result = index.match(batch)
+
+    索引可以保存到文件，之后各个进程直接 mmap 加载（共享 page cache，无需重建）：
+
+        index.save("gene.idx")
+        index = GeneMatchIndex.load("gene.idx")
+
+    在整篇摘要中查找参考字典里的基因名（Aho-Corasick 一遍扫描，结果为原文中的
+    str 下标区间及 value ID）：
+
+        for start, end, ids in index.scan([abstract])[0]:
+            print(abstract[start:end], [index.value(i) for i in ids])
+    """
     return _match_reference(query, reference, verbose)
 
 
@@ -102,7 +221,12 @@ def find_files(foldername: str, pattern: str) -> List[str]:
 
 
 def insert_files_to_pgdb(
-    filelist: List[str], table_name: str, dbpath: str, verbose: bool = False
+    filelist: List[str],
+    table_name: str,
+    dbpath: str,
+    verbose: bool = False,
+    num_threads: int = 1,
+    num_connections: int = 1,
 ):
     """
     将文件列表插入 PostgreSQL 数据库表中，直接通过 dbpath 自动获取连接信息。
@@ -112,6 +236,11 @@ def insert_files_to_pgdb(
         table_name (str): 数据库表名
         dbpath (str): 数据库路径，包含 database.info
         verbose (bool): 是否输出详细信息
+        num_threads (int): 并行读取文件的线程数（默认 1）
+        num_connections (int): 并行 COPY 的连接数（默认 1；全部写完后才提交）。
+            服务器 max_prepared_transactions 不小于 num_connections 时用两阶段提交，整体原子；
+            否则各连接依次提交，中途失败时之前的连接已生效。表由本次调用新建时，
+            并行导入失败会删除该表。
     """
     info_file = os.path.join(dbpath, "database.info")
     if not os.path.exists(info_file):
@@ -135,6 +264,8 @@ def insert_files_to_pgdb(
         host=host,
         port=port,
         verbose=verbose,
+        num_threads=num_threads,
+        num_connections=num_connections,
     )
 
 
@@ -512,12 +643,51 @@ def pg_stop(dbpath):
     subprocess.Popen(cmd, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
     print("🛑 PostgreSQL 关闭命令已执行（后台运行中）")
     
+# import_uniprot_* 共用的参数说明，由 _import_doc 填入各函数 docstring 的占位符
+_IMPORT_DOC_FRAGMENTS = {
+    "import_options": """num_threads (int): 解压/解析线程数（默认 1；BGZF 文件可并行解压）。
+        binary_copy (bool): 是否使用二进制 COPY（默认 False，整数列以 int4 发送）。
+        num_connections (int): 每张表的并行连接 / COPY 流数（默认 1，每个连接分别按 batch_commit 提交）。
+        hash_partition (bool): 多连接时按 accession 哈希分配行（默认 False，按条目轮转）。
+        bulk_load (bool): 批量导入模式（默认 False）：UNLOGGED 表、无 id 主键，导入后 SET LOGGED 并并行建索引。
+        resume (bool): 从上次中断处续传（默认 False）；断点在每次提交时记录于 uniprot_import_checkpoint 表。
+        on_metrics (callable): 指标回调（默认 None），每隔 metrics_interval 秒收到一个 ImportMetrics
+            （解压 / 解析字节数、各表行数与 COPY 发送 / 提交耗时、解析错误数），最后一次 phase 为 "done"。
+        metrics_interval (float): 指标与进度行的刷新间隔（秒，默认 1.0）。""",
+    "dedup_sequences": """dedup_sequences (bool): 序列去重模式（默认 False）。SQ 表只保存 accession / length /
+            mol_weight / crc64 / seq_hash，序列去重后存入 "<SQ 表名>_seq" 表
+            （crc64, length, seq_hash, sequence BYTEA，5-bit 打包，用 unpack_sequence 解码）；
+            seq_hash 为序列的 64 位摘要，序列以 (crc64, length, seq_hash) 标识，
+            CRC64 碰撞的不同序列各存一行，两表按这三列关联；已存在的序列不会重复写入。
+            建议配合 binary_copy=True。""",
+    "normalized_mode": """accession_table (str): 规范化模式的 entry_id ↔ accession 表名（默认空字符串，不启用，见 import_uniprot_all）。
+        entry_id_base (int): 规范化模式下第一个条目的 entry_id（默认 1）。""",
+}
+
+
+def _import_doc(func):
+    if func.__doc__:  # python -OO 下没有 docstring
+        func.__doc__ = func.__doc__.format(**_IMPORT_DOC_FRAGMENTS)
+    return func
+
+
+@_import_doc
 def import_uniprot_ft(
     dbpath: str,
     gz_path: str,
     table_name: str = "uniprot_features",
     batch_commit: int = 200000,
     verbose: bool = True,
+    num_threads: int = 1,
+    binary_copy: bool = False,
+    num_connections: int = 1,
+    hash_partition: bool = False,
+    bulk_load: bool = False,
+    resume: bool = False,
+    on_metrics=None,
+    metrics_interval: float = 1.0,
+    accession_table: str = "",
+    entry_id_base: int = 1,
 ):
     """
     从 UniProt .dat.gz 文件中解析 Feature Table (FT) 区域并导入 PostgreSQL。
@@ -529,6 +699,8 @@ def import_uniprot_ft(
         table_name (str): 导入的目标表名，默认为 "uniprot_features"。
         batch_commit (int): 每次提交事务的记录数（默认 200,000）。
         verbose (bool): 是否显示进度条（默认 True）。
+        {import_options}
+        {normalized_mode}
 
     返回:
         None
@@ -559,17 +731,38 @@ def import_uniprot_ft(
         port=port,
         batch_commit=batch_commit,
         verbose=verbose,
+        num_threads=num_threads,
+        binary_copy=binary_copy,
+        num_connections=num_connections,
+        hash_partition=hash_partition,
+        bulk_load=bulk_load,
+        resume=resume,
+        on_metrics=on_metrics,
+        metrics_interval=metrics_interval,
+        accession_table=accession_table,
+        entry_id_base=entry_id_base,
     )
 
     print(f"\n✅ Import finished in {time.time() - start:.2f} seconds.")
     
             
+@_import_doc
 def import_uniprot_dr(
     dbpath: str,
     gz_path: str,
     table_name: str = "uniprot_features",
     batch_commit: int = 200000,
     verbose: bool = True,
+    num_threads: int = 1,
+    binary_copy: bool = False,
+    num_connections: int = 1,
+    hash_partition: bool = False,
+    bulk_load: bool = False,
+    resume: bool = False,
+    on_metrics=None,
+    metrics_interval: float = 1.0,
+    accession_table: str = "",
+    entry_id_base: int = 1,
 ):
     """
     从 UniProt .dat.gz 文件中解析 Feature Table (FT) 区域并导入 PostgreSQL。
@@ -581,6 +774,8 @@ def import_uniprot_dr(
         table_name (str): 导入的目标表名，默认为 "uniprot_features"。
         batch_commit (int): 每次提交事务的记录数（默认 200,000）。
         verbose (bool): 是否显示进度条（默认 True）。
+        {import_options}
+        {normalized_mode}
 
     返回:
         None
@@ -611,16 +806,38 @@ def import_uniprot_dr(
         port=port,
         batch_commit=batch_commit,
         verbose=verbose,
+        num_threads=num_threads,
+        binary_copy=binary_copy,
+        num_connections=num_connections,
+        hash_partition=hash_partition,
+        bulk_load=bulk_load,
+        resume=resume,
+        on_metrics=on_metrics,
+        metrics_interval=metrics_interval,
+        accession_table=accession_table,
+        entry_id_base=entry_id_base,
     )
 
     print(f"\n✅ Import finished in {time.time() - start:.2f} seconds.")
     
+@_import_doc
 def import_uniprot_sq(
     dbpath: str,
     gz_path: str,
     table_name: str = "uniprot_sequences",
     batch_commit: int = 20000,
     verbose: bool = True,
+    num_threads: int = 1,
+    binary_copy: bool = False,
+    num_connections: int = 1,
+    hash_partition: bool = False,
+    bulk_load: bool = False,
+    resume: bool = False,
+    on_metrics=None,
+    metrics_interval: float = 1.0,
+    dedup_sequences: bool = False,
+    accession_table: str = "",
+    entry_id_base: int = 1,
 ):
     """
     从 UniProt .dat.gz 文件中解析 Sequence (SQ) 区域并导入 PostgreSQL。
@@ -632,6 +849,9 @@ def import_uniprot_sq(
         table_name (str): 导入的目标表名，默认为 "uniprot_sequences"。
         batch_commit (int): 每次提交事务的记录数（默认 20,000）。
         verbose (bool): 是否显示进度条（默认 True）。
+        {import_options}
+        {dedup_sequences}
+        {normalized_mode}
 
     返回:
         None
@@ -663,6 +883,305 @@ def import_uniprot_sq(
         port=port,
         batch_commit=batch_commit,
         verbose=verbose,
+        num_threads=num_threads,
+        binary_copy=binary_copy,
+        num_connections=num_connections,
+        hash_partition=hash_partition,
+        bulk_load=bulk_load,
+        resume=resume,
+        on_metrics=on_metrics,
+        metrics_interval=metrics_interval,
+        dedup_sequences=dedup_sequences,
+        accession_table=accession_table,
+        entry_id_base=entry_id_base,
+    )
+
+    print(f"\n✅ Import finished in {time.time() - start:.2f} seconds.")
+
+
+@_import_doc
+def import_uniprot_all(
+    dbpath: str,
+    gz_path: str,
+    ft_table: str = "uniprot_features",
+    dr_table: str = "uniprot_dr",
+    sq_table: str = "uniprot_sequences",
+    batch_commit: int = 200000,
+    verbose: bool = True,
+    num_threads: int = 1,
+    binary_copy: bool = False,
+    num_connections: int = 1,
+    hash_partition: bool = False,
+    bulk_load: bool = False,
+    resume: bool = False,
+    on_metrics=None,
+    metrics_interval: float = 1.0,
+    dedup_sequences: bool = False,
+    accession_table: str = "",
+    entry_id_base: int = 1,
+    state_table: str = "",
+):
+    """
+    只解压一遍 UniProt .dat.gz，同时将 FT / DR / SQ 三个区域导入 PostgreSQL。
+    （三张表各用一个连接和 COPY 流，解析规则与 import_uniprot_ft/dr/sq 一致）
+
+    参数:
+        dbpath (str): 包含 database.info 的数据库目录。
+        gz_path (str): UniProt .dat.gz 文件路径。
+        ft_table (str): FT 目标表名，传空字符串跳过。
+        dr_table (str): DR 目标表名，传空字符串跳过。
+        sq_table (str): SQ 目标表名，传空字符串跳过。
+        batch_commit (int): 每张表每次提交事务的记录数（默认 200,000）。
+        verbose (bool): 是否显示进度条（默认 True）。
+        {import_options}
+        {dedup_sequences}
+        accession_table (str): 规范化模式（默认空字符串，不启用）：每个条目分配一个 entry_id，
+            该表（entry_id, accession, position）记录条目的全部 accession（position 0 为主 accession）；
+            FT / DR / SQ 表以 entry_id 代替 accession 列，DR 每条 DR 行只写一行。
+        entry_id_base (int): 第一个条目的 entry_id（默认 1），多个文件导入同一组表时需错开。
+        state_table (str): 增量更新模式（默认空字符串，不启用；须同时指定 accession_table）。
+            该表（accession, entry_id, entry_hash）记录每个条目的主 accession 与整个条目文本的哈希；
+            导入新版本时只把新增或变化的条目写入 "<表名>_delta" 暂存表，最后在一个事务中
+            删除变化 / 已消失条目的旧行并合并暂存表。未变化的条目保留原有行与 entry_id。
+            第一次使用时等同于完整导入；不能与 bulk_load / resume 同时使用。
+            去重模式下新序列在解析过程中直接提交到 "<sq_table>_seq"，不在合并事务内；
+            最后一个引用它的条目变化或删除后，序列也不会被清除。
+
+    返回:
+        None
+    """
+    info_file = os.path.join(dbpath, "database.info")
+    if not os.path.exists(info_file):
+        raise FileNotFoundError(f"No database.info found at {info_file}")
+
+    with open(info_file, "r") as f:
+        db_info = json.load(f)
+
+    dbname = db_info["dbname"]
+    user = db_info["user"]
+    password = db_info["password"]
+    host = db_info.get("host", "localhost")
+    port = str(db_info.get("port", 5432))
+
+    print(
+        f"\n🚀 Importing UniProt FT / DR / SQ into PostgreSQL tables "
+        f"'{ft_table}', '{dr_table}', '{sq_table}' ...\n"
+    )
+    start = time.time()
+
+    UniprotImporter.multi_stream_parse_and_copy(
+        gz_path=gz_path,
+        ft_table=ft_table,
+        dr_table=dr_table,
+        sq_table=sq_table,
+        dbname=dbname,
+        user=user,
+        password=password,
+        host=host,
+        port=port,
+        batch_commit=batch_commit,
+        verbose=verbose,
+        num_threads=num_threads,
+        binary_copy=binary_copy,
+        num_connections=num_connections,
+        hash_partition=hash_partition,
+        bulk_load=bulk_load,
+        resume=resume,
+        on_metrics=on_metrics,
+        metrics_interval=metrics_interval,
+        dedup_sequences=dedup_sequences,
+        accession_table=accession_table,
+        entry_id_base=entry_id_base,
+        state_table=state_table,
     )
 
     print(f"\n✅ Import finished in {time.time() - start:.2f} seconds.")
+
+
+
+def open_uniprot_lookup(
+    dbpath: str,
+    table: str = "uniprot_dr",
+    columns: List[str] = ("db_name", "db_id", "description"),
+    key_column: str = "accession",
+    pool_size: int = 4,
+    max_batch: int = 1000,
+    batch_window: float = 0.002,
+    cache_size: int = 100000,
+) -> UniprotLookup:
+    """
+    打开一个按 accession 查询导入表（FT / DR / SQ 等）的 UniprotLookup，供多线程共享。
+
+    C++ 端持有 pool_size 个连接；各线程并发提交的 key 在 batch_window 秒内合并为
+    一次 "= ANY($1)" 预编译查询（每批至多 max_batch 个），结果按 key 放入 LRU 缓存。
+    查询时释放 GIL，并行判断的多个工作线程可以共用同一个对象，而不必各自建立连接。
+
+    参数:
+        dbpath (str): 包含 database.info 的数据库目录。
+        table (str): 查询的表名（默认 "uniprot_dr"）。
+        columns (List[str]): 返回的列（默认 db_name / db_id / description）。
+        key_column (str): 查询键所在的文本列（默认 "accession"）。
+        pool_size (int): 连接数（默认 4）。
+        max_batch (int): 每次查询最多合并的 key 数（默认 1000）。
+        batch_window (float): 攒批等待时间（秒，默认 0.002）。
+        cache_size (int): 缓存的 key 数（默认 100,000；0 表示不缓存）。
+
+    返回:
+        UniprotLookup；lookup(keys) 返回与 keys 一一对应的行列表，每行为 columns 对应的值。
+
+    示例:
+        >>> dr = open_uniprot_lookup(dbpath, "uniprot_sprot_dr", ["db_name", "db_id"])
+        >>> rows = dr.lookup(["P04637"])[0]
+        >>> go_ids = [db_id for db_name, db_id in rows if db_name == "GO"]
+    """
+    info_file = os.path.join(dbpath, "database.info")
+    if not os.path.exists(info_file):
+        raise FileNotFoundError(f"No database.info found at {info_file}")
+
+    with open(info_file, "r") as f:
+        db_info = json.load(f)
+
+    return UniprotLookup(
+        dbname=db_info["dbname"],
+        user=db_info["user"],
+        password=db_info["password"],
+        host=db_info.get("host", "localhost"),
+        port=str(db_info.get("port", 5432)),
+        table=table,
+        key_column=key_column,
+        columns=list(columns),
+        pool_size=pool_size,
+        max_batch=max_batch,
+        batch_window=batch_window,
+        cache_size=cache_size,
+    )
+
+
+def export_uniprot_parquet(
+    gz_path: str,
+    ft_path: str = "uniprot_features.parquet",
+    dr_path: str = "uniprot_dr.parquet",
+    sq_path: str = "uniprot_sequences.parquet",
+    verbose: bool = True,
+    num_threads: int = 1,
+    compression: str = "none",
+    row_group_rows: int = 1 << 20,
+    on_metrics=None,
+    metrics_interval: float = 1.0,
+):
+    """
+    只解压一遍 UniProt .dat.gz，把 FT / DR / SQ 三个区域写成 Parquet 文件（不需要 PostgreSQL）。
+    列与 import_uniprot_all 建的表一致（不含 id），可直接用 pandas / DuckDB / Spark 读取。
+
+    参数:
+        gz_path (str): UniProt .dat.gz 文件路径。
+        ft_path (str): FT 输出文件，传空字符串跳过。
+        dr_path (str): DR 输出文件，传空字符串跳过。
+        sq_path (str): SQ 输出文件，传空字符串跳过。
+        verbose (bool): 是否显示进度条（默认 True）。
+        num_threads (int): 解压/解析线程数（默认 1；BGZF 文件可并行解压）。
+        compression (str): 页压缩方式，"none"（默认）或 "gzip"。
+        row_group_rows (int): 每个行组的最大行数（默认 1,048,576）。
+        on_metrics (callable): 指标回调（默认 None），同 import_uniprot_all；每个行组计为一次 flush。
+        metrics_interval (float): 指标与进度行的刷新间隔（秒，默认 1.0）。
+
+    返回:
+        None
+
+    示例:
+        >>> export_uniprot_parquet("uniprot_sprot.dat.gz", sq_path="", num_threads=8)
+        >>> pd.read_parquet("uniprot_dr.parquet").groupby("db_name").size()
+    """
+    print(f"\n🚀 Exporting UniProt FT / DR / SQ to '{ft_path}', '{dr_path}', '{sq_path}' ...\n")
+    start = time.time()
+
+    UniprotImporter.multi_stream_parse_to_parquet(
+        gz_path=gz_path,
+        ft_path=ft_path,
+        dr_path=dr_path,
+        sq_path=sq_path,
+        verbose=verbose,
+        num_threads=num_threads,
+        compression=compression,
+        row_group_rows=row_group_rows,
+        on_metrics=on_metrics,
+        metrics_interval=metrics_interval,
+    )
+
+    print(f"\n✅ Export finished in {time.time() - start:.2f} seconds.")
+
+
+# 各段落 DataFrame 的列顺序（与数据库表一致，前面加 entry 列）
+_STREAM_COLUMNS = {
+    "entries": ["entry", "name", "organism", "taxon_id"],
+    "accessions": ["entry", "accession"],
+    "ft": ["entry", "accession", "feature_type", "start_pos", "end_pos", "note", "evidence"],
+    "dr": ["entry", "accession", "db_name", "db_id", "description", "evidence"],
+    "sq": ["entry", "accession", "length", "mol_weight", "crc64", "sequence"],
+}
+
+
+def iter_uniprot(
+    gz_path: str,
+    sections=("entries", "ft", "dr", "sq"),
+    num_threads: int = 1,
+    batch_entries: int = 10000,
+    taxon_ids: List[int] = None,
+    max_batches: int = 4,
+):
+    """
+    按批次流式读取 UniProt .dat.gz，不经过 PostgreSQL、也不一次性读入整个文件。
+
+    C++ 后台线程解压并解析（释放 GIL），每 batch_entries 个条目产出一批；
+    Python 端处理跟不上时解析自动暂停，内存占用与文件大小无关。
+    每批为 {段落名: DataFrame}，另含 "first_entry" / "num_entries"。
+    各表的 entry 列为条目序号（从文件开头计），可用来把 FT / DR / SQ 关联到 entries。
+
+    参数:
+        gz_path (str): UniProt .dat.gz 文件路径。
+        sections: 需要的段落，可选 "entries"（同时产出 "accessions"）、"ft"、"dr"、"sq"。
+        num_threads (int): 解压/解析线程数（默认 1；BGZF 文件可并行解压）。
+        batch_entries (int): 每批的条目数（默认 10,000）。
+        taxon_ids (List[int]): 只保留 OX 行 NCBI_TaxID 在其中的条目（默认 None，不过滤）；
+            在 C++ 端过滤，其它条目的记录不会拷贝到 Python。
+        max_batches (int): 预先解析、排队等待的最大批数（默认 4）。
+
+    返回:
+        生成器，每次产出 Dict[str, pd.DataFrame]
+
+    示例:
+        >>> for batch in iter_uniprot("uniprot_trembl.dat.gz", sections=("entries", "dr"),
+        ...                           taxon_ids=[9606], num_threads=8):
+        ...     go = batch["dr"][batch["dr"]["db_name"] == "GO"]
+    """
+    sections = set(sections)
+    unknown = sections - {"entries", "ft", "dr", "sq"}
+    if unknown:
+        raise ValueError(f"Unknown UniProt sections: {sorted(unknown)}")
+
+    stream = UniprotStream(
+        gz_path,
+        entries="entries" in sections,
+        ft="ft" in sections,
+        dr="dr" in sections,
+        sq="sq" in sections,
+        num_threads=num_threads,
+        batch_entries=batch_entries,
+        taxon_ids=list(taxon_ids or []),
+        max_batches=max_batches,
+    )
+    # 生成器提前关闭（break / 异常）时停止后台解析
+    with stream:
+        for raw in stream:
+            batch = {"first_entry": raw["first_entry"], "num_entries": raw["num_entries"]}
+            for name, columns in _STREAM_COLUMNS.items():
+                if name not in raw:
+                    continue
+                table = raw[name]
+                n = table["num_rows"]
+                data = {"entry": table["entry"]}
+                for col, buf in table["strings"].items():
+                    data[col] = _string_series(buf, n)
+                data.update(table["ints"])
+                batch[name] = pd.DataFrame(data, columns=columns)
+            yield batch
@@ -107,6 +107,24 @@ def get_descendant_subgraph(G: nx.DiGraph, go_id: str) -> nx.DiGraph:
     return G.subgraph(descendants).copy()
 
 
+def to_ontology_graph(G: nx.DiGraph, relations=("is_a",)):
+    """
+    把 read_go_plus_to_graph 得到的图转为原生 OntologyGraph，用于批量祖先查询。
+    - 只保留 relation 属于 relations 的边（sub → obj 即 子 → 父）
+    - 返回的 OntologyGraph 中 ancestors 为语义上的上位 term，
+      与 nx.ancestors(G, x)（G 中能到达 x 的节点）方向相反
+    """
+    from .core import OntologyGraph
+
+    wanted = set(relations)
+    children, parents = [], []
+    for u, v, d in G.edges(data=True):
+        if d.get("relation") in wanted:
+            children.append(u)
+            parents.append(v)
+    return OntologyGraph.from_edges(children, parents)
+
+
 def get_local_context_subgraph(G: nx.DiGraph, go_id: str) -> nx.DiGraph:
     """
     输入 GO term，返回包含该节点的所有祖先 + 后代 + 它们的 hasAlternativeId 别名节点 构成的局部子图。
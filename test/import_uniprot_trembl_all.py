@@ -0,0 +1,37 @@
+# %%
+import os
+import ctypes
+import sys
+
+sys.path.append("/data/wyuan/workspace/pmcdata_pro/pmcad")
+
+# 加入环境变量
+os.environ["LD_LIBRARY_PATH"] = "/data/wyuan/pgsql/lib:" + os.environ.get(
+    "LD_LIBRARY_PATH", ""
+)
+
+# 先加载 libpq
+ctypes.CDLL("/data/wyuan/pgsql/lib/libpq.so", mode=ctypes.RTLD_GLOBAL)
+
+# 再加载 libpqxx
+ctypes.CDLL("/data/wyuan/pgsql/lib/libpqxx.so", mode=ctypes.RTLD_GLOBAL)
+
+from src.pmcad.core import pg_exec, import_uniprot_all
+
+dbpath = "/data/wyuan/workspace/pmcdata_pro/database/protease_pgdb"
+
+tables = ["uniprot_trembl_ft", "uniprot_trembl_dr", "uniprot_trembl_sq"]
+for table_name in tables:
+    pg_exec(dbpath=dbpath, sql=f"DROP TABLE IF EXISTS {table_name};")
+
+# 一次解压同时导入 FT / DR / SQ
+UNIPROT_GZ = "/data/wyuan/workspace/pmcdata_pro/data/uniprot/uniprot_trembl.dat.gz"
+
+import_uniprot_all(
+    dbpath,
+    UNIPROT_GZ,
+    ft_table=tables[0],
+    dr_table=tables[1],
+    sq_table=tables[2],
+    batch_commit=1000000,
+)